@@ -0,0 +1,70 @@
+# SPDX-FileCopyrightText: 2025 Andy Curtis <contactandyc@gmail.com>
+# SPDX-FileCopyrightText: 2024–2025 Knode.ai — technical questions: contact Andy (above)
+# SPDX-License-Identifier: Apache-2.0
+
+# Generates a_sentence_chunker_single.h: the public chunker header plus, behind
+# A_SENTENCE_CHUNKER_HEADER_ONLY, the private headers and chunker sources with
+# their private #includes and SPDX lines removed. Invoked with cmake -P.
+#
+#   AMALGAMATE_SRC_DIR  source tree root
+#   AMALGAMATE_OUTPUT   header to write
+
+set(_parts
+  src/a_sentence_chunker_instrument.h
+  src/a_sentence_chunker_internal.h
+  src/a_sentence_chunker_scan.h
+  src/a_sentence_chunker_lang_format.h
+  src/a_sentence_chunker_dfa.h
+  src/a_sentence_chunker.c
+  src/a_sentence_chunker_scan.c
+  src/a_sentence_chunker_lang.c
+  src/a_sentence_chunker_dfa.c)
+
+set(_out [=[
+// SPDX-FileCopyrightText: 2025 Andy Curtis <contactandyc@gmail.com>
+// SPDX-FileCopyrightText: 2024–2025 Knode.ai — technical questions: contact Andy (above)
+// SPDX-License-Identifier: Apache-2.0
+
+// Generated by cmake/a_sentence_chunker_amalgamate.cmake; do not edit.
+
+#ifndef _a_sentence_chunker_single_h
+#define _a_sentence_chunker_single_h
+
+/*
+   Single-header build of the chunker.
+
+   Included as is, this is a_sentence_chunker.h. With
+   A_SENTENCE_CHUNKER_HEADER_ONLY defined before the first chunker header
+   in a translation unit, it also defines the chunker there as static
+   inline, so the compiler can inline the passes into the caller and fold
+   constant min_length/max_length through the rechunk loop:
+
+     #define A_SENTENCE_CHUNKER_HEADER_ONLY
+     #include "a-sentence-chunker-library/a_sentence_chunker_single.h"
+
+   That copy has no counters, stats, trace, USDT probes or SIMD dispatch,
+   and needs only a_memory_library at link time.
+*/
+
+#include "a-sentence-chunker-library/a_sentence_chunker.h"
+
+#ifdef A_SENTENCE_CHUNKER_HEADER_ONLY
+]=])
+
+foreach(_part IN LISTS _parts)
+  file(READ "${AMALGAMATE_SRC_DIR}/${_part}" _text)
+  string(REGEX REPLACE "// SPDX-[^\n]*\n" "" _text "${_text}")
+  string(REGEX REPLACE "\n#include \"a_sentence_chunker_[^\n]*" "" _text "${_text}")
+  string(APPEND _out "\n// ---- ${_part} ----\n${_text}")
+endforeach()
+
+string(APPEND _out "\n#endif // A_SENTENCE_CHUNKER_HEADER_ONLY\n\n#endif\n")
+
+# Only rewrite on change so dependents do not rebuild needlessly
+if(EXISTS "${AMALGAMATE_OUTPUT}")
+  file(READ "${AMALGAMATE_OUTPUT}" _old)
+  if(_old STREQUAL _out)
+    return()
+  endif()
+endif()
+file(WRITE "${AMALGAMATE_OUTPUT}" "${_out}")
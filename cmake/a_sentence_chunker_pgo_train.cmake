@@ -0,0 +1,57 @@
+# SPDX-FileCopyrightText: 2025 Andy Curtis <contactandyc@gmail.com>
+# SPDX-FileCopyrightText: 2024–2025 Knode.ai — technical questions: contact Andy (above)
+# SPDX-License-Identifier: Apache-2.0
+
+# Runs the PGO training workload and stages the profile for the *_pgo
+# variant. Invoked with cmake -P by the a_sentence_chunker_pgo_profile target.
+#
+#   PGO_MODE       gcc | clang
+#   PGO_TRAIN      training executable
+#   PGO_CORPUS     corpus file or directory
+#   PGO_GEN_DIR    object directory of the instrumented library (gcc)
+#   PGO_USE_DIR    object directory of the *_pgo library (gcc)
+#   PGO_RAW_DIR    directory for .profraw files (clang)
+#   PGO_PROFDATA   merged profile (clang)
+#   LLVM_PROFDATA  llvm-profdata executable (clang)
+#   PGO_STAMP      file touched on success
+
+if(PGO_MODE STREQUAL "gcc")
+  # Counters accumulate across runs; start from a clean profile
+  file(GLOB_RECURSE _old "${PGO_GEN_DIR}/*.gcda")
+  if(_old)
+    file(REMOVE ${_old})
+  endif()
+else()
+  file(REMOVE_RECURSE "${PGO_RAW_DIR}")
+  file(MAKE_DIRECTORY "${PGO_RAW_DIR}")
+  set(ENV{LLVM_PROFILE_FILE} "${PGO_RAW_DIR}/train-%p.profraw")
+endif()
+
+execute_process(COMMAND "${PGO_TRAIN}" "${PGO_CORPUS}" RESULT_VARIABLE _rc)
+if(NOT _rc EQUAL 0)
+  message(FATAL_ERROR "PGO training run failed: ${_rc}")
+endif()
+
+if(PGO_MODE STREQUAL "gcc")
+  # GCC looks for <object>.gcda next to each object it compiles, so mirror
+  # the instrumented object tree into the *_pgo object directory
+  file(GLOB_RECURSE _gcda RELATIVE "${PGO_GEN_DIR}" "${PGO_GEN_DIR}/*.gcda")
+  if(NOT _gcda)
+    message(FATAL_ERROR "PGO training produced no .gcda files in ${PGO_GEN_DIR}")
+  endif()
+  foreach(_f IN LISTS _gcda)
+    get_filename_component(_d "${PGO_USE_DIR}/${_f}" DIRECTORY)
+    file(COPY "${PGO_GEN_DIR}/${_f}" DESTINATION "${_d}")
+  endforeach()
+else()
+  file(GLOB _raw "${PGO_RAW_DIR}/*.profraw")
+  execute_process(COMMAND "${LLVM_PROFDATA}" merge -o "${PGO_PROFDATA}" ${_raw}
+                  RESULT_VARIABLE _rc)
+  if(NOT _rc EQUAL 0)
+    message(FATAL_ERROR "llvm-profdata merge failed: ${_rc}")
+  endif()
+endif()
+
+get_filename_component(_stamp_dir "${PGO_STAMP}" DIRECTORY)
+file(MAKE_DIRECTORY "${_stamp_dir}")
+file(TOUCH "${PGO_STAMP}")
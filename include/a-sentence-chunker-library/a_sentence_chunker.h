@@ -6,19 +6,97 @@
 #define _a_sentence_chunker_h
 
 #include "a-memory-library/aml_buffer.h"
+#include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 
+/* Defined by a_sentence_chunker_single.h when A_SENTENCE_CHUNKER_HEADER_ONLY
+   compiles the chunker into the including translation unit. */
+#ifdef A_SENTENCE_CHUNKER_HEADER_ONLY
+#define A_SENTENCE_CHUNKER_API static inline
+#else
+#define A_SENTENCE_CHUNKER_API
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 typedef struct {
     size_t start_offset; // Where the sentence begins in the original text
     size_t length;       // How many characters in this sentence
 } a_sentence_chunk_t;
 
-a_sentence_chunk_t *a_sentence_chunker(
+A_SENTENCE_CHUNKER_API a_sentence_chunk_t *a_sentence_chunker(
 	size_t *num,
     aml_buffer_t *bh,
     const char *text);
 
-a_sentence_chunk_t *a_rechunk_sentences(
+/* Same as a_sentence_chunker, but over text[0..len) which need not be
+   NUL-terminated (e.g. a mapped file or shared-memory segment). */
+A_SENTENCE_CHUNKER_API a_sentence_chunk_t *a_sentence_chunker_len(
+    size_t *num,
+    aml_buffer_t *bh,
+    const char *text,
+    size_t len);
+
+/* Compiled language pack (a_sentence_chunker_lang.h). */
+typedef struct a_sentence_chunker_lang_s a_sentence_chunker_lang_t;
+
+/* How the first pass finds boundaries. Both give identical chunks. */
+typedef enum {
+    A_SENTENCE_CHUNKER_ENGINE_RULES = 0, // scan to punctuation, then apply the rules
+    A_SENTENCE_CHUNKER_ENGINE_DFA        // one table lookup per byte (built-in rules only)
+} a_sentence_chunker_engine_t;
+
+/* What to do with a sentence end inside parentheses, brackets, braces or
+   straight double quotes. A span that closes right after a sentence end
+   ("Stop." She left.) still ends the sentence there unless a lowercase
+   word follows. */
+typedef enum {
+    A_SENTENCE_CHUNKER_NESTING_OFF = 0, // ignore nesting
+    A_SENTENCE_CHUNKER_NESTING_SUPPRESS, // no boundaries inside a span
+    A_SENTENCE_CHUNKER_NESTING_DEFER     // move them to where the outermost span closes
+} a_sentence_chunker_nesting_t;
+
+/* What the text is. Structured formats are chunked in place: offsets
+   always point into the text as given. */
+typedef enum {
+    A_SENTENCE_CHUNKER_FORMAT_TEXT = 0,
+    A_SENTENCE_CHUNKER_FORMAT_MARKDOWN, // headings, list items, table rows and code blocks
+    A_SENTENCE_CHUNKER_FORMAT_HTML,     // raw HTML/XML: chunks cover visible text only
+    // Source code: chunks come from comments (and docstrings) only
+    A_SENTENCE_CHUNKER_FORMAT_C,        // C, C++, Java, JavaScript, C#: // and /* */
+    A_SENTENCE_CHUNKER_FORMAT_PYTHON,   // # comments and docstrings
+    A_SENTENCE_CHUNKER_FORMAT_GO,       // // and /* */, `raw` strings
+    A_SENTENCE_CHUNKER_FORMAT_RUST,     // //, ///, //!, nested /* */, r#"raw"# strings
+    A_SENTENCE_CHUNKER_FORMAT_PDF,      // extracted text: hard-wrapped lines, hyphenated words
+    // Subtitles and transcripts: chunks come from cue text only
+    A_SENTENCE_CHUNKER_FORMAT_SRT,      // SubRip: numbered cues, 00:00:01,000 --> 00:00:04,000
+    A_SENTENCE_CHUNKER_FORMAT_VTT,      // WebVTT: cue settings, NOTE and STYLE blocks, <v Name>
+    A_SENTENCE_CHUNKER_FORMAT_TRANSCRIPT // "Name: text" turns, optionally "[00:01:02]" stamped
+} a_sentence_chunker_format_t;
+
+/* Per-call settings for a_sentence_chunker_opts(). Zero-initialize, then
+   set what you need; all-zero options (or NULL) are the built-in rules. */
+typedef struct {
+    const a_sentence_chunker_lang_t *lang; // rule pack; NULL = built-in English
+    a_sentence_chunker_engine_t engine;    // ignored with a pack, which always uses the rules
+    a_sentence_chunker_nesting_t nesting;  // not OFF: the rule engine, whatever .engine says
+    unsigned nesting_max_depth;            // deeper text is malformed: nesting resets (0 = 8)
+    a_sentence_chunker_format_t format;    // not TEXT: the rule engine, whatever .engine says
+} a_sentence_chunker_options_t;
+
+/* a_sentence_chunker_len with per-call options, e.g. the language pack
+   to apply to this document. */
+A_SENTENCE_CHUNKER_API a_sentence_chunk_t *a_sentence_chunker_opts(
+    size_t *num,
+    aml_buffer_t *bh,
+    const char *text,
+    size_t len,
+    const a_sentence_chunker_options_t *opts);
+
+A_SENTENCE_CHUNKER_API a_sentence_chunk_t *a_rechunk_sentences(
     size_t *num,
     aml_buffer_t *second_buffer,
     const char *text,
@@ -27,4 +105,66 @@ a_sentence_chunk_t *a_rechunk_sentences(
     size_t min_length,
     size_t max_length);
 
+/* a_rechunk_sentences with per-call options. Under
+   A_SENTENCE_CHUNKER_FORMAT_MARKDOWN, short chunks are not merged across a
+   block start (heading, list item, table row, code block, blank line) and
+   code blocks are never split. Under A_SENTENCE_CHUNKER_FORMAT_HTML, short
+   chunks are not merged across a block-level tag and no split lands
+   inside a tag. Under the source-code formats, short chunks are not
+   merged across code or a blank line, and splits leave out the comment
+   markers at the start of a line. Under A_SENTENCE_CHUNKER_FORMAT_PDF, a
+   single newline is no split point and a word hyphenated across lines
+   ("infor-\nmation") is one token. Under the subtitle and transcript
+   formats, short chunks are not merged across a change of speaker, and a
+   split between cues leaves the timing lines out of both pieces. */
+A_SENTENCE_CHUNKER_API a_sentence_chunk_t *a_rechunk_sentences_opts(
+    size_t *num,
+    aml_buffer_t *second_buffer,
+    const char *text,
+    a_sentence_chunk_t *first_pass_chunks,
+    size_t first_pass_count,
+    size_t min_length,
+    size_t max_length,
+    const a_sentence_chunker_options_t *opts);
+
+/* A chunk of a subtitle or transcript with the time range and speaker of
+   the text it covers. */
+typedef struct {
+    size_t start_offset;   // as in a_sentence_chunk_t
+    size_t length;
+    int64_t start_ms;      // start of the cue (or turn) the chunk starts in; -1 if not known
+    int64_t end_ms;        // end of the cue (or turn) the chunk ends in; -1 if not known
+    int speaker;           // 0, 1, ... in order of first appearance; -1 for none
+    size_t speaker_offset; // the speaker's name in the text
+    size_t speaker_length; // 0 for none
+} a_sentence_chunk_timed_t;
+
+/* Attach time ranges and speakers to chunks of text[0..len) produced by
+   a_sentence_chunker_opts() or a_rechunk_sentences_opts() under
+   A_SENTENCE_CHUNKER_FORMAT_SRT, _VTT or _TRANSCRIPT. The cues are read
+   again from the text, alongside the chunks; nothing is copied. Under
+   other formats every time and speaker is -1. Returns NULL with *num_out
+   0 when there are no chunks or memory runs out. */
+A_SENTENCE_CHUNKER_API a_sentence_chunk_timed_t *a_sentence_chunker_timed(
+    size_t *num,
+    aml_buffer_t *bh,
+    const char *text,
+    size_t len,
+    const a_sentence_chunk_t *chunks,
+    size_t num_chunks,
+    const a_sentence_chunker_options_t *opts);
+
+/* Name of the scan kernel in use: "avx512bw", "avx2", "sse2" or "scalar".
+   The `fast` variant picks the widest one the CPU supports on first use;
+   every other variant is always "scalar". */
+A_SENTENCE_CHUNKER_API const char *a_sentence_chunker_kernel(void);
+
+/* Force a kernel by name (benchmarks, tests). Returns false when the
+   name is unknown, the CPU lacks it, or this variant has no dispatch. */
+A_SENTENCE_CHUNKER_API bool a_sentence_chunker_kernel_select(const char *name);
+
+#ifdef __cplusplus
+}
+#endif
+
 #endif
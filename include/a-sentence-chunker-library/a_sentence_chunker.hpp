@@ -0,0 +1,425 @@
+// SPDX-FileCopyrightText: 2025 Andy Curtis <contactandyc@gmail.com>
+// SPDX-FileCopyrightText: 2024–2025 Knode.ai — technical questions: contact Andy (above)
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _a_sentence_chunker_hpp
+#define _a_sentence_chunker_hpp
+
+/*
+   C++20 interface (header only on top of the C library).
+
+   - a_sc::basic_context<Policy> is a move-only owner of the two pass
+     buffers. chunk() and rechunk() return a sentence_view over the caller's
+     text: zero-copy std::string_view sentences plus the raw
+     std::span<const a_sentence_chunk_t>. Both stay valid until the next
+     call on the same context.
+   - a_sc::sentences<Policy>(text) is a lazy forward range that finds each
+     boundary only when the iterator advances. It never allocates.
+   - A policy fixes the abbreviation set, the terminators and ASCII vs
+     UTF-8 at compile time. Each configuration therefore gets its own scan
+     loop, and nothing inside the loop tests an option. default_policy
+     gives exactly the C library's first pass, and basic_context<> calls
+     the C library for it.
+*/
+
+#include <array>
+#include <compare>
+#include <cstddef>
+#include <iterator>
+#include <ranges>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+extern "C" {
+#include "a-memory-library/aml_buffer.h"
+#include "a-sentence-chunker-library/a_sentence_chunker.h"
+}
+
+namespace a_sc {
+
+// ----------------------------------------------------------------------------
+//                                  POLICIES
+// ----------------------------------------------------------------------------
+
+/* Bytes that end a sentence; runs of them are treated as one. Only '.'
+   goes through the decimal/abbreviation/ordinal rules. */
+template <char... Cs>
+struct terminators {
+    static constexpr bool contains(char c) noexcept { return ((c == Cs) || ...); }
+};
+using default_terminators = terminators<'.', '?', '!'>;
+
+/* Words that do not end a sentence before '.', compared ASCII
+   case-insensitively. Any type with a constexpr `words` array of
+   std::string_view works. */
+struct english_abbreviations {
+    static constexpr std::array<std::string_view, 16> words = {
+        "Mr", "Mrs", "Ms", "Dr", "St", "etc", "i.e", "e.g", "vs",
+        "Inc", "Corp", "Ltd", "Co", "Jr", "Sr", "Ph.D"
+    };
+};
+struct no_abbreviations {
+    static constexpr std::array<std::string_view, 0> words = {};
+};
+
+/* Encodings. With utf8, a multi-byte letter right after '.' marks an
+   abbreviation the way an ASCII letter does, and the full-width
+   U+3002, U+FF01 and U+FF1F end sentences. */
+struct ascii {
+    static constexpr bool is_utf8 = false;
+};
+struct utf8 {
+    static constexpr bool is_utf8 = true;
+};
+
+template <class Abbreviations = english_abbreviations,
+          class Terminators = default_terminators,
+          class Encoding = ascii>
+struct policy {
+    using abbreviation_set = Abbreviations;
+    using terminator_set = Terminators;
+    using encoding = Encoding;
+};
+using default_policy = policy<>;
+
+namespace detail {
+
+constexpr bool is_whitespace(char c) noexcept {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+constexpr bool is_digit(char c) noexcept { return c >= '0' && c <= '9'; }
+constexpr bool is_lower(char c) noexcept { return c >= 'a' && c <= 'z'; }
+constexpr bool is_upper(char c) noexcept { return c >= 'A' && c <= 'Z'; }
+constexpr char fold(char c) noexcept { return is_upper(c) ? (char)(c + ('a' - 'A')) : c; }
+
+/* Byte length of a full-width terminator starting at i, else 0. */
+constexpr std::size_t wide_terminator(const char *t, std::size_t i, std::size_t len) noexcept {
+    if (i + 2 >= len) return 0;
+    unsigned char a = (unsigned char)t[i], b = (unsigned char)t[i + 1], c = (unsigned char)t[i + 2];
+    if (a == 0xE3 && b == 0x80 && c == 0x82) return 3;                 // U+3002
+    if (a == 0xEF && b == 0xBC && (c == 0x81 || c == 0x9F)) return 3;  // U+FF01, U+FF1F
+    return 0;
+}
+
+/*
+   The first-pass heuristics with the policy folded in. The structure
+   mirrors src/a_sentence_chunker.c; keep the two in step.
+*/
+template <class Policy>
+class scanner {
+    using T = typename Policy::terminator_set;
+    static constexpr bool kUtf8 = Policy::encoding::is_utf8;
+    static constexpr auto &kWords = Policy::abbreviation_set::words;
+
+  public:
+    constexpr scanner() noexcept = default;
+    constexpr explicit scanner(std::string_view text) noexcept : text_(text) {}
+
+    /* Next sentence as {start_offset, length}; false after the last. */
+    constexpr bool next(a_sentence_chunk_t &out) noexcept {
+        const char *t = text_.data();
+        const std::size_t len = text_.size();
+        while (i_ < len) {
+            if (T::contains(t[i_])) {
+                std::size_t last = i_;
+                while (last + 1 < len && T::contains(t[last + 1])) last++;
+                if (is_boundary(t, last, len)) {
+                    return emit(out, closers(t, last, len));
+                }
+                i_ = last + 1;
+                continue;
+            }
+            if constexpr (kUtf8) {
+                if (std::size_t w = wide_terminator(t, i_, len)) {
+                    std::size_t last = i_ + w - 1;
+                    while ((w = wide_terminator(t, last + 1, len)) != 0) last += w;
+                    return emit(out, closers(t, last, len));
+                }
+            }
+            i_++;
+        }
+        if (start_ < len) {
+            out.start_offset = start_;
+            out.length = len - start_;
+            start_ = len;
+            return true;
+        }
+        return false;
+    }
+
+    constexpr std::size_t position() const noexcept { return start_; }
+
+  private:
+    constexpr bool emit(a_sentence_chunk_t &out, std::size_t last) noexcept {
+        const char *t = text_.data();
+        const std::size_t len = text_.size();
+        out.start_offset = start_;
+        out.length = last + 1 - start_;
+        i_ = last + 1;
+        start_ = i_;
+        while (start_ < len && is_whitespace(t[start_])) start_++;
+        return true;
+    }
+
+    static constexpr std::size_t closers(const char *t, std::size_t i, std::size_t len) noexcept {
+        while (i + 1 < len) {
+            char c = t[i + 1];
+            if (c == '"' || c == '\'' || c == ')' || c == ']' || c == '}' || T::contains(c)) {
+                i++;
+            } else {
+                break;
+            }
+        }
+        return i;
+    }
+
+    static constexpr bool is_abbreviation(const char *t, std::size_t i, std::size_t len) noexcept {
+        if (i == 0) return false;
+        std::size_t start = i;
+        while (start > 0 && !is_whitespace(t[start - 1])) start--;
+        std::size_t n = i - start;
+        if (n == 0) return false;
+
+        char next = i + 1 < len ? t[i + 1] : '\0';
+        if (is_lower(next) || is_upper(next)) return true;
+        if constexpr (kUtf8) {
+            unsigned char u = (unsigned char)next;
+            if (u >= 0xC2 && u <= 0xF4) return true;
+        }
+        if (n == 1 && is_upper(t[start])) return true;
+        if (n == 1 && !is_whitespace(next)) return true;
+
+        if constexpr (kWords.size() > 0) {
+            if (n >= 32) return false;
+            // The C library compares NUL-terminated copies
+            std::size_t m = 0;
+            while (m < n && t[start + m] != '\0') m++;
+            for (std::string_view w : kWords) {
+                if (w.size() != m) continue;
+                std::size_t k = 0;
+                while (k < m && fold(t[start + k]) == fold(w[k])) k++;
+                if (k == m) return true;
+            }
+        }
+        return false;
+    }
+
+    static constexpr bool is_boundary(const char *t, std::size_t i, std::size_t len) noexcept {
+        if (t[i] != '.') return true;
+        if (i > 0 && i + 1 < len && is_digit(t[i - 1]) && is_digit(t[i + 1])) return false;
+        if (is_abbreviation(t, i, len)) return false;
+
+        std::size_t word_start = i;
+        while (word_start > 0 && !is_whitespace(t[word_start - 1]) && t[word_start - 1] != '.') {
+            word_start--;
+        }
+        if (word_start < i) {
+            std::size_t k = word_start;
+            while (k < i && is_digit(t[k])) k++;
+            if (k == i) {
+                std::size_t j = i + 1;
+                while (j < len && is_whitespace(t[j])) j++;
+                if (j >= len || is_digit(t[j]) || is_lower(t[j])) return false;
+            }
+        }
+        return true;
+    }
+
+    std::string_view text_;
+    std::size_t start_ = 0;
+    std::size_t i_ = 0;
+};
+
+} // namespace detail
+
+// ----------------------------------------------------------------------------
+//                                 LAZY RANGE
+// ----------------------------------------------------------------------------
+
+template <class Policy = default_policy>
+class basic_sentence_range : public std::ranges::view_interface<basic_sentence_range<Policy>> {
+  public:
+    class iterator {
+      public:
+        using value_type = std::string_view;
+        using difference_type = std::ptrdiff_t;
+        using iterator_concept = std::forward_iterator_tag;
+
+        constexpr iterator() noexcept = default;
+        constexpr explicit iterator(std::string_view text) noexcept
+            : text_(text), scanner_(text) { ++*this; }
+
+        constexpr std::string_view operator*() const noexcept {
+            return text_.substr(chunk_.start_offset, chunk_.length);
+        }
+        /* Offsets of the current sentence in the text. */
+        constexpr const a_sentence_chunk_t &chunk() const noexcept { return chunk_; }
+
+        constexpr iterator &operator++() noexcept {
+            done_ = !scanner_.next(chunk_);
+            return *this;
+        }
+        constexpr iterator operator++(int) noexcept {
+            iterator prev = *this;
+            ++*this;
+            return prev;
+        }
+
+        friend constexpr bool operator==(const iterator &a, const iterator &b) noexcept {
+            return a.done_ == b.done_ && (a.done_ || a.chunk_.start_offset == b.chunk_.start_offset);
+        }
+        friend constexpr bool operator==(const iterator &a, std::default_sentinel_t) noexcept {
+            return a.done_;
+        }
+
+      private:
+        std::string_view text_;
+        detail::scanner<Policy> scanner_;
+        a_sentence_chunk_t chunk_ = { 0, 0 };
+        bool done_ = true;
+    };
+
+    constexpr basic_sentence_range() noexcept = default;
+    constexpr explicit basic_sentence_range(std::string_view text) noexcept : text_(text) {}
+
+    constexpr iterator begin() const noexcept { return iterator(text_); }
+    constexpr std::default_sentinel_t end() const noexcept { return {}; }
+
+  private:
+    std::string_view text_;
+};
+
+/* for (std::string_view s : a_sc::sentences(text)) ... */
+template <class Policy = default_policy>
+constexpr basic_sentence_range<Policy> sentences(std::string_view text) noexcept {
+    return basic_sentence_range<Policy>(text);
+}
+
+// ----------------------------------------------------------------------------
+//                              CONTEXT AND RESULTS
+// ----------------------------------------------------------------------------
+
+/* Sentences of one call: views into the caller's text. */
+class sentence_view : public std::ranges::view_interface<sentence_view> {
+  public:
+    class iterator {
+      public:
+        using value_type = std::string_view;
+        using difference_type = std::ptrdiff_t;
+        using iterator_concept = std::random_access_iterator_tag;
+
+        constexpr iterator() noexcept = default;
+        constexpr iterator(std::string_view text, const a_sentence_chunk_t *p) noexcept
+            : text_(text), p_(p) {}
+
+        constexpr std::string_view operator*() const noexcept {
+            return text_.substr(p_->start_offset, p_->length);
+        }
+        constexpr std::string_view operator[](difference_type n) const noexcept { return *(*this + n); }
+
+        constexpr iterator &operator++() noexcept { ++p_; return *this; }
+        constexpr iterator operator++(int) noexcept { iterator r = *this; ++p_; return r; }
+        constexpr iterator &operator--() noexcept { --p_; return *this; }
+        constexpr iterator operator--(int) noexcept { iterator r = *this; --p_; return r; }
+        constexpr iterator &operator+=(difference_type n) noexcept { p_ += n; return *this; }
+        constexpr iterator &operator-=(difference_type n) noexcept { p_ -= n; return *this; }
+        friend constexpr iterator operator+(iterator it, difference_type n) noexcept { return it += n; }
+        friend constexpr iterator operator+(difference_type n, iterator it) noexcept { return it += n; }
+        friend constexpr iterator operator-(iterator it, difference_type n) noexcept { return it -= n; }
+        friend constexpr difference_type operator-(const iterator &a, const iterator &b) noexcept {
+            return a.p_ - b.p_;
+        }
+        friend constexpr bool operator==(const iterator &a, const iterator &b) noexcept { return a.p_ == b.p_; }
+        friend constexpr auto operator<=>(const iterator &a, const iterator &b) noexcept { return a.p_ <=> b.p_; }
+
+      private:
+        std::string_view text_;
+        const a_sentence_chunk_t *p_ = nullptr;
+    };
+
+    constexpr sentence_view() noexcept = default;
+    constexpr sentence_view(std::string_view text, std::span<const a_sentence_chunk_t> chunks) noexcept
+        : text_(text), chunks_(chunks) {}
+
+    constexpr iterator begin() const noexcept { return iterator(text_, chunks_.data()); }
+    constexpr iterator end() const noexcept { return iterator(text_, chunks_.data() + chunks_.size()); }
+    constexpr std::size_t size() const noexcept { return chunks_.size(); }
+
+    constexpr std::string_view text() const noexcept { return text_; }
+    constexpr std::span<const a_sentence_chunk_t> chunks() const noexcept { return chunks_; }
+
+  private:
+    std::string_view text_;
+    std::span<const a_sentence_chunk_t> chunks_;
+};
+
+/*
+   Owns the first-pass and rechunk buffers; reuse one per thread.
+   A moved-from context may only be destroyed or assigned to.
+*/
+template <class Policy = default_policy>
+class basic_context {
+  public:
+    explicit basic_context(std::size_t initial_size = 1024)
+        : first_(aml_buffer_init(initial_size)), second_(aml_buffer_init(initial_size)) {}
+    ~basic_context() { release(); }
+
+    basic_context(const basic_context &) = delete;
+    basic_context &operator=(const basic_context &) = delete;
+
+    basic_context(basic_context &&other) noexcept
+        : first_(std::exchange(other.first_, nullptr)),
+          second_(std::exchange(other.second_, nullptr)) {}
+    basic_context &operator=(basic_context &&other) noexcept {
+        if (this != &other) {
+            release();
+            first_ = std::exchange(other.first_, nullptr);
+            second_ = std::exchange(other.second_, nullptr);
+        }
+        return *this;
+    }
+
+    /* First pass: one view per sentence. */
+    sentence_view chunk(std::string_view text) {
+        std::size_t n = 0;
+        a_sentence_chunk_t *c;
+        if constexpr (std::is_same_v<Policy, default_policy>) {
+            c = a_sentence_chunker_len(&n, first_, text.data(), text.size());
+        } else {
+            aml_buffer_clear(first_);
+            detail::scanner<Policy> s(text);
+            a_sentence_chunk_t sc;
+            while (s.next(sc)) aml_buffer_append(first_, &sc, sizeof(sc));
+            n = aml_buffer_length(first_) / sizeof(sc);
+            c = n ? (a_sentence_chunk_t *)aml_buffer_data(first_) : nullptr;
+        }
+        return sentence_view(text, std::span<const a_sentence_chunk_t>(c, n));
+    }
+
+    /* Both passes: sentences merged/split into [min_length, max_length]
+       without breaking tokens. Invalidates the previous chunk() result. */
+    sentence_view rechunk(std::string_view text, std::size_t min_length, std::size_t max_length) {
+        sentence_view first = chunk(text);
+        std::size_t n = 0;
+        a_sentence_chunk_t *c = a_rechunk_sentences(
+            &n, second_, text.data(), const_cast<a_sentence_chunk_t *>(first.chunks().data()),
+            first.size(), min_length, max_length);
+        return sentence_view(text, std::span<const a_sentence_chunk_t>(c, n));
+    }
+
+  private:
+    void release() noexcept {
+        if (first_) aml_buffer_destroy(first_);
+        if (second_) aml_buffer_destroy(second_);
+    }
+
+    aml_buffer_t *first_;
+    aml_buffer_t *second_;
+};
+using context = basic_context<>;
+
+} // namespace a_sc
+
+#endif
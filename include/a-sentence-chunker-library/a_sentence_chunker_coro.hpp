@@ -0,0 +1,336 @@
+// SPDX-FileCopyrightText: 2025 Andy Curtis <contactandyc@gmail.com>
+// SPDX-FileCopyrightText: 2024–2025 Knode.ai — technical questions: contact Andy (above)
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _a_sentence_chunker_coro_hpp
+#define _a_sentence_chunker_coro_hpp
+
+/*
+   C++20 coroutines over the stream chunker (a_sentence_chunker_stream.h).
+
+   - a_sc::stream is a move-only owner of a stream chunker. feed() and
+     finish() never block and return the sentences just completed, so the
+     stream drops straight into any coroutine read loop, including
+     asio::awaitable ones.
+   - a_sc::read_sentences(reader) is a generator<std::string_view> over a
+     blocking reader.
+   - a_sc::async_sentences(source) is an async_generator<std::string_view>
+     over an awaitable source. Between reads the producer is suspended,
+     not blocked, and it is resumed on whatever thread completes the read.
+
+   Yielded views point into the stream's window. They stay valid until the
+   generator is resumed. Memory is bounded by max_pending plus one read;
+   every entry point defaults max_pending to default_max_pending. Passing
+   0 never cuts, so input without sentence ends grows memory without bound.
+*/
+
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <span>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+extern "C" {
+#include "a-memory-library/aml_buffer.h"
+#include "a-sentence-chunker-library/a_sentence_chunker_stream.h"
+}
+
+namespace a_sc {
+
+inline constexpr std::size_t default_read_size = 64 * 1024;
+inline constexpr std::size_t default_max_pending = 4 * default_read_size;
+
+// ----------------------------------------------------------------------------
+//                                   STREAM
+// ----------------------------------------------------------------------------
+
+/* Sentences completed by one feed()/finish(); offsets are stream offsets. */
+class stream_batch {
+  public:
+    class iterator {
+      public:
+        using value_type = std::string_view;
+        using difference_type = std::ptrdiff_t;
+        using iterator_concept = std::forward_iterator_tag;
+
+        iterator() noexcept = default;
+        iterator(const stream_batch *b, std::size_t k) noexcept : b_(b), k_(k) {}
+
+        std::string_view operator*() const noexcept { return (*b_)[k_]; }
+        iterator &operator++() noexcept { ++k_; return *this; }
+        iterator operator++(int) noexcept { iterator r = *this; ++k_; return r; }
+        friend bool operator==(const iterator &a, const iterator &b) noexcept { return a.k_ == b.k_; }
+
+      private:
+        const stream_batch *b_ = nullptr;
+        std::size_t k_ = 0;
+    };
+
+    stream_batch() noexcept = default;
+    stream_batch(a_sentence_chunker_stream_t *s, std::span<const a_sentence_chunk_t> chunks) noexcept
+        : s_(s), chunks_(chunks) {}
+
+    std::size_t size() const noexcept { return chunks_.size(); }
+    bool empty() const noexcept { return chunks_.empty(); }
+    std::string_view operator[](std::size_t k) const noexcept {
+        return std::string_view(a_sentence_chunker_stream_text(s_, &chunks_[k]), chunks_[k].length);
+    }
+    std::span<const a_sentence_chunk_t> chunks() const noexcept { return chunks_; }
+
+    iterator begin() const noexcept { return iterator(this, 0); }
+    iterator end() const noexcept { return iterator(this, chunks_.size()); }
+
+  private:
+    a_sentence_chunker_stream_t *s_ = nullptr;
+    std::span<const a_sentence_chunk_t> chunks_;
+};
+
+/* A moved-from stream may only be destroyed or assigned to. */
+class stream {
+  public:
+    explicit stream(std::size_t max_pending = default_max_pending)
+        : s_(a_sentence_chunker_stream_init(max_pending)), bh_(aml_buffer_init(256)) {}
+    ~stream() { release(); }
+
+    stream(const stream &) = delete;
+    stream &operator=(const stream &) = delete;
+    stream(stream &&other) noexcept
+        : s_(std::exchange(other.s_, nullptr)), bh_(std::exchange(other.bh_, nullptr)) {}
+    stream &operator=(stream &&other) noexcept {
+        if (this != &other) {
+            release();
+            s_ = std::exchange(other.s_, nullptr);
+            bh_ = std::exchange(other.bh_, nullptr);
+        }
+        return *this;
+    }
+
+    /* Sentences completed by data; valid until the next feed/finish. */
+    stream_batch feed(std::string_view data) {
+        std::size_t n = 0;
+        a_sentence_chunk_t *c = a_sentence_chunker_stream_feed(&n, bh_, s_, data.data(), data.size());
+        return stream_batch(s_, std::span<const a_sentence_chunk_t>(c, n));
+    }
+    /* End of input: the remaining sentences. */
+    stream_batch finish() {
+        std::size_t n = 0;
+        a_sentence_chunk_t *c = a_sentence_chunker_stream_finish(&n, bh_, s_);
+        return stream_batch(s_, std::span<const a_sentence_chunk_t>(c, n));
+    }
+    void reset() { a_sentence_chunker_stream_reset(s_); }
+    std::size_t buffered() const { return a_sentence_chunker_stream_buffered(s_); }
+
+  private:
+    void release() noexcept {
+        if (s_) a_sentence_chunker_stream_destroy(s_);
+        if (bh_) aml_buffer_destroy(bh_);
+    }
+
+    a_sentence_chunker_stream_t *s_;
+    aml_buffer_t *bh_;
+};
+
+// ----------------------------------------------------------------------------
+//                                 GENERATORS
+// ----------------------------------------------------------------------------
+
+/* Minimal synchronous generator (std::generator arrives in C++23). */
+template <class T>
+class generator {
+  public:
+    struct promise_type {
+        const T *value = nullptr;
+        std::exception_ptr error;
+
+        generator get_return_object() noexcept {
+            return generator(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        std::suspend_always yield_value(const T &v) noexcept {
+            value = std::addressof(v);
+            return {};
+        }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { error = std::current_exception(); }
+    };
+    using handle = std::coroutine_handle<promise_type>;
+
+    class iterator {
+      public:
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+
+        iterator() noexcept = default;
+        explicit iterator(handle h) noexcept : h_(h) {}
+
+        const T &operator*() const noexcept { return *h_.promise().value; }
+        iterator &operator++() {
+            resume(h_);
+            return *this;
+        }
+        void operator++(int) { ++*this; }
+        friend bool operator==(const iterator &it, std::default_sentinel_t) noexcept {
+            return !it.h_ || it.h_.done();
+        }
+
+      private:
+        handle h_;
+    };
+
+    explicit generator(handle h) noexcept : h_(h) {}
+    generator(generator &&other) noexcept : h_(std::exchange(other.h_, nullptr)) {}
+    generator &operator=(generator &&other) noexcept {
+        if (this != &other) {
+            if (h_) h_.destroy();
+            h_ = std::exchange(other.h_, nullptr);
+        }
+        return *this;
+    }
+    ~generator() {
+        if (h_) h_.destroy();
+    }
+
+    /* Single pass: begin() runs the body to the first co_yield. */
+    iterator begin() {
+        resume(h_);
+        return iterator(h_);
+    }
+    std::default_sentinel_t end() const noexcept { return {}; }
+
+  private:
+    static void resume(handle h) {
+        h.resume();
+        if (h.promise().error) std::rethrow_exception(h.promise().error);
+    }
+
+    handle h_;
+};
+
+/*
+   Async generator: `while (auto s = co_await gen.next()) use(*s);`.
+   next() resumes the producer by symmetric transfer. When the producer
+   awaits its source, control returns to whoever resumed the consumer
+   (the event loop). Each co_yield transfers straight back to the
+   consumer. The consumer's coroutine type must accept arbitrary
+   awaitables; asio::awaitable does not, so asio code should drive
+   a_sc::stream from its own read loop instead.
+*/
+template <class T>
+class async_generator {
+  public:
+    struct promise_type;
+    using handle = std::coroutine_handle<promise_type>;
+
+    struct promise_type {
+        const T *value = nullptr;
+        std::exception_ptr error;
+        std::coroutine_handle<> consumer;
+
+        struct to_consumer {
+            bool await_ready() noexcept { return false; }
+            std::coroutine_handle<> await_suspend(handle h) noexcept { return h.promise().consumer; }
+            void await_resume() noexcept {}
+        };
+
+        async_generator get_return_object() noexcept { return async_generator(handle::from_promise(*this)); }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        to_consumer final_suspend() noexcept {
+            value = nullptr;
+            return {};
+        }
+        to_consumer yield_value(const T &v) noexcept {
+            value = std::addressof(v);
+            return {};
+        }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept {
+            value = nullptr;
+            error = std::current_exception();
+        }
+    };
+
+    explicit async_generator(handle h) noexcept : h_(h) {}
+    async_generator(async_generator &&other) noexcept : h_(std::exchange(other.h_, nullptr)) {}
+    async_generator &operator=(async_generator &&other) noexcept {
+        if (this != &other) {
+            if (h_) h_.destroy();
+            h_ = std::exchange(other.h_, nullptr);
+        }
+        return *this;
+    }
+    ~async_generator() {
+        if (h_) h_.destroy();
+    }
+
+    /* Awaitable yielding a pointer to the next value, or nullptr at the
+       end. The value stays valid until next() is awaited again. */
+    auto next() noexcept {
+        struct awaiter {
+            handle h;
+            bool await_ready() noexcept { return !h || h.done(); }
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> consumer) noexcept {
+                h.promise().consumer = consumer;
+                return h;
+            }
+            const T *await_resume() {
+                if (!h || h.done()) {
+                    if (h && h.promise().error) std::rethrow_exception(std::exchange(h.promise().error, nullptr));
+                    return nullptr;
+                }
+                return h.promise().value;
+            }
+        };
+        return awaiter{ h_ };
+    }
+
+  private:
+    handle h_;
+};
+
+/*
+   Sentences from a blocking reader: read(std::span<char>) -> bytes read,
+   0 at end of input.
+*/
+template <class Reader>
+generator<std::string_view> read_sentences(Reader read,
+                                           std::size_t max_pending = default_max_pending,
+                                           std::size_t read_size = default_read_size)
+{
+    stream s(max_pending);
+    std::vector<char> buf(read_size);
+    for (;;) {
+        std::size_t n = read(std::span<char>(buf));
+        if (n == 0) break;
+        for (std::string_view v : s.feed(std::string_view(buf.data(), n))) co_yield v;
+    }
+    for (std::string_view v : s.finish()) co_yield v;
+}
+
+/*
+   Sentences from an async source: co_await source.read(std::span<char>)
+   -> bytes read, 0 at end of input. The source must outlive the
+   generator.
+*/
+template <class Source>
+async_generator<std::string_view> async_sentences(Source &source,
+                                                  std::size_t max_pending = default_max_pending,
+                                                  std::size_t read_size = default_read_size)
+{
+    stream s(max_pending);
+    std::vector<char> buf(read_size);
+    for (;;) {
+        std::size_t n = co_await source.read(std::span<char>(buf));
+        if (n == 0) break;
+        for (std::string_view v : s.feed(std::string_view(buf.data(), n))) co_yield v;
+    }
+    for (std::string_view v : s.finish()) co_yield v;
+}
+
+} // namespace a_sc
+
+#endif
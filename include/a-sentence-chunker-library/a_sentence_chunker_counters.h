@@ -0,0 +1,74 @@
+// SPDX-FileCopyrightText: 2025 Andy Curtis <contactandyc@gmail.com>
+// SPDX-FileCopyrightText: 2024–2025 Knode.ai — technical questions: contact Andy (above)
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _a_sentence_chunker_counters_h
+#define _a_sentence_chunker_counters_h
+
+/*
+   Heuristic decision counters.
+
+   Counting is compiled in only when the library is built with
+   A_SENTENCE_CHUNKER_COUNTERS defined (the *_counters CMake variant, see
+   A_BUILD_ENABLE_COUNTERS). Otherwise the hooks expand to nothing and the
+   functions below report zeros.
+
+   Each thread increments its own block, so counting adds no contention;
+   blocks are summed on demand by a_sentence_chunker_counters_snapshot().
+*/
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define A_SENTENCE_CHUNKER_COUNTERS_MAX_ABBREVS 32
+
+/* Which find_split_point() heuristic produced a split */
+typedef enum {
+    A_SPLIT_DOUBLE_NEWLINE = 0, // heuristic 1
+    A_SPLIT_TRIPLE_SPACE,       // heuristic 1b
+    A_SPLIT_NEWLINE,            // heuristic 2
+    A_SPLIT_PUNCT_UPPER,        // heuristic 3
+    A_SPLIT_WHITESPACE,         // heuristic 4
+    A_SPLIT_FALLBACK,           // no heuristic matched, split near max_length
+    A_SPLIT_NONE,               // no valid split point (chunk kept whole)
+    A_SPLIT_HEURISTIC_COUNT
+} a_split_heuristic_t;
+
+/* All fields are uint64_t so the library can treat the struct as an array. */
+typedef struct {
+    // is_end_of_sentence_heuristic()
+    uint64_t punct_runs;            // punctuation runs examined
+    uint64_t decimal_skips;         // "3.14"
+    uint64_t ordinal_skips;         // "1. next", "2. 3"
+    uint64_t boundaries;            // runs accepted as sentence ends
+
+    // matches_abbreviation()
+    uint64_t abbrev_next_alpha;     // "e.g" style: '.' followed by a letter
+    uint64_t abbrev_single_upper;   // "A."
+    uint64_t abbrev_single_letter;  // "x.," single letter, non-space after
+    uint64_t abbrev_hits[A_SENTENCE_CHUNKER_COUNTERS_MAX_ABBREVS]; // per ABBREVS[] entry
+
+    // find_split_point()
+    uint64_t split_calls;
+    uint64_t split_heuristic[A_SPLIT_HEURISTIC_COUNT];
+
+    // bytes visited by backward walks (abbreviation and ordinal word starts,
+    // token-boundary adjustment, split heuristics)
+    uint64_t backward_walk_bytes;
+} a_sentence_chunker_counters_t;
+
+/* True if the library was compiled with counters. */
+bool a_sentence_chunker_counters_enabled(void);
+
+/* Sum the counters of all threads (live and exited) into out. */
+void a_sentence_chunker_counters_snapshot(a_sentence_chunker_counters_t *out);
+
+/* Start counting from zero again. Safe while other threads chunk: later
+   snapshots report counts since the reset and no update is lost. */
+void a_sentence_chunker_counters_reset(void);
+
+/* The abbreviation counted by abbrev_hits[idx], or NULL past the end. */
+const char *a_sentence_chunker_counters_abbreviation(size_t idx);
+
+#endif
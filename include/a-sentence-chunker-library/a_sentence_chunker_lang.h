@@ -0,0 +1,67 @@
+// SPDX-FileCopyrightText: 2025 Andy Curtis <contactandyc@gmail.com>
+// SPDX-FileCopyrightText: 2024–2025 Knode.ai — technical questions: contact Andy (above)
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _a_sentence_chunker_lang_h
+#define _a_sentence_chunker_lang_h
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "a-sentence-chunker-library/a_sentence_chunker.h"
+
+/*
+   Language packs: abbreviations, terminators, closers and ordinal
+   conventions for one language, compiled ahead of time into a flat binary
+   table (lang/<name>.txt -> <name>.pack, see
+   a_sentence_chunker_lang_compile). A loaded pack is immutable and
+   shareable across threads; pass it per call through
+   a_sentence_chunker_options_t.lang, so switching languages per document
+   costs nothing.
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Map a compiled pack read-only (one mmap, header and bounds checks, no
+   parsing). Returns NULL if the file is missing or not a valid pack for
+   this build. */
+A_SENTENCE_CHUNKER_API a_sentence_chunker_lang_t *a_sentence_chunker_lang_load(const char *path);
+
+/* Use a compiled pack that is already in memory (embedded array, shared
+   memory). The bytes are not copied: they must be 4-byte aligned and
+   outlive the returned handle. Returns NULL if they are not a valid pack. */
+A_SENTENCE_CHUNKER_API a_sentence_chunker_lang_t *a_sentence_chunker_lang_from_memory(
+    const void *data, size_t len);
+
+/* Unmaps (for _load) and frees the handle. NULL is a no-op. */
+A_SENTENCE_CHUNKER_API void a_sentence_chunker_lang_destroy(a_sentence_chunker_lang_t *lang);
+
+/* The pack's name, e.g. "de". */
+A_SENTENCE_CHUNKER_API const char *a_sentence_chunker_lang_name(const a_sentence_chunker_lang_t *lang);
+
+/* Compile pack source text into `out` (cleared first). One directive per
+   line, '#' starts a comment:
+
+     name de
+     terminators .?!
+     closers " ' ) ] } » “        (ASCII or up to 8 multi-byte UTF-8)
+     spaced_closers yes           (closers may follow spaces or NBSP)
+     ordinal_next digit lower upper
+     ordinal_max_digits 3         (0 = any)
+     ordinal_marks º ª
+     abbrev z.B usw* ...          (case-insensitive; '*' = may end a sentence
+                                   when the next word is capitalized)
+     abbrev_exact So Mo ...       (case-sensitive)
+
+   Returns false on a malformed line and sets *error_line (1-based). */
+A_SENTENCE_CHUNKER_API bool a_sentence_chunker_lang_compile(aml_buffer_t *out,
+                                                            const char *source,
+                                                            size_t len,
+                                                            size_t *error_line);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
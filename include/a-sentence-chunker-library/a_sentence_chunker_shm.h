@@ -0,0 +1,108 @@
+// SPDX-FileCopyrightText: 2025 Andy Curtis <contactandyc@gmail.com>
+// SPDX-FileCopyrightText: 2024–2025 Knode.ai — technical questions: contact Andy (above)
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _a_sentence_chunker_shm_h
+#define _a_sentence_chunker_shm_h
+
+/*
+   Zero-copy chunking service over a Unix domain socket (Linux only).
+
+   The client owns a memfd-backed segment laid out as
+
+       [ header page | document bytes | a_sentence_chunk_t response region ]
+
+   and sends the segment's fd once per connection (SCM_RIGHTS). Each request
+   then carries only the document length and the rechunk thresholds. The
+   server maps the same pages, chunks the document in place and writes the
+   resulting spans into the response region, so no document byte crosses
+   the process boundary.
+
+   The server trusts no size the client sends. The segment must be sealed
+   against shrinking (F_SEAL_SHRINK, as a_sentence_chunker_shm_init()
+   does) or it is refused, and segment_size and the header are checked
+   against the segment's real size before anything is read. The header is
+   copied once per request; later rewrites by the client cannot move the
+   text or the response region after the check.
+*/
+
+#include "a-sentence-chunker-library/a_sentence_chunker.h"
+#include <stdint.h>
+
+#define A_SENTENCE_CHUNKER_SHM_MAGIC 0x53434843u /* "CHCS" */
+
+/* Reply status codes */
+#define A_SENTENCE_CHUNKER_SHM_OK        0
+#define A_SENTENCE_CHUNKER_SHM_EINVAL    1 // malformed request or segment
+#define A_SENTENCE_CHUNKER_SHM_ENOSEG    2 // no segment fd received yet
+#define A_SENTENCE_CHUNKER_SHM_ETOOSMALL 3 // response region too small
+
+/* Lives at offset 0 of the shared segment, written by the client. */
+typedef struct {
+    uint32_t magic;
+    uint32_t reserved;
+    uint64_t text_offset;       // byte offset of the document
+    uint64_t text_capacity;     // bytes reserved for the document
+    uint64_t response_offset;   // byte offset of the span array
+    uint64_t response_capacity; // number of a_sentence_chunk_t slots
+} a_sentence_chunker_shm_header_t;
+
+typedef struct {
+    uint64_t segment_size;  // current size of the segment in bytes
+    uint64_t text_length;   // bytes of document at text_offset
+    uint64_t min_length;    // rechunk thresholds (max_length == 0 =>
+    uint64_t max_length;    //   first pass only)
+} a_sentence_chunker_shm_request_t;
+
+typedef struct {
+    uint32_t status;
+    uint32_t reserved;
+    uint64_t num_chunks;    // spans written (or required, on ETOOSMALL)
+} a_sentence_chunker_shm_reply_t;
+
+// ----------------------------------------------------------------------------
+//                                 CLIENT
+// ----------------------------------------------------------------------------
+
+typedef struct a_sentence_chunker_shm_s a_sentence_chunker_shm_t;
+
+/* Create a memfd segment with room for text_capacity document bytes and
+   chunk_capacity spans. Returns NULL on failure. */
+a_sentence_chunker_shm_t *a_sentence_chunker_shm_init(size_t text_capacity,
+                                                      size_t chunk_capacity);
+void a_sentence_chunker_shm_destroy(a_sentence_chunker_shm_t *h);
+
+/* Writable document area inside the segment (text_capacity bytes). */
+char *a_sentence_chunker_shm_text(a_sentence_chunker_shm_t *h);
+size_t a_sentence_chunker_shm_text_capacity(a_sentence_chunker_shm_t *h);
+
+/* Connect to a server listening on the given socket path (-1 on error). */
+int a_sentence_chunker_shm_connect(const char *path);
+
+/* Chunk the first text_length bytes of the document area on the server
+   connected through sock. The returned spans live in the shared segment
+   and stay valid until the next request or destroy. When the response
+   region is too small it is grown and the request retried. Returns NULL
+   with *num == 0 on failure or when the document is empty. */
+a_sentence_chunk_t *a_sentence_chunker_shm_request(
+    size_t *num,
+    a_sentence_chunker_shm_t *h,
+    int sock,
+    size_t text_length,
+    size_t min_length,
+    size_t max_length);
+
+// ----------------------------------------------------------------------------
+//                                 SERVER
+// ----------------------------------------------------------------------------
+
+/* Bind and listen on a Unix socket path (unlinking a stale one first).
+   Returns the listening fd or -1 on error. */
+int a_sentence_chunker_shm_listen(const char *path);
+
+/* Serve requests on an accepted connection until the peer hangs up.
+   Returns 0 on orderly shutdown, -1 on a transport error. The caller owns
+   conn_fd and decides how connections map to threads. */
+int a_sentence_chunker_shm_serve(int conn_fd);
+
+#endif
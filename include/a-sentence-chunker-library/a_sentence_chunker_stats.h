@@ -0,0 +1,79 @@
+// SPDX-FileCopyrightText: 2025 Andy Curtis <contactandyc@gmail.com>
+// SPDX-FileCopyrightText: 2024–2025 Knode.ai — technical questions: contact Andy (above)
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _a_sentence_chunker_stats_h
+#define _a_sentence_chunker_stats_h
+
+/*
+   Per-call latency and size histograms.
+
+   A stats object is attached to the calling thread; while attached, every
+   a_sentence_chunker*() / a_rechunk_sentences() call on that thread records
+   into it. Only the owning thread writes (no locks, no atomic RMW), while
+   any thread may take a snapshot at any time. Use one stats object per
+   worker thread and merge snapshots for a process-wide view.
+
+   Histograms are HDR-style log-linear: values below 16 are exact, larger
+   values land in one of 8 sub-buckets per power of two (~12.5% error).
+*/
+
+#include <stddef.h>
+#include <stdint.h>
+#include "a-memory-library/aml_buffer.h"
+
+#define A_SENTENCE_CHUNKER_HISTOGRAM_BUCKETS 496
+
+typedef enum {
+    A_SENTENCE_CHUNKER_PASS_FIRST = 0,   // a_sentence_chunker*()
+    A_SENTENCE_CHUNKER_PASS_RECHUNK = 1, // a_rechunk_sentences()
+    A_SENTENCE_CHUNKER_PASS_COUNT
+} a_sentence_chunker_pass_t;
+
+typedef struct {
+    uint64_t count;
+    uint64_t sum;
+    uint64_t min;
+    uint64_t max;
+    uint64_t buckets[A_SENTENCE_CHUNKER_HISTOGRAM_BUCKETS];
+} a_sentence_chunker_histogram_t;
+
+typedef struct {
+    a_sentence_chunker_histogram_t latency_ns[A_SENTENCE_CHUNKER_PASS_COUNT];
+    a_sentence_chunker_histogram_t input_bytes[A_SENTENCE_CHUNKER_PASS_COUNT];
+    a_sentence_chunker_histogram_t output_chunks[A_SENTENCE_CHUNKER_PASS_COUNT];
+    a_sentence_chunker_histogram_t chunk_length[A_SENTENCE_CHUNKER_PASS_COUNT];
+    uint64_t split_gave_up; // rechunk kept an over-long chunk whole
+} a_sentence_chunker_stats_snapshot_t;
+
+typedef struct a_sentence_chunker_stats_s a_sentence_chunker_stats_t;
+
+a_sentence_chunker_stats_t *a_sentence_chunker_stats_init(void);
+void a_sentence_chunker_stats_destroy(a_sentence_chunker_stats_t *stats);
+
+/* Attach stats to the calling thread (NULL detaches). Returns the
+   previously attached object. */
+a_sentence_chunker_stats_t *a_sentence_chunker_stats_attach(a_sentence_chunker_stats_t *stats);
+
+/* Copy the current values; safe from any thread. */
+void a_sentence_chunker_stats_snapshot(a_sentence_chunker_stats_snapshot_t *out,
+                                       a_sentence_chunker_stats_t *stats);
+
+/* Zero all values. Only call from the owning thread. */
+void a_sentence_chunker_stats_reset(a_sentence_chunker_stats_t *stats);
+
+/* dst += src */
+void a_sentence_chunker_stats_merge(a_sentence_chunker_stats_snapshot_t *dst,
+                                    const a_sentence_chunker_stats_snapshot_t *src);
+
+/* Value at percentile p (0..100), reported as the bucket's upper bound
+   clamped to the observed max. 0 when the histogram is empty. */
+uint64_t a_sentence_chunker_histogram_percentile(const a_sentence_chunker_histogram_t *h,
+                                                 double p);
+
+/* Append a JSON summary (count/min/max/mean/p50/p90/p99/p999 per
+   histogram) to bh. */
+void a_sentence_chunker_stats_to_json(aml_buffer_t *bh,
+                                      const a_sentence_chunker_stats_snapshot_t *s);
+
+#endif
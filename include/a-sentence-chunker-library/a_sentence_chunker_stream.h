@@ -0,0 +1,69 @@
+// SPDX-FileCopyrightText: 2025 Andy Curtis <contactandyc@gmail.com>
+// SPDX-FileCopyrightText: 2024–2025 Knode.ai — technical questions: contact Andy (above)
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _a_sentence_chunker_stream_h
+#define _a_sentence_chunker_stream_h
+
+/*
+   Incremental first pass over a byte stream (sockets, pipes, chunked
+   uploads).
+
+   Feed bytes as they arrive; each call returns the sentences whose
+   boundaries can no longer change. A boundary is final once a byte that
+   is not whitespace, a closer or punctuation follows it, because every
+   lookahead of the heuristics ends before that byte. The stream keeps
+   only the unfinished sentence plus a short look-behind, so feeding in
+   any split yields the same chunks as a_sentence_chunker_len() over the
+   whole input. The one exception is a whitespace-free token of more than
+   A_SENTENCE_CHUNKER_STREAM_LOOKBEHIND bytes that spans a boundary.
+
+   Offsets are relative to the start of the stream. With max_pending set,
+   a sentence that grows past it is cut at its last whitespace (or where
+   it stands) to keep memory bounded; those cuts differ from the one-shot
+   chunker by design.
+*/
+
+#include "a-sentence-chunker-library/a_sentence_chunker.h"
+
+#define A_SENTENCE_CHUNKER_STREAM_LOOKBEHIND 64
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct a_sentence_chunker_stream_s a_sentence_chunker_stream_t;
+
+/* max_pending: force a cut when the unfinished sentence exceeds this many
+   bytes (0 = never). */
+a_sentence_chunker_stream_t *a_sentence_chunker_stream_init(size_t max_pending);
+void a_sentence_chunker_stream_destroy(a_sentence_chunker_stream_t *s);
+
+/* Start a new stream at offset 0. */
+void a_sentence_chunker_stream_reset(a_sentence_chunker_stream_t *s);
+
+/* Append data[0..len) and return the sentences it completed (NULL and
+   *num = 0 when none). The array lives in bh; chunk bytes are available
+   through a_sentence_chunker_stream_text() until the next feed/finish. */
+a_sentence_chunk_t *a_sentence_chunker_stream_feed(size_t *num, aml_buffer_t *bh,
+                                                   a_sentence_chunker_stream_t *s,
+                                                   const char *data, size_t len);
+
+/* End of input: return the remaining sentences. Further feeds return
+   nothing until reset. */
+a_sentence_chunk_t *a_sentence_chunker_stream_finish(size_t *num, aml_buffer_t *bh,
+                                                     a_sentence_chunker_stream_t *s);
+
+/* Bytes of a chunk returned by the last feed/finish, or NULL when they
+   are no longer buffered. */
+const char *a_sentence_chunker_stream_text(a_sentence_chunker_stream_t *s,
+                                           const a_sentence_chunk_t *chunk);
+
+/* Bytes currently buffered (unfinished sentence plus look-behind). */
+size_t a_sentence_chunker_stream_buffered(a_sentence_chunker_stream_t *s);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
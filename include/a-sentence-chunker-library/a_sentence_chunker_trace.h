@@ -0,0 +1,96 @@
+// SPDX-FileCopyrightText: 2025 Andy Curtis <contactandyc@gmail.com>
+// SPDX-FileCopyrightText: 2024–2025 Knode.ai — technical questions: contact Andy (above)
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _a_sentence_chunker_trace_h
+#define _a_sentence_chunker_trace_h
+
+/*
+   Decision trace ("explain" mode).
+
+   A trace is a preallocated ring of fixed-size binary records attached to
+   the calling thread. While attached, every chunker call on that thread
+   records one DOCUMENT record per call, one PUNCT_RUN record per candidate
+   punctuation run (which rule accepted or rejected it and how far the
+   backward walks went) and one SPLIT record per find_split_point() call
+   (window, winning heuristic and token-boundary adjustment). When full,
+   the oldest records are overwritten. Nothing is allocated while tracing,
+   and a detached thread pays one predictable branch per call.
+
+   A trace has a single writer; read it from the owning thread or after
+   detaching it. Offsets are stored as 32 bits, so they wrap for inputs
+   of 4GB or more.
+*/
+
+#include <stddef.h>
+#include <stdint.h>
+#include "a-memory-library/aml_buffer.h"
+#include "a-sentence-chunker-library/a_sentence_chunker_counters.h"
+
+typedef enum {
+    A_SENTENCE_CHUNKER_TRACE_DOCUMENT = 0, // start of a call
+    A_SENTENCE_CHUNKER_TRACE_PUNCT_RUN,    // first pass: candidate boundary
+    A_SENTENCE_CHUNKER_TRACE_SPLIT         // rechunk: find_split_point()
+} a_sentence_chunker_trace_event_t;
+
+/* Why a punctuation run was accepted or rejected */
+typedef enum {
+    A_SENTENCE_CHUNKER_RULE_BOUNDARY = 0,         // accepted as a sentence end
+    A_SENTENCE_CHUNKER_RULE_DECIMAL,              // "3.14"
+    A_SENTENCE_CHUNKER_RULE_ABBREV_NEXT_ALPHA,    // letter right after '.'
+    A_SENTENCE_CHUNKER_RULE_ABBREV_SINGLE_UPPER,  // "J. Smith"
+    A_SENTENCE_CHUNKER_RULE_ABBREV_SINGLE_LETTER, // "x.y"
+    A_SENTENCE_CHUNKER_RULE_ABBREV_LIST,          // known abbreviation
+    A_SENTENCE_CHUNKER_RULE_ORDINAL,              // "1. next"
+    A_SENTENCE_CHUNKER_RULE_NESTED,               // inside quotes or brackets (options.nesting)
+    A_SENTENCE_CHUNKER_RULE_COUNT
+} a_sentence_chunker_rule_t;
+
+typedef struct {
+    uint32_t pos;    // PUNCT_RUN: first punctuation byte; SPLIT: chunk start
+    uint32_t length; // DOCUMENT: input bytes (span of the first-pass chunks
+                     //   for rechunk); PUNCT_RUN: run length;
+                     // SPLIT: chunk length
+    uint32_t result; // PUNCT_RUN: sentence end incl. closers when accepted,
+                     //   abbreviation index for ABBREV_LIST;
+                     // SPLIT: split offset relative to pos
+    int32_t adjust;  // SPLIT: split minus the heuristic's candidate
+    uint16_t walked; // bytes walked backward (saturates at 65535)
+    uint8_t event;   // a_sentence_chunker_trace_event_t
+    uint8_t rule;    // DOCUMENT: a_sentence_chunker_pass_t;
+                     // PUNCT_RUN: a_sentence_chunker_rule_t;
+                     // SPLIT: a_split_heuristic_t
+} a_sentence_chunker_trace_record_t;
+
+typedef struct a_sentence_chunker_trace_s a_sentence_chunker_trace_t;
+
+/* capacity is rounded up to a power of two (minimum 64 records). */
+a_sentence_chunker_trace_t *a_sentence_chunker_trace_init(size_t capacity);
+void a_sentence_chunker_trace_destroy(a_sentence_chunker_trace_t *trace);
+
+/* Attach trace to the calling thread (NULL detaches). Returns the
+   previously attached trace. */
+a_sentence_chunker_trace_t *a_sentence_chunker_trace_attach(a_sentence_chunker_trace_t *trace);
+
+/* Forget all records. */
+void a_sentence_chunker_trace_reset(a_sentence_chunker_trace_t *trace);
+
+/* Records written since init/reset, including overwritten ones. */
+uint64_t a_sentence_chunker_trace_written(const a_sentence_chunker_trace_t *trace);
+
+/* Copy up to max of the newest retained records, oldest first. Returns
+   the number copied. */
+size_t a_sentence_chunker_trace_read(const a_sentence_chunker_trace_t *trace,
+                                     a_sentence_chunker_trace_record_t *out,
+                                     size_t max);
+
+/* Name of the record's rule/heuristic/pass, e.g. "abbrev_list". */
+const char *a_sentence_chunker_trace_rule_name(const a_sentence_chunker_trace_record_t *r);
+
+/* Append one line per record to bh. When text is the document the
+   records were taken from, a short excerpt is shown for each position. */
+void a_sentence_chunker_trace_to_text(aml_buffer_t *bh, const char *text, size_t len,
+                                      const a_sentence_chunker_trace_record_t *records,
+                                      size_t num_records);
+
+#endif
@@ -0,0 +1,461 @@
+// SPDX-FileCopyrightText: 2025 Andy Curtis <contactandyc@gmail.com>
+// SPDX-FileCopyrightText: 2024–2025 Knode.ai — technical questions: contact Andy (above)
+// SPDX-License-Identifier: Apache-2.0
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#include <structmember.h>
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <unistd.h>
+
+#include "a-sentence-chunker-library/a_sentence_chunker.h"
+
+/*
+   CPython binding. Text comes in through the buffer protocol (bytes,
+   bytearray, memoryview, mmap, numpy uint8 arrays, ...) and is never
+   copied; chunking runs with the GIL released. Results are Spans objects
+   that own the chunker's aml_buffer_t and export it as a read-only int64
+   buffer of shape (n, 2) = (start_offset, length), so
+
+     spans = a_sentence_chunker.chunk(data)
+     offsets = numpy.asarray(spans)        # or memoryview(spans)
+
+   costs no per-sentence Python objects. Offsets are byte offsets into the
+   source buffer.
+*/
+
+_Static_assert(sizeof(a_sentence_chunk_t) == 2 * sizeof(int64_t),
+               "Spans exports a_sentence_chunk_t as int64[2]");
+
+typedef struct {
+    PyObject_HEAD
+    aml_buffer_t *bh;           // owns the chunks
+    const a_sentence_chunk_t *chunks;
+    Py_ssize_t shape[2];
+    Py_ssize_t strides[2];
+    PyObject *source;           // the chunked object, for slicing
+} SpansObject;
+
+static PyTypeObject SpansType;
+
+// ----------------------------------------------------------------------------
+//                                 CHUNKING
+// ----------------------------------------------------------------------------
+
+/* One document: first pass into `scratch`, then (when max_length > 0) the
+   rechunk pass into `out`. Touches no Python state, so it is safe to run
+   without the GIL. */
+static void chunk_into(aml_buffer_t *out, aml_buffer_t *scratch,
+                       const char *text, size_t len,
+                       size_t min_length, size_t max_length)
+{
+    size_t n1 = 0, n2 = 0;
+    if (max_length == 0) {
+        a_sentence_chunker_len(&n1, out, text, len);
+        return;
+    }
+    a_sentence_chunk_t *first = a_sentence_chunker_len(&n1, scratch, text, len);
+    a_rechunk_sentences(&n2, out, text, first, n1, min_length, max_length);
+}
+
+static SpansObject *spans_new(PyObject *source) {
+    SpansObject *self = PyObject_New(SpansObject, &SpansType);
+    if (!self) {
+        return NULL;
+    }
+    self->bh = aml_buffer_init(1024);
+    self->chunks = NULL;
+    self->shape[0] = 0;
+    self->shape[1] = 2;
+    self->strides[0] = sizeof(a_sentence_chunk_t);
+    self->strides[1] = sizeof(int64_t);
+    Py_INCREF(source);
+    self->source = source;
+    return self;
+}
+
+// Publish the chunks now in self->bh
+static void spans_settle(SpansObject *self) {
+    self->chunks = (const a_sentence_chunk_t *)aml_buffer_data(self->bh);
+    self->shape[0] = aml_buffer_length(self->bh) / sizeof(a_sentence_chunk_t);
+}
+
+static int parse_limits(Py_ssize_t min_length, Py_ssize_t max_length) {
+    if (min_length < 0 || max_length < 0) {
+        PyErr_SetString(PyExc_ValueError, "min_length and max_length must be >= 0");
+        return -1;
+    }
+    if (max_length && min_length > max_length) {
+        PyErr_SetString(PyExc_ValueError, "min_length must not exceed max_length");
+        return -1;
+    }
+    return 0;
+}
+
+// ----------------------------------------------------------------------------
+//                                SPANS TYPE
+// ----------------------------------------------------------------------------
+
+static void spans_dealloc(SpansObject *self) {
+    aml_buffer_destroy(self->bh);
+    Py_XDECREF(self->source);
+    PyObject_Free(self);
+}
+
+static int spans_getbuffer(SpansObject *self, Py_buffer *view, int flags) {
+    static int64_t empty[2];
+    if (flags & PyBUF_WRITABLE) {
+        PyErr_SetString(PyExc_BufferError, "Spans is read-only");
+        view->obj = NULL;
+        return -1;
+    }
+    view->buf = self->shape[0] ? (void *)self->chunks : (void *)empty;
+    view->obj = (PyObject *)self;
+    Py_INCREF(self);
+    view->len = self->shape[0] * (Py_ssize_t)sizeof(a_sentence_chunk_t);
+    view->readonly = 1;
+    view->itemsize = sizeof(int64_t);
+    view->format = (flags & PyBUF_FORMAT) ? "q" : NULL;
+    view->ndim = 2;
+    view->shape = (flags & PyBUF_ND) == PyBUF_ND ? self->shape : NULL;
+    view->strides = (flags & PyBUF_STRIDES) == PyBUF_STRIDES ? self->strides : NULL;
+    view->suboffsets = NULL;
+    view->internal = NULL;
+    return 0;
+}
+
+static PyBufferProcs spans_as_buffer = {
+    (getbufferproc)spans_getbuffer,
+    NULL
+};
+
+static Py_ssize_t spans_length(SpansObject *self) {
+    return self->shape[0];
+}
+
+static PyObject *spans_item(SpansObject *self, Py_ssize_t i) {
+    if (i < 0 || i >= self->shape[0]) {
+        PyErr_SetString(PyExc_IndexError, "Spans index out of range");
+        return NULL;
+    }
+    return Py_BuildValue("(nn)", (Py_ssize_t)self->chunks[i].start_offset,
+                         (Py_ssize_t)self->chunks[i].length);
+}
+
+static PySequenceMethods spans_as_sequence = {
+    .sq_length = (lenfunc)spans_length,
+    .sq_item = (ssizeargfunc)spans_item,
+};
+
+PyDoc_STRVAR(spans_text_doc,
+"text(i) -> memoryview\n\n"
+"Zero-copy view of sentence i within the source buffer.");
+
+static PyObject *spans_text(SpansObject *self, PyObject *arg) {
+    Py_ssize_t i = PyNumber_AsSsize_t(arg, PyExc_IndexError);
+    if (i == -1 && PyErr_Occurred()) {
+        return NULL;
+    }
+    if (i < 0) {
+        i += self->shape[0];
+    }
+    if (i < 0 || i >= self->shape[0]) {
+        PyErr_SetString(PyExc_IndexError, "Spans index out of range");
+        return NULL;
+    }
+    PyObject *whole = PyMemoryView_FromObject(self->source);
+    if (!whole) {
+        return NULL;
+    }
+    PyObject *cast = whole;
+    if (PyMemoryView_GET_BUFFER(whole)->ndim != 1 ||
+        PyMemoryView_GET_BUFFER(whole)->itemsize != 1) {
+        cast = PyObject_CallMethod(whole, "cast", "s", "B");
+        Py_DECREF(whole);
+        if (!cast) {
+            return NULL;
+        }
+    }
+    size_t start = self->chunks[i].start_offset;
+    PyObject *lo = PyLong_FromSize_t(start);
+    PyObject *hi = PyLong_FromSize_t(start + self->chunks[i].length);
+    PyObject *slice = lo && hi ? PySlice_New(lo, hi, NULL) : NULL;
+    PyObject *result = slice ? PyObject_GetItem(cast, slice) : NULL;
+    Py_XDECREF(slice);
+    Py_XDECREF(lo);
+    Py_XDECREF(hi);
+    Py_DECREF(cast);
+    return result;
+}
+
+static PyMethodDef spans_methods[] = {
+    { "text", (PyCFunction)spans_text, METH_O, spans_text_doc },
+    { NULL, NULL, 0, NULL }
+};
+
+static PyMemberDef spans_members[] = {
+    { "source", T_OBJECT_EX, offsetof(SpansObject, source), READONLY,
+      "The object that was chunked." },
+    { NULL, 0, 0, 0, NULL }
+};
+
+PyDoc_STRVAR(spans_doc,
+"Sentence spans as a read-only int64 buffer of shape (n, 2), rows\n"
+"(start_offset, length) in bytes. len() and indexing give tuples;\n"
+"numpy.asarray(spans) and memoryview(spans) share the memory.");
+
+static PyTypeObject SpansType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "a_sentence_chunker.Spans",
+    .tp_basicsize = sizeof(SpansObject),
+    .tp_dealloc = (destructor)spans_dealloc,
+    .tp_as_sequence = &spans_as_sequence,
+    .tp_as_buffer = &spans_as_buffer,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_doc = spans_doc,
+    .tp_methods = spans_methods,
+    .tp_members = spans_members,
+};
+
+// ----------------------------------------------------------------------------
+//                              MODULE FUNCTIONS
+// ----------------------------------------------------------------------------
+
+PyDoc_STRVAR(chunk_doc,
+"chunk(data, min_length=0, max_length=0) -> Spans\n\n"
+"Split a bytes-like object into sentences. With max_length > 0 the\n"
+"result is also rechunked into [min_length, max_length] pieces.\n"
+"The GIL is released while the chunker runs.");
+
+static PyObject *py_chunk(PyObject *module, PyObject *args, PyObject *kwargs) {
+    static char *kwlist[] = { "data", "min_length", "max_length", NULL };
+    PyObject *data;
+    Py_ssize_t min_length = 0, max_length = 0;
+    (void)module;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|nn:chunk", kwlist,
+                                     &data, &min_length, &max_length) ||
+        parse_limits(min_length, max_length) < 0) {
+        return NULL;
+    }
+    Py_buffer view;
+    if (PyObject_GetBuffer(data, &view, PyBUF_SIMPLE) < 0) {
+        return NULL;
+    }
+    SpansObject *spans = spans_new(data);
+    if (!spans) {
+        PyBuffer_Release(&view);
+        return NULL;
+    }
+    Py_BEGIN_ALLOW_THREADS
+    aml_buffer_t *scratch = max_length ? aml_buffer_init(1024) : NULL;
+    chunk_into(spans->bh, scratch, view.buf, (size_t)view.len,
+               (size_t)min_length, (size_t)max_length);
+    if (scratch) {
+        aml_buffer_destroy(scratch);
+    }
+    Py_END_ALLOW_THREADS
+    PyBuffer_Release(&view);
+    spans_settle(spans);
+    return (PyObject *)spans;
+}
+
+PyDoc_STRVAR(rechunk_doc,
+"rechunk(data, spans, min_length, max_length) -> Spans\n\n"
+"Second pass over first-pass spans of the same data.");
+
+static PyObject *py_rechunk(PyObject *module, PyObject *args, PyObject *kwargs) {
+    static char *kwlist[] = { "data", "spans", "min_length", "max_length", NULL };
+    PyObject *data;
+    SpansObject *first;
+    Py_ssize_t min_length, max_length;
+    (void)module;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "OO!nn:rechunk", kwlist, &data,
+                                     &SpansType, &first, &min_length, &max_length) ||
+        parse_limits(min_length, max_length) < 0) {
+        return NULL;
+    }
+    Py_buffer view;
+    if (PyObject_GetBuffer(data, &view, PyBUF_SIMPLE) < 0) {
+        return NULL;
+    }
+    Py_ssize_t n = first->shape[0];
+    if (n && first->chunks[n - 1].start_offset + first->chunks[n - 1].length > (size_t)view.len) {
+        PyBuffer_Release(&view);
+        PyErr_SetString(PyExc_ValueError, "spans extend past the end of data");
+        return NULL;
+    }
+    SpansObject *spans = spans_new(data);
+    if (!spans) {
+        PyBuffer_Release(&view);
+        return NULL;
+    }
+    size_t n2 = 0;
+    Py_BEGIN_ALLOW_THREADS
+    a_rechunk_sentences(&n2, spans->bh, view.buf, (a_sentence_chunk_t *)first->chunks,
+                        (size_t)n, (size_t)min_length, (size_t)max_length);
+    Py_END_ALLOW_THREADS
+    PyBuffer_Release(&view);
+    spans_settle(spans);
+    return (PyObject *)spans;
+}
+
+typedef struct {
+    Py_buffer *views;
+    SpansObject **spans;
+    size_t count;
+    size_t min_length;
+    size_t max_length;
+    atomic_size_t next;
+} batch_t;
+
+// Workers pull documents off a shared counter so long ones don't stall a lane
+static void *batch_worker(void *arg) {
+    batch_t *b = (batch_t *)arg;
+    aml_buffer_t *scratch = aml_buffer_init(1024);
+    size_t k;
+    while ((k = atomic_fetch_add(&b->next, 1)) < b->count) {
+        chunk_into(b->spans[k]->bh, scratch, b->views[k].buf, (size_t)b->views[k].len,
+                   b->min_length, b->max_length);
+    }
+    aml_buffer_destroy(scratch);
+    return NULL;
+}
+
+PyDoc_STRVAR(chunk_batch_doc,
+"chunk_batch(docs, min_length=0, max_length=0, threads=0) -> list[Spans]\n\n"
+"chunk() over a sequence of bytes-like objects on native threads\n"
+"(threads=0: one per online CPU). The GIL is released throughout.");
+
+static PyObject *py_chunk_batch(PyObject *module, PyObject *args, PyObject *kwargs) {
+    static char *kwlist[] = { "docs", "min_length", "max_length", "threads", NULL };
+    PyObject *docs;
+    Py_ssize_t min_length = 0, max_length = 0, threads = 0;
+    (void)module;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|nnn:chunk_batch", kwlist,
+                                     &docs, &min_length, &max_length, &threads) ||
+        parse_limits(min_length, max_length) < 0) {
+        return NULL;
+    }
+    PyObject *seq = PySequence_Fast(docs, "docs must be a sequence of bytes-like objects");
+    if (!seq) {
+        return NULL;
+    }
+    Py_ssize_t count = PySequence_Fast_GET_SIZE(seq);
+    batch_t b = { NULL, NULL, 0, (size_t)min_length, (size_t)max_length, 0 };
+    PyObject *result = PyList_New(count);
+    b.views = PyMem_Calloc(count ? count : 1, sizeof(Py_buffer));
+    b.spans = PyMem_Calloc(count ? count : 1, sizeof(SpansObject *));
+    if (!result || !b.views || !b.spans) {
+        if (result) {
+            PyErr_NoMemory();
+        }
+        goto done;
+    }
+    for (; b.count < (size_t)count; b.count++) {
+        PyObject *doc = PySequence_Fast_GET_ITEM(seq, b.count);
+        if (PyObject_GetBuffer(doc, &b.views[b.count], PyBUF_SIMPLE) < 0) {
+            goto done;
+        }
+        b.spans[b.count] = spans_new(doc);
+        if (!b.spans[b.count]) {
+            PyBuffer_Release(&b.views[b.count]);
+            goto done;
+        }
+    }
+
+    if (threads <= 0) {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = online > 0 ? online : 1;
+    }
+    if (threads > count) {
+        threads = count;
+    }
+    Py_BEGIN_ALLOW_THREADS
+    pthread_t *tids = PyMem_RawMalloc((threads ? threads : 1) * sizeof(pthread_t));
+    Py_ssize_t started = 0;
+    for (; tids && started < threads - 1; started++) {
+        if (pthread_create(&tids[started], NULL, batch_worker, &b) != 0) {
+            break;
+        }
+    }
+    batch_worker(&b);   // the calling thread works too
+    for (Py_ssize_t t = 0; t < started; t++) {
+        pthread_join(tids[t], NULL);
+    }
+    PyMem_RawFree(tids);
+    Py_END_ALLOW_THREADS
+
+    for (size_t k = 0; k < b.count; k++) {
+        spans_settle(b.spans[k]);
+        PyList_SET_ITEM(result, k, (PyObject *)b.spans[k]);
+        b.spans[k] = NULL;
+    }
+
+done:
+    for (size_t k = 0; k < b.count; k++) {
+        PyBuffer_Release(&b.views[k]);
+        Py_XDECREF(b.spans ? b.spans[k] : NULL);
+    }
+    PyMem_Free(b.views);
+    PyMem_Free(b.spans);
+    Py_DECREF(seq);
+    if (PyErr_Occurred()) {
+        Py_CLEAR(result);
+    }
+    return result;
+}
+
+PyDoc_STRVAR(kernel_doc,
+"kernel() -> str\n\n"
+"Name of the scan kernel the linked library variant uses.");
+
+static PyObject *py_kernel(PyObject *module, PyObject *unused) {
+    (void)module;
+    (void)unused;
+    return PyUnicode_FromString(a_sentence_chunker_kernel());
+}
+
+static PyMethodDef module_methods[] = {
+    { "chunk", (PyCFunction)(void (*)(void))py_chunk, METH_VARARGS | METH_KEYWORDS, chunk_doc },
+    { "rechunk", (PyCFunction)(void (*)(void))py_rechunk, METH_VARARGS | METH_KEYWORDS, rechunk_doc },
+    { "chunk_batch", (PyCFunction)(void (*)(void))py_chunk_batch, METH_VARARGS | METH_KEYWORDS,
+      chunk_batch_doc },
+    { "kernel", py_kernel, METH_NOARGS, kernel_doc },
+    { NULL, NULL, 0, NULL }
+};
+
+static int module_exec(PyObject *module) {
+    if (PyType_Ready(&SpansType) < 0) {
+        return -1;
+    }
+    Py_INCREF(&SpansType);
+    if (PyModule_AddObject(module, "Spans", (PyObject *)&SpansType) < 0) {
+        Py_DECREF(&SpansType);
+        return -1;
+    }
+    return 0;
+}
+
+static PyModuleDef_Slot module_slots[] = {
+    { Py_mod_exec, module_exec },
+#ifdef Py_MOD_GIL_NOT_USED
+    { Py_mod_gil, Py_MOD_GIL_NOT_USED },
+#endif
+    { 0, NULL }
+};
+
+static struct PyModuleDef module_def = {
+    PyModuleDef_HEAD_INIT,
+    .m_name = "a_sentence_chunker",
+    .m_doc = "Zero-copy sentence chunking over bytes-like objects.",
+    .m_size = 0,
+    .m_methods = module_methods,
+    .m_slots = module_slots,
+};
+
+PyMODINIT_FUNC PyInit_a_sentence_chunker(void) {
+    return PyModuleDef_Init(&module_def);
+}
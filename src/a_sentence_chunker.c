@@ -3,12 +3,20 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include <ctype.h>
+#include <stdatomic.h>
 #include <stddef.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <string.h>
+#include <strings.h>
 
+#include "a-memory-library/aml_alloc.h"
 #include "a-sentence-chunker-library/a_sentence_chunker.h"
+#include "a_sentence_chunker_dfa.h"
+#include "a_sentence_chunker_instrument.h"
+#include "a_sentence_chunker_internal.h"
+#include "a_sentence_chunker_lang_format.h"
+#include "a_sentence_chunker_scan.h"
 
 // ----------------------------------------------------------------------------
 //                          HELPER FUNCTIONS
@@ -18,6 +26,12 @@ static inline bool is_sentence_punct(char c) {
     return (c == '.' || c == '?' || c == '!');
 }
 
+/* Sentence punctuation under a language pack (NULL: the built-in ".?!"). */
+static inline bool is_terminator(const a_sentence_chunker_lang_t *lang, char c) {
+    return lang ? (lang->h->klass[(uint8_t)c] & A_SC_CLASS_TERMINATOR) != 0
+                : is_sentence_punct(c);
+}
+
 /* Some known abbreviations to skip. Expand as desired. */
 static const char * ABBREVS[] = {
     "Mr",       // Mister
@@ -38,11 +52,28 @@ static const char * ABBREVS[] = {
     "Ph.D",     // Doctor of Philosophy
     NULL
 };
+_Static_assert(sizeof(ABBREVS) / sizeof(ABBREVS[0]) - 1 <= A_SENTENCE_CHUNKER_COUNTERS_MAX_ABBREVS,
+               "abbrev_hits has one slot per ABBREVS entry");
+
+#ifndef A_SENTENCE_CHUNKER_HEADER_ONLY
+const char *a_sentence_chunker_counters_abbreviation(size_t idx) {
+    size_t n = sizeof(ABBREVS) / sizeof(ABBREVS[0]) - 1;
+    return (idx < n && idx < A_SENTENCE_CHUNKER_COUNTERS_MAX_ABBREVS) ? ABBREVS[idx] : NULL;
+}
+#endif
 
 static bool is_whitespace(char c) {
     return (c == ' ' || c == '\t' || c == '\n' || c == '\r');
 }
 
+/*
+   char_after: The character following index i, or '\0' past the end of
+   the text. Keeps the heuristics bounded when text is not NUL-terminated.
+*/
+static inline char char_after(const char *text, size_t i, size_t len) {
+    return (i + 1 < len) ? text[i + 1] : '\0';
+}
+
 /*
    skip_spaces: Return the index of the next non-whitespace character,
    or 'len' if none found.
@@ -59,50 +90,87 @@ static inline bool is_alpha(char c) {
     return ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'));
 }
 
+/*
+   next_is_capitalized: True when the first non-whitespace character after
+   index i is an uppercase letter.
+*/
+static inline bool next_is_capitalized(const char *text, size_t i, size_t len) {
+    size_t j = skip_spaces(text, i + 1, len);
+    return j < len && isupper((unsigned char)text[j]);
+}
+
 /*
    Move backward until whitespace or start-of-string or '.' to isolate
-   the preceding word. Then see if it matches known abbreviations.
+   the preceding word. Then see if it matches known abbreviations (ABBREVS,
+   or the pack's table when lang is set). Returns the abbreviation rule
+   that matched (BOUNDARY if none); *walked receives the bytes walked and
+   *abbrev the ABBREVS index on a list hit ((size_t)-1 for pack hits).
 */
-static bool matches_abbreviation(const char *text, size_t i) {
-    if (i == 0) return false; // no room
+static inline a_sentence_chunker_rule_t abbreviation_rule(const char *text, size_t i, size_t len,
+                                                          const a_sentence_chunker_lang_t *lang,
+                                                          size_t *walked, size_t *abbrev)
+{
+    if (i == 0) return A_SENTENCE_CHUNKER_RULE_BOUNDARY; // no room
     // i points at '.'
-    int start = (int)i - 1;
-    while (start >= 0 && !is_whitespace(text[start])) {
+    size_t start = i;
+    while (start > 0 && !is_whitespace(text[start - 1])) {
         start--;
     }
-    int abbrev_len = (int)i - (start + 1);
-    if (abbrev_len <= 0) return false;
+    size_t abbrev_len = i - start;
+    *walked += abbrev_len;
+    A_SC_COUNT_N(backward_walk_bytes, abbrev_len);
+    if (abbrev_len == 0) return A_SENTENCE_CHUNKER_RULE_BOUNDARY;
+
+    char next = char_after(text, i, len);
 
     // If next character is alpha, treat '.' as an abbreviation boundary
-    if (is_alpha(text[i+1])) {
-        return true;
+    if (is_alpha(next)) {
+        A_SC_COUNT(abbrev_next_alpha);
+        return A_SENTENCE_CHUNKER_RULE_ABBREV_NEXT_ALPHA;
     }
 
     // If exactly one uppercase letter, treat as abbreviation.
-    if (abbrev_len == 1 && isupper((unsigned char)text[start+1])) {
-        return true;
+    if (abbrev_len == 1 && isupper((unsigned char)text[start])) {
+        A_SC_COUNT(abbrev_single_upper);
+        return A_SENTENCE_CHUNKER_RULE_ABBREV_SINGLE_UPPER;
     }
 
     // Single letter abbreviation followed by non-whitespace
-    if (abbrev_len == 1 && !is_whitespace(text[i+1])) {
-        return true;
+    if (abbrev_len == 1 && !is_whitespace(next)) {
+        A_SC_COUNT(abbrev_single_letter);
+        return A_SENTENCE_CHUNKER_RULE_ABBREV_SINGLE_LETTER;
     }
 
     // Copy preceding word to a small buffer
     char buf[32];
-    if (abbrev_len >= (int)sizeof(buf)) {
-        return false; // too large
+    if (abbrev_len >= sizeof(buf)) {
+        return A_SENTENCE_CHUNKER_RULE_BOUNDARY; // too large
+    }
+    if (lang) {
+        const a_sc_lang_slot_t *hit = a_sc_lang_lookup(lang, &text[start], abbrev_len);
+        if (!hit || ((hit->flags & A_SC_ABBREV_MAY_END) && next_is_capitalized(text, i, len))) {
+            return A_SENTENCE_CHUNKER_RULE_BOUNDARY;
+        }
+        *abbrev = (size_t)-1;
+        return A_SENTENCE_CHUNKER_RULE_ABBREV_LIST;
     }
-    memcpy(buf, &text[start+1], abbrev_len);
+    memcpy(buf, &text[start], abbrev_len);
     buf[abbrev_len] = '\0';
 
     // Compare to known abbreviations (case-insensitive)
     for (int idx = 0; ABBREVS[idx] != NULL; idx++) {
         if (strcasecmp(buf, ABBREVS[idx]) == 0) {
-            return true;
+            A_SC_COUNT_AT(abbrev_hits, idx, 1);
+            *abbrev = (size_t)idx;
+            return A_SENTENCE_CHUNKER_RULE_ABBREV_LIST;
         }
     }
-    return false;
+    return A_SENTENCE_CHUNKER_RULE_BOUNDARY;
+}
+
+A_SC_INTERNAL bool matches_abbreviation(const char *text, size_t i, size_t len) {
+    size_t walked = 0, abbrev = 0;
+    return abbreviation_rule(text, i, len, NULL, &walked, &abbrev) != A_SENTENCE_CHUNKER_RULE_BOUNDARY;
 }
 
 /*
@@ -119,24 +187,43 @@ static bool is_just_digits(const char *text, size_t start, size_t i) {
 }
 
 /*
-   is_end_of_sentence_heuristic:
-   Decide if punctuation at index i is an end-of-sentence boundary,
-   or if we should skip it for e.g. decimals, abbreviations, etc.
+   ordinal_follows: Whether c, the first non-whitespace character after
+   "<digits>.", makes it an ordinal ("1. next", "3. Oktober" in German).
+*/
+static inline bool ordinal_follows(const a_sentence_chunker_lang_t *lang, char c) {
+    uint32_t next = lang ? lang->h->ordinal_next : (A_SC_ORDINAL_DIGIT | A_SC_ORDINAL_LOWER);
+    unsigned char u = (unsigned char)c;
+    return ((next & A_SC_ORDINAL_DIGIT) && isdigit(u)) ||
+           ((next & A_SC_ORDINAL_LOWER) && islower(u)) ||
+           ((next & A_SC_ORDINAL_UPPER) && isupper(u));
+}
+
+/*
+   end_of_sentence_rule:
+   Decide if punctuation at index i is an end-of-sentence boundary
+   (A_SENTENCE_CHUNKER_RULE_BOUNDARY), or which rule skips it, e.g.
+   decimals, abbreviations, etc. *walked accumulates the bytes the
+   backward walks visited; *abbrev receives the ABBREVS index on a list hit.
 */
-static bool is_end_of_sentence_heuristic(const char *text, size_t i, size_t len) {
+static inline a_sentence_chunker_rule_t end_of_sentence_rule(const char *text, size_t i, size_t len,
+                                                             const a_sentence_chunker_lang_t *lang,
+                                                             size_t *walked, size_t *abbrev)
+{
     char c = text[i];
 
     // 1) Skip decimals: If '.' is between two digits => "3.14"
-    if (c == '.' && i > 0 && i < len - 1) {
+    if (c == '.' && i > 0 && i + 1 < len) {
         if (isdigit((unsigned char)text[i-1]) && isdigit((unsigned char)text[i+1])) {
-            return false;
+            A_SC_COUNT(decimal_skips);
+            return A_SENTENCE_CHUNKER_RULE_DECIMAL;
         }
     }
 
     // 2) Skip known abbreviations: "Mr.", "Dr."
     if (c == '.') {
-        if (matches_abbreviation(text, i)) {
-            return false;
+        a_sentence_chunker_rule_t rule = abbreviation_rule(text, i, len, lang, walked, abbrev);
+        if (rule != A_SENTENCE_CHUNKER_RULE_BOUNDARY) {
+            return rule;
         }
     }
 
@@ -152,123 +239,1584 @@ static bool is_end_of_sentence_heuristic(const char *text, size_t i, size_t len)
         {
             word_start--;
         }
-        if (is_just_digits(text, word_start, i)) {
+        *walked += i - word_start;
+        A_SC_COUNT_N(backward_walk_bytes, i - word_start);
+        if (is_just_digits(text, word_start, i) &&
+            (!lang || !lang->h->ordinal_max_digits || i - word_start <= lang->h->ordinal_max_digits))
+        {
+            // e.g. Spanish "1.º"
+            if (lang && a_sc_lang_match_seq(lang->h->ordinal_marks, text, i + 1, len)) {
+                A_SC_COUNT(ordinal_skips);
+                return A_SENTENCE_CHUNKER_RULE_ORDINAL;
+            }
             size_t j = skip_spaces(text, i + 1, len);
             if (j >= len) {
                 // end of text => not a real separate sentence
-                return false;
+                A_SC_COUNT(ordinal_skips);
+                return A_SENTENCE_CHUNKER_RULE_ORDINAL;
             }
-            if (isdigit((unsigned char)text[j]) ||
-                islower((unsigned char)text[j]))
-            {
+            if (ordinal_follows(lang, text[j])) {
                 // e.g. "1. 2" or "1. next"
-                return false;
+                A_SC_COUNT(ordinal_skips);
+                return A_SENTENCE_CHUNKER_RULE_ORDINAL;
+            }
+        }
+    }
+
+    // If we get here, treat '.' or '?' or '!' as a real boundary.
+    return A_SENTENCE_CHUNKER_RULE_BOUNDARY;
+}
+
+/*
+   is_end_of_sentence_heuristic:
+   Decide if punctuation at index i is an end-of-sentence boundary,
+   or if we should skip it for e.g. decimals, abbreviations, etc.
+*/
+A_SC_INTERNAL bool is_end_of_sentence_heuristic(const char *text, size_t i, size_t len) {
+    size_t walked = 0, abbrev = 0;
+    return end_of_sentence_rule(text, i, len, NULL, &walked, &abbrev) == A_SENTENCE_CHUNKER_RULE_BOUNDARY;
+}
+
+/*
+   consume_multiple_punctuation:
+   If we encounter consecutive punctuation like "!!" or "...", treat them as one run.
+   Return the index of the last punctuation in that consecutive run.
+*/
+static size_t consume_multiple_punctuation(const char *text,
+                                           size_t start_i,
+                                           size_t len,
+                                           const a_sentence_chunker_lang_t *lang)
+{
+    size_t i = start_i;
+    while ((i + 1) < len && is_terminator(lang, text[i + 1])) {
+        i++;
+    }
+    return i;
+}
+
+/*
+   consume_trailing_closers:
+   Include trailing quotes/brackets after the end punctuation.
+   E.g. "Hello (anyone?)."
+*/
+A_SC_INTERNAL size_t consume_trailing_closers(const char *text, size_t i, size_t len)
+{
+    while ((i + 1) < len) {
+        char next_char = text[i + 1];
+        if (next_char == '\"' || next_char == '\'' ||
+            next_char == ')'  || next_char == ']'  ||
+            next_char == '}'  || is_sentence_punct(next_char))
+        {
+            i++;
+        }
+        else {
+            break;
+        }
+    }
+    return i;
+}
+
+/*
+   Spaces a pack with spaced closers allows before a closer: ' ', NBSP
+   and narrow NBSP (French "« Oui. »"). Returns the index after them.
+*/
+static inline size_t skip_closer_spaces(const char *text, size_t j, size_t len) {
+    for (;;) {
+        if (j < len && text[j] == ' ') {
+            j++;
+        } else if (j + 1 < len && (uint8_t)text[j] == 0xC2 && (uint8_t)text[j + 1] == 0xA0) {
+            j += 2;
+        } else if (j + 2 < len && (uint8_t)text[j] == 0xE2 && (uint8_t)text[j + 1] == 0x80 &&
+                   (uint8_t)text[j + 2] == 0xAF) {
+            j += 3;
+        } else {
+            return j;
+        }
+    }
+}
+
+/*
+   trailing_closers: consume_trailing_closers() under a language pack:
+   its terminator and closer classes, multi-byte closers ("»", "“"), and
+   with spaced closers, spaces before a multi-byte closer.
+*/
+static inline size_t trailing_closers(const char *text, size_t i, size_t len,
+                                      const a_sentence_chunker_lang_t *lang)
+{
+    if (!lang) {
+        return consume_trailing_closers(text, i, len);
+    }
+    const a_sc_lang_header_t *h = lang->h;
+    while ((i + 1) < len) {
+        uint8_t c = (uint8_t)text[i + 1];
+        if (h->klass[c] & (A_SC_CLASS_TERMINATOR | A_SC_CLASS_CLOSER)) {
+            i++;
+            continue;
+        }
+        size_t n = c >= 0x80 ? a_sc_lang_match_seq(h->closers, text, i + 1, len) : 0;
+        if (n) {
+            i += n;
+            continue;
+        }
+        if (h->flags & A_SC_LANG_SPACED_CLOSERS) {
+            size_t j = skip_closer_spaces(text, i + 1, len);
+            n = j > i + 1 ? a_sc_lang_match_seq(h->closers, text, j, len) : 0;
+            if (n) {
+                i = j + n - 1;
+                continue;
+            }
+        }
+        break;
+    }
+    return i;
+}
+
+/* Next terminator at or after i under a pack with non-default terminators. */
+static inline size_t scan_terminator(const a_sentence_chunker_lang_t *lang,
+                                     const char *text, size_t i, size_t len)
+{
+    while (i < len && !(lang->h->klass[(uint8_t)text[i]] & A_SC_CLASS_TERMINATOR)) {
+        i++;
+    }
+    return i;
+}
+
+// ----------------------------------------------------------------------------
+//                     NESTING: QUOTES AND BRACKETS
+// ----------------------------------------------------------------------------
+
+/*
+   nesting_state_t: Where the forward scan is relative to ( [ { and
+   straight double quotes (options.nesting). Constant size: one bracket
+   depth, one quote flag, and the end of the last boundary found inside
+   the open span. Brackets are not matched by kind, so "(a]" closes.
+*/
+typedef struct {
+    a_sentence_chunker_nesting_t mode;
+    unsigned max_depth;
+    unsigned depth;
+    bool quote;
+    bool held;          // a boundary was found inside the open span
+    bool newline;       // only blanks since the last '\n'
+    size_t held_end;    // end of that boundary (after its closers)
+} nesting_state_t;
+
+typedef enum { NEST_NONE, NEST_CLOSED, NEST_RESET } nest_event_t;
+
+static inline unsigned nest_level(const nesting_state_t *n) {
+    return n->depth + (n->quote ? 1 : 0);
+}
+
+/*
+   nest_byte: Feed text[i] to the nesting state. A '"' opens a quote after
+   whitespace or an opener and closes one otherwise. NEST_CLOSED: the byte
+   closed the outermost span. NEST_RESET: a blank line or an opener past
+   max_depth reset the state (malformed or unbalanced text); a held
+   boundary is still in held/held_end for the caller.
+*/
+static inline nest_event_t nest_byte(nesting_state_t *n, const char *text, size_t i) {
+    char c = text[i];
+    switch (c) {
+    case ' ':
+    case '\t':
+    case '\r':
+        return NEST_NONE;
+    case '\n':
+        if (n->newline) {
+            n->depth = 0;
+            n->quote = false;
+            return NEST_RESET;
+        }
+        n->newline = true;
+        return NEST_NONE;
+    case '(':
+    case '[':
+    case '{':
+        n->newline = false;
+        if (nest_level(n) >= n->max_depth) {
+            n->depth = 0;
+            n->quote = false;
+            return NEST_RESET;
+        }
+        n->depth++;
+        return NEST_NONE;
+    case ')':
+    case ']':
+    case '}':
+        n->newline = false;
+        if (!n->depth) return NEST_NONE; // stray closer
+        n->depth--;
+        return nest_level(n) ? NEST_NONE : NEST_CLOSED;
+    case '\"': {
+        n->newline = false;
+        char prev = i ? text[i - 1] : ' ';
+        bool opens = is_whitespace(prev) || prev == '(' || prev == '[' || prev == '{';
+        if (n->quote) {
+            if (opens) return NEST_NONE; // straight quotes do not nest
+            n->quote = false;
+            return nest_level(n) ? NEST_NONE : NEST_CLOSED;
+        }
+        if (!opens) return NEST_NONE;
+        if (nest_level(n) >= n->max_depth) {
+            n->depth = 0;
+            return NEST_RESET;
+        }
+        n->quote = true;
+        return NEST_NONE;
+    }
+    default:
+        n->newline = false;
+        return NEST_NONE;
+    }
+}
+
+/* True when the first non-whitespace byte at or after j is lowercase:
+   the closed span was in the middle of a sentence. */
+static inline bool lower_follows(const char *text, size_t j, size_t len) {
+    j = skip_spaces(text, j, len);
+    return j < len && islower((unsigned char)text[j]);
+}
+
+/*
+   nest_emit: Append [*start_off, end) and start the next sentence after
+   end and its whitespace.
+*/
+static inline void nest_emit(aml_buffer_t *bh, const char *text, size_t len, size_t base,
+                             size_t *start_off, size_t end)
+{
+    if (end > *start_off) {
+        a_sentence_chunk_t sb;
+        sb.start_offset = base + *start_off;
+        sb.length = end - *start_off;
+        aml_buffer_append(bh, &sb, sizeof(sb));
+    }
+    size_t j = end;
+    while (j < len && is_whitespace(text[j])) {
+        j++;
+    }
+    *start_off = j;
+}
+
+/*
+   nest_scan: Feed the bytes from i up to the next terminator to the
+   nesting state and return that terminator's index (len if none). A reset
+   ends the sentence at the held boundary, so an unclosed span runs at
+   most to the next blank line. Under DEFER, closing the outermost span
+   after a held boundary ends the sentence after the closers, unless a
+   lowercase word follows.
+*/
+static inline size_t nest_scan(nesting_state_t *n, aml_buffer_t *bh, const char *text,
+                               size_t i, size_t len, size_t base, size_t *start_off,
+                               const a_sentence_chunker_lang_t *lang)
+{
+    for (; i < len && !is_terminator(lang, text[i]); i++) {
+        nest_event_t ev = nest_byte(n, text, i);
+        if (ev == NEST_NONE || !n->held) continue;
+        n->held = false;
+        if (ev == NEST_RESET) {
+            nest_emit(bh, text, len, base, start_off, n->held_end);
+        } else if (n->mode == A_SENTENCE_CHUNKER_NESTING_DEFER) {
+            size_t end = trailing_closers(text, i, len, lang);
+            for (size_t k = i + 1; k <= end; k++) {
+                nest_byte(n, text, k);
             }
+            if (!lower_follows(text, end + 1, len)) {
+                nest_emit(bh, text, len, base, start_off, end + 1);
+            }
+            i = end;
         }
     }
+    return i;
+}
+
+// ----------------------------------------------------------------------------
+//                     FIRST PASS: CHUNK INTO SENTENCES
+// ----------------------------------------------------------------------------
+
+/*
+   settled: True when text[i+1..len) holds a byte that is not whitespace,
+   a closer or sentence punctuation. Every lookahead the run starting at i
+   needs (the rest of the run, decimals, abbreviations, ordinals, closers
+   and the whitespace before the next sentence) then ends inside the text,
+   so more input cannot change its decision.
+*/
+static inline bool settled(const char *text, size_t i, size_t len) {
+    for (size_t j = i + 1; j < len; j++) {
+        char c = text[j];
+        if (!is_whitespace(c) && !is_sentence_punct(c) &&
+            c != '\"' && c != '\'' && c != ')' && c != ']' && c != '}')
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+   first_pass_loop: The first-pass scan over text[0..len) from index i,
+   with the current sentence starting at *start_off, under lang's rules
+   (NULL: built-in). Chunks are appended to bh with base added to their
+   offsets. With settle (built-in rules only), stops at the
+   first punctuation run whose decision depends on bytes past len and
+   returns its index (for streaming); otherwise returns len. With nest,
+   every byte also goes through the nesting state and boundaries inside a
+   span are held back. The caller captures the leftover [*start_off..len).
+*/
+static inline size_t first_pass_loop(aml_buffer_t *bh, const char *text, size_t len,
+                                     size_t i, size_t *start_off_io, size_t base,
+                                     bool settle, const a_sentence_chunker_lang_t *lang,
+                                     nesting_state_t *nest, a_sentence_chunker_trace_t *trace)
+{
+    size_t start_off = *start_off_io;
+    while (i < len) {
+        char c = text[i];
+
+        if (is_terminator(lang, c)) {
+            if (settle && !settled(text, i, len)) {
+                break;
+            }
+            // Gather consecutive punctuation
+            size_t last_punct = consume_multiple_punctuation(text, i, len, lang);
+
+            // Check if it's end-of-sentence
+            A_SC_COUNT(punct_runs);
+            size_t walked = 0, abbrev = 0;
+            a_sentence_chunker_rule_t rule =
+                end_of_sentence_rule(text, last_punct, len, lang, &walked, &abbrev);
+            if (nest) {
+                nest->newline = false;
+            }
+            if (rule == A_SENTENCE_CHUNKER_RULE_BOUNDARY) {
+                size_t run_end = last_punct;
+                // Include any trailing closers
+                last_punct = trailing_closers(text, last_punct, len, lang);
+                if (nest && nest_level(nest)) {
+                    for (size_t k = run_end + 1; k <= last_punct; k++) {
+                        nest_byte(nest, text, k);
+                    }
+                    if (nest_level(nest)) {
+                        // Still inside the span: hold the boundary
+                        nest->held = true;
+                        nest->held_end = last_punct + 1;
+                        rule = A_SENTENCE_CHUNKER_RULE_NESTED;
+                    } else {
+                        // The closers ended the span: a sentence end unless it continues
+                        nest->held = false;
+                        if (lower_follows(text, last_punct + 1, len)) {
+                            rule = A_SENTENCE_CHUNKER_RULE_NESTED;
+                        }
+                    }
+                } else if (nest) {
+                    for (size_t k = run_end + 1; k <= last_punct; k++) {
+                        nest_byte(nest, text, k);
+                    }
+                }
+                if (rule == A_SENTENCE_CHUNKER_RULE_NESTED) {
+                    if (trace) {
+                        a_sc_trace_punct_run(trace, base + i, base + run_end, rule, 0, walked);
+                    }
+                    i = last_punct + 1;
+                    continue;
+                }
+                A_SC_COUNT(boundaries);
+                if (trace) {
+                    a_sc_trace_punct_run(trace, base + i, base + run_end, rule,
+                                         base + last_punct + 1, walked);
+                }
+
+                // Boundary is [start_off.. last_punct+1]
+                size_t boundary_len = (last_punct + 1) - start_off;
+                if (boundary_len > 0) {
+                    a_sentence_chunk_t sb;
+                    sb.start_offset = base + start_off;
+                    sb.length = boundary_len;
+                    aml_buffer_append(bh, &sb, sizeof(sb));
+                }
+
+                // Next sentence starts after last_punct + 1
+                i = last_punct + 1;
+                start_off = i;
+
+                // Skip trailing spaces
+                while (start_off < len && is_whitespace(text[start_off])) {
+                    start_off++;
+                }
+                continue;
+            }
+            else {
+                if (trace) {
+                    a_sc_trace_punct_run(trace, base + i, base + last_punct, rule, abbrev, walked);
+                }
+                // Not a boundary -> skip punctuation
+                i = last_punct + 1;
+                continue;
+            }
+        }
+        else if (nest) {
+            i = nest_scan(nest, bh, text, i, len, base, &start_off, lang);
+        }
+        else if (!lang || lang->default_terminators) {
+            // Normal characters: jump to the next punctuation
+            i = a_sc_scan_punct(text, i + 1, len);
+        }
+        else {
+            i = scan_terminator(lang, text, i + 1, len);
+        }
+    }
+    if (nest && nest->held) {
+        // An unclosed span at the end still ends at its last boundary
+        nest->held = false;
+        nest_emit(bh, text, len, base, &start_off, nest->held_end);
+    }
+    *start_off_io = start_off;
+    return i;
+}
+
+// ----------------------------------------------------------------------------
+//                     MARKDOWN: BLOCKS IN THE FIRST PASS
+// ----------------------------------------------------------------------------
+
+/* What a Markdown line starts (A_SENTENCE_CHUNKER_FORMAT_MARKDOWN). */
+typedef enum {
+    MD_PROSE,
+    MD_LIST,     // "- ", "* ", "+ ", "1. ", "1) "
+    MD_HEADING,  // "# " .. "###### "
+    MD_TABLE,    // "| a | b |"
+    MD_FENCE,    // ``` or ~~~
+    MD_RULE,     // ---, ***, ___, === (thematic break, setext underline, table delimiter)
+    MD_BLANK
+} md_line_t;
+
+/*
+   md_classify: Classify the line text[i..eol). *content receives the
+   first byte after the indentation, *indent its width (tabs count 4).
+*/
+static inline md_line_t md_classify(const char *text, size_t i, size_t eol,
+                                    size_t *content, size_t *indent)
+{
+    size_t p = i, w = 0;
+    while (p < eol && (text[p] == ' ' || text[p] == '\t')) {
+        w += text[p] == '\t' ? 4 : 1;
+        p++;
+    }
+    *content = p;
+    *indent = w;
+    while (eol > p && is_whitespace(text[eol - 1])) {
+        eol--;
+    }
+    if (p == eol) return MD_BLANK;
+    char c = text[p];
+    size_t run = 1;
+    while (p + run < eol && text[p + run] == c) {
+        run++;
+    }
+    char after = p + run < eol ? text[p + run] : ' ';
+    if ((c == '`' || c == '~') && run >= 3) return MD_FENCE;
+    if (c == '#' && run <= 6 && (after == ' ' || after == '\t')) return MD_HEADING;
+    if (c == '|') {
+        // "|---|:--:|" delimiter rows carry no text
+        for (size_t k = p; k < eol; k++) {
+            char d = text[k];
+            if (d != '|' && d != '-' && d != ':' && d != ' ' && d != '\t') return MD_TABLE;
+        }
+        return MD_RULE;
+    }
+    if ((c == '-' || c == '*' || c == '_' || c == '=') && run >= 3 && p + run == eol) {
+        return MD_RULE;
+    }
+    if ((c == '-' || c == '*' || c == '+') && (after == ' ' || after == '\t')) return MD_LIST;
+    if (isdigit((unsigned char)c) && run <= 9) {
+        size_t d = p;
+        while (d < eol && isdigit((unsigned char)text[d])) {
+            d++;
+        }
+        if (d - p <= 9 && d < eol && (text[d] == '.' || text[d] == ')') &&
+            (d + 1 == eol || text[d + 1] == ' ' || text[d + 1] == '\t'))
+        {
+            return MD_LIST;
+        }
+    }
+    return MD_PROSE;
+}
+
+/* End of text[i..eol) without trailing whitespace. */
+static inline size_t md_trim(const char *text, size_t i, size_t eol) {
+    while (eol > i && is_whitespace(text[eol - 1])) {
+        eol--;
+    }
+    return eol;
+}
+
+static inline void md_emit(aml_buffer_t *bh, size_t start, size_t end) {
+    if (end > start) {
+        a_sentence_chunk_t sb;
+        sb.start_offset = start;
+        sb.length = end - start;
+        aml_buffer_append(bh, &sb, sizeof(sb));
+    }
+}
+
+/*
+   md_prose: Chunk the prose block text[start..end) into sentences,
+   scanning from body (past a list marker, whose "1." is no sentence
+   end). The rules only look ahead inside the block, so a sentence never
+   runs into the next heading or list item.
+*/
+static inline void md_prose(aml_buffer_t *bh, const char *text, size_t start, size_t body,
+                            size_t end, const a_sentence_chunker_lang_t *lang,
+                            nesting_state_t *nest, a_sentence_chunker_trace_t *trace)
+{
+    if (nest) {
+        nest->depth = 0;
+        nest->quote = false;
+        nest->held = false;
+        nest->newline = false;
+    }
+    size_t start_off = start;
+    first_pass_loop(bh, text, end, body, &start_off, 0, false, lang, nest, trace);
+    md_emit(bh, start_off, end);
+}
+
+/*
+   markdown_pass: The first pass under A_SENTENCE_CHUNKER_FORMAT_MARKDOWN.
+   One forward walk over the lines classifies each one and hands runs of
+   prose lines (paragraphs, list items) to the sentence rules as they
+   close. Headings and table rows are single chunks; fenced and indented
+   code blocks are single opaque chunks that include their fences or
+   indentation. Blank lines, thematic breaks and table delimiter rows end
+   a block and belong to no chunk.
+*/
+static inline void markdown_pass(aml_buffer_t *bh, const char *text, size_t len,
+                                 const a_sentence_chunker_lang_t *lang, nesting_state_t *nest,
+                                 a_sentence_chunker_trace_t *trace)
+{
+    size_t seg = len, body = 0, seg_end = 0; // open prose block (seg == len: none)
+    size_t code = len, code_end = 0; // open code block
+    char fence = 0;                  // its fence character (0: indented)
+    size_t fence_run = 0;
+    bool prev_blank = true, in_list = false;
+    for (size_t i = 0; i < len;) {
+        const char *nl = (const char *)memchr(text + i, '\n', len - i);
+        size_t eol = nl ? (size_t)(nl - text) : len;
+        size_t next = nl ? eol + 1 : len;
+        size_t p, indent;
+        md_line_t kind = md_classify(text, i, eol, &p, &indent);
+
+        if (code < len && fence) {
+            // Inside a fenced block: only a long enough matching fence closes it
+            size_t run = 0;
+            while (p + run < eol && text[p + run] == fence) {
+                run++;
+            }
+            if (indent < 4 && run >= fence_run && md_trim(text, p + run, eol) == p + run) {
+                md_emit(bh, code, md_trim(text, i, eol));
+                code = len;
+                prev_blank = false;
+            }
+            i = next;
+            continue;
+        }
+        if (code < len) {
+            // Indented block: runs on over blank lines and lines indented 4+
+            if (kind == MD_BLANK || indent >= 4) {
+                if (kind != MD_BLANK) code_end = md_trim(text, i, eol);
+                i = next;
+                continue;
+            }
+            md_emit(bh, code, code_end);
+            code = len;
+            prev_blank = true;
+        }
+        if (kind == MD_PROSE && indent >= 4 && prev_blank && !in_list && seg == len) {
+            code = i;
+            code_end = md_trim(text, i, eol);
+            fence = 0;
+            i = next;
+            continue;
+        }
+        if (kind != MD_PROSE && seg < len) {
+            md_prose(bh, text, seg, body, seg_end, lang, nest, trace);
+            seg = len;
+        }
+        switch (kind) {
+        case MD_FENCE:
+            code = p;
+            fence = text[p];
+            fence_run = 0;
+            while (p + fence_run < eol && text[p + fence_run] == fence) {
+                fence_run++;
+            }
+            break;
+        case MD_HEADING:
+        case MD_TABLE:
+            md_emit(bh, p, md_trim(text, p, eol));
+            in_list = false;
+            break;
+        case MD_LIST:
+            seg = p;
+            seg_end = md_trim(text, p, eol);
+            body = p;
+            while (body < seg_end && !is_whitespace(text[body])) {
+                body++;
+            }
+            in_list = true;
+            break;
+        case MD_PROSE:
+            if (prev_blank && indent == 0) in_list = false;
+            if (seg == len) seg = body = p;
+            seg_end = md_trim(text, p, eol);
+            break;
+        case MD_RULE:
+            in_list = false;
+            break;
+        default: // MD_BLANK
+            break;
+        }
+        prev_blank = kind == MD_BLANK;
+        i = next;
+    }
+    if (seg < len) {
+        md_prose(bh, text, seg, body, seg_end, lang, nest, trace);
+    }
+    if (code < len) {
+        // An unclosed fence runs to the end of the text
+        md_emit(bh, code, fence ? md_trim(text, code, len) : code_end);
+    }
+}
+
+// ----------------------------------------------------------------------------
+//                     RUNS: SENTENCES OVER PIECES OF THE TEXT
+// ----------------------------------------------------------------------------
+
+/*
+   Formats whose prose comes in pieces (the visible text between HTML
+   tags, the lines of a comment) feed each piece to the sentence rules as
+   a run. A sentence may span runs; it then covers the bytes between them.
+*/
+typedef struct {
+    bool open;
+    size_t start; // first byte of the open sentence
+    size_t end;   // end of its last non-whitespace byte so far
+} run_sentence_t;
+
+/*
+   run_text: Run the sentence rules over the run text[a..b). The rules see
+   only the run, so nothing around it is read as punctuation or as part
+   of a word. A sentence still open from an earlier run is carried over:
+   the first boundary in this run closes it from its original start.
+*/
+static inline void run_text(aml_buffer_t *bh, const char *text, size_t a, size_t b,
+                            run_sentence_t *s, const a_sentence_chunker_lang_t *lang,
+                            a_sentence_chunker_trace_t *trace)
+{
+    if (!s->open) {
+        while (a < b && is_whitespace(text[a])) {
+            a++;
+        }
+    }
+    if (a == b) return;
+    size_t first = aml_buffer_length(bh) / sizeof(a_sentence_chunk_t);
+    size_t start_off = 0;
+    first_pass_loop(bh, text + a, b - a, 0, &start_off, a, false, lang, NULL, trace);
+    a_sentence_chunk_t *chunks = (a_sentence_chunk_t *)aml_buffer_data(bh);
+    if (s->open && aml_buffer_length(bh) / sizeof(a_sentence_chunk_t) > first) {
+        chunks[first].length += chunks[first].start_offset - s->start;
+        chunks[first].start_offset = s->start;
+        s->open = false;
+    }
+    size_t end = md_trim(text, a + start_off, b);
+    if (end > a + start_off) {
+        if (!s->open) {
+            s->open = true;
+            s->start = a + start_off;
+        }
+        s->end = end;
+    }
+}
+
+/* Emit the open sentence, if any. */
+static inline void run_close(aml_buffer_t *bh, run_sentence_t *s) {
+    if (s->open) {
+        md_emit(bh, s->start, s->end);
+        s->open = false;
+    }
+}
+
+// ----------------------------------------------------------------------------
+//                     HTML: VISIBLE TEXT IN THE FIRST PASS
+// ----------------------------------------------------------------------------
+
+/* Tags that end a block of text (A_SENTENCE_CHUNKER_FORMAT_HTML). */
+static const char *HTML_BLOCK_TAGS[] = {
+    "address", "article", "aside", "blockquote", "body", "br", "caption", "dd", "div", "dl",
+    "dt", "figcaption", "figure", "footer", "form", "h1", "h2", "h3", "h4", "h5", "h6",
+    "head", "header", "hr", "html", "li", "main", "nav", "ol", "option", "p", "pre",
+    "section", "table", "tbody", "td", "tfoot", "th", "thead", "title", "tr", "ul", NULL
+};
+
+/* Entities read as whitespace. */
+static const char *HTML_SPACE_ENTITIES[] = {
+    "&nbsp;", "&#160;", "&#xa0;", "&#xA0;", "&ensp;", "&emsp;", "&thinsp;",
+    "&#32;", "&#x20;", "&#9;", "&#10;", "&#13;", NULL
+};
+
+/* True when text[i..i+n) is name, ignoring ASCII case. */
+static inline bool html_name_is(const char *text, size_t i, size_t n, const char *name) {
+    for (size_t k = 0; k < n; k++) {
+        if (!name[k] || tolower((unsigned char)text[i + k]) != name[k]) return false;
+    }
+    return name[n] == '\0';
+}
+
+static inline bool html_name_char(char c) {
+    return isalnum((unsigned char)c) || c == '-' || c == '_' || c == ':' || c == '.';
+}
+
+/* Index just past the first needle in text[i..len), or len. */
+static inline size_t html_find(const char *text, size_t i, size_t len, const char *needle) {
+    size_t n = strlen(needle);
+    while (i + n <= len) {
+        const char *p = (const char *)memchr(text + i, needle[0], len - i - n + 1);
+        if (!p) break;
+        i = (size_t)(p - text);
+        if (!memcmp(p, needle, n)) return i + n;
+        i++;
+    }
+    return len;
+}
+
+/* Index just past the end tag of the element named text[name..name+n),
+   searching from i (script and style bodies), or len. */
+static inline size_t html_end_tag(const char *text, size_t i, size_t len, size_t name, size_t n) {
+    while (i < len) {
+        const char *p = (const char *)memchr(text + i, '<', len - i);
+        if (!p) break;
+        i = (size_t)(p - text) + 1;
+        if (i + n < len && text[i] == '/') {
+            bool same = true;
+            for (size_t k = 0; k < n && same; k++) {
+                same = tolower((unsigned char)text[i + 1 + k]) ==
+                       tolower((unsigned char)text[name + k]);
+            }
+            if (same && !html_name_char(text[i + 1 + n])) return html_find(text, i, len, ">");
+        }
+    }
+    return len;
+}
+
+/*
+   html_markup: Length of the markup starting at text[i] == '<': a tag
+   (quoted attribute values may hold '>'), comment, CDATA section,
+   declaration or processing instruction, and for <script> and <style>
+   everything up to their end tag. 0 when the '<' is text ("a < b").
+   *block is set for tags in HTML_BLOCK_TAGS.
+*/
+static inline size_t html_markup(const char *text, size_t i, size_t len, bool *block) {
+    *block = false;
+    size_t p = i + 1;
+    if (p >= len) return 0;
+    if (text[p] == '!' || text[p] == '?') {
+        const char *close = ">";
+        if (len - p >= 3 && !memcmp(text + p, "!--", 3)) {
+            close = "-->";
+            p += 3;
+        } else if (len - p >= 8 && !memcmp(text + p, "![CDATA[", 8)) {
+            close = "]]>";
+            p += 8;
+        }
+        return html_find(text, p, len, close) - i;
+    }
+    bool closing = text[p] == '/';
+    if (closing) p++;
+    size_t name = p;
+    if (p >= len || !isalpha((unsigned char)text[p])) return 0;
+    while (p < len && html_name_char(text[p])) {
+        p++;
+    }
+    size_t n = p - name;
+    char quote = 0, prev = 0;
+    for (; p < len; p++) {
+        char c = text[p];
+        if (quote) {
+            if (c == quote) quote = 0;
+        } else if (c == '>') {
+            break;
+        } else if ((c == '"' || c == '\'') && prev == '=') {
+            quote = c;
+        }
+        if (!is_whitespace(c)) prev = c;
+    }
+    size_t end = p < len ? p + 1 : len;
+    for (const char **t = HTML_BLOCK_TAGS; *t && !*block; t++) {
+        *block = html_name_is(text, name, n, *t);
+    }
+    if (!closing && text[end - 2] != '/' &&
+        (html_name_is(text, name, n, "script") || html_name_is(text, name, n, "style")))
+    {
+        end = html_end_tag(text, end, len, name, n);
+    }
+    return end - i;
+}
+
+/* Length of the whitespace entity at text[i] == '&', or 0. */
+static inline size_t html_space(const char *text, size_t i, size_t len) {
+    for (const char **e = HTML_SPACE_ENTITIES; *e; e++) {
+        size_t n = strlen(*e);
+        if (n <= len - i && !memcmp(text + i, *e, n)) return n;
+    }
+    return 0;
+}
+
+/*
+   html_pass: The first pass under A_SENTENCE_CHUNKER_FORMAT_HTML. One
+   forward walk splits the markup into runs of visible text at tags,
+   comments, script and style bodies and whitespace entities, and feeds
+   each run to the sentence rules as it reaches it. Block-level tags end
+   the open sentence. Chunks start and end on visible text but span any
+   inline markup inside a sentence.
+*/
+static inline void html_pass(aml_buffer_t *bh, const char *text, size_t len,
+                             const a_sentence_chunker_lang_t *lang,
+                             a_sentence_chunker_trace_t *trace)
+{
+    run_sentence_t s = { false, 0, 0 };
+    size_t run = 0;
+    for (size_t i = 0; i < len;) {
+        size_t skip = 0;
+        bool block = false;
+        if (text[i] == '<') {
+            skip = html_markup(text, i, len, &block);
+        } else if (text[i] == '&') {
+            skip = html_space(text, i, len);
+        }
+        if (!skip) {
+            i++;
+            continue;
+        }
+        run_text(bh, text, run, i, &s, lang, trace);
+        if (block) {
+            run_close(bh, &s);
+        }
+        i += skip;
+        run = i;
+    }
+    run_text(bh, text, run, len, &s, lang, trace);
+    run_close(bh, &s);
+}
+
+// ----------------------------------------------------------------------------
+//                     SOURCE CODE: COMMENTS IN THE FIRST PASS
+// ----------------------------------------------------------------------------
+
+/* True for the source-code formats, whose chunks come from comments only. */
+static inline bool is_code_format(a_sentence_chunker_format_t format) {
+    return format == A_SENTENCE_CHUNKER_FORMAT_C || format == A_SENTENCE_CHUNKER_FORMAT_PYTHON ||
+           format == A_SENTENCE_CHUNKER_FORMAT_GO || format == A_SENTENCE_CHUNKER_FORMAT_RUST;
+}
+
+static inline bool is_ident(char c) {
+    return isalnum((unsigned char)c) || c == '_' || (unsigned char)c >= 0x80;
+}
+
+/* Whitespace or comment decoration ("//", " * ", "#", "//!"). */
+static inline bool is_comment_marker(char c) {
+    return is_whitespace(c) || c == '/' || c == '*' || c == '#' || c == '!';
+}
+
+/*
+   code_line: Feed one line of comment text, text[a..b), to the rules. A
+   line with no letters or digits ("//", " *", "// -----") ends the open
+   sentence, as a blank line does in prose.
+*/
+static inline void code_line(aml_buffer_t *bh, const char *text, size_t a, size_t b,
+                             run_sentence_t *s, const a_sentence_chunker_lang_t *lang,
+                             a_sentence_chunker_trace_t *trace)
+{
+    for (size_t k = a; k < b; k++) {
+        if (isalnum((unsigned char)text[k]) || (unsigned char)text[k] >= 0x80) {
+            run_text(bh, text, a, b, s, lang, trace);
+            return;
+        }
+    }
+    run_close(bh, s);
+}
+
+/*
+   code_block: Feed the block comment or docstring text[a..end) to the
+   rules line by line. With stars, the leading whitespace and '*' of each
+   later line are decoration, not text.
+*/
+static inline void code_block(aml_buffer_t *bh, const char *text, size_t a, size_t end,
+                              bool stars, run_sentence_t *s,
+                              const a_sentence_chunker_lang_t *lang,
+                              a_sentence_chunker_trace_t *trace)
+{
+    while (a < end) {
+        const char *nl = (const char *)memchr(text + a, '\n', end - a);
+        size_t eol = nl ? (size_t)(nl - text) : end;
+        code_line(bh, text, a, eol, s, lang, trace);
+        a = eol + 1;
+        while (stars && a < end && (text[a] == ' ' || text[a] == '\t')) {
+            a++;
+        }
+        while (stars && a < end && text[a] == '*') {
+            a++;
+        }
+    }
+}
+
+/* Index of the "*" "/" that closes the block comment whose text starts
+   at i (Rust's nest), or len. */
+static inline size_t code_comment_end(const char *text, size_t i, size_t len, bool nested) {
+    unsigned depth = 1;
+    for (; i + 1 < len; i++) {
+        if (text[i] == '*' && text[i + 1] == '/') {
+            if (--depth == 0) return i;
+            i++;
+        } else if (nested && text[i] == '/' && text[i + 1] == '*') {
+            depth++;
+            i++;
+        }
+    }
+    return len;
+}
+
+/* Index just past the literal opened by text[i], honoring backslash
+   escapes. Unless multiline, an unescaped newline also ends it, so a
+   stray quote cannot swallow the rest of the file. */
+static inline size_t code_string_end(const char *text, size_t i, size_t len, bool escapes,
+                                     bool multiline)
+{
+    char quote = text[i];
+    for (i++; i < len; i++) {
+        char c = text[i];
+        if (c == '\\' && escapes) {
+            i++;
+        } else if (c == quote) {
+            return i + 1;
+        } else if (c == '\n' && !multiline) {
+            return i;
+        }
+    }
+    return len;
+}
+
+/* Index of the closing triple quote of a Python string whose text starts
+   at i, or len. */
+static inline size_t code_triple_end(const char *text, size_t i, size_t len, char quote) {
+    for (; i + 2 < len; i++) {
+        if (text[i] == '\\') {
+            i++;
+        } else if (text[i] == quote && text[i + 1] == quote && text[i + 2] == quote) {
+            return i;
+        }
+    }
+    return len;
+}
+
+/* True when the Python string at text[i] starts its line (after any
+   r/b/u/f prefix): a docstring, not an expression. */
+static inline bool code_docstring(const char *text, size_t i) {
+    while (i > 0 && text[i - 1] && strchr("rRuUbBfF", text[i - 1])) {
+        i--;
+    }
+    while (i > 0 && (text[i - 1] == ' ' || text[i - 1] == '\t')) {
+        i--;
+    }
+    return i == 0 || text[i - 1] == '\n';
+}
+
+/* Index just past the raw string whose opening quote is text[i]: C++
+   R"delim( ... )delim" (dlen: -1) or Rust r#"..."# with dlen hashes. */
+static inline size_t code_raw_end(const char *text, size_t i, size_t len, long dlen) {
+    if (dlen >= 0) {
+        for (size_t k = i + 1; k < len; k++) {
+            if (text[k] != '"') continue;
+            size_t h = 0;
+            while (h < (size_t)dlen && k + 1 + h < len && text[k + 1 + h] == '#') {
+                h++;
+            }
+            if (h == (size_t)dlen) return k + 1 + h;
+        }
+        return len;
+    }
+    size_t d = i + 1;
+    while (d < len && d - i <= 16 && text[d] != '(' && text[d] != '"' && !is_whitespace(text[d])) {
+        d++;
+    }
+    if (d >= len || text[d] != '(') return code_string_end(text, i, len, true, false);
+    size_t n = d - i - 1;
+    for (size_t k = d + 1; k + n + 1 < len; k++) {
+        if (text[k] == ')' && !memcmp(text + k + 1, text + i + 1, n) && text[k + 1 + n] == '"') {
+            return k + n + 2;
+        }
+    }
+    return len;
+}
+
+/*
+   code_literal_end: Index just past the string, character or rune
+   literal that starts at text[i] (a quote or backtick), by the format's
+   rules. A quote that opens no literal (a Rust lifetime, a C++ digit
+   separator) returns i + 1.
+*/
+static inline size_t code_literal_end(const char *text, size_t i, size_t len,
+                                      a_sentence_chunker_format_t format)
+{
+    char q = text[i];
+    char prev = i ? text[i - 1] : ' ';
+    bool c_like = format == A_SENTENCE_CHUNKER_FORMAT_C;
+    bool rust = format == A_SENTENCE_CHUNKER_FORMAT_RUST;
+    if (q == '`') {
+        // JavaScript template literals, Go raw strings
+        if (c_like) return code_string_end(text, i, len, true, true);
+        if (format == A_SENTENCE_CHUNKER_FORMAT_GO) return code_string_end(text, i, len, false, true);
+        return i + 1;
+    }
+    if (q == '\'') {
+        if (rust && (i + 1 >= len || text[i + 1] != '\\')) {
+            // 'x' is a char only if its closing quote follows the character
+            unsigned char lead = i + 1 < len ? (unsigned char)text[i + 1] : 0;
+            size_t n = lead >= 0xF0 ? 4 : lead >= 0xE0 ? 3 : lead >= 0xC0 ? 2 : 1;
+            return i + 1 + n < len && text[i + 1 + n] == '\'' ? i + 2 + n : i + 1;
+        }
+        if (c_like && isdigit((unsigned char)prev)) return i + 1;
+        return code_string_end(text, i, len, true, false);
+    }
+    if (c_like && prev == 'R' &&
+        (i < 2 || !is_ident(text[i - 2]) || (text[i - 2] && strchr("uUL8", text[i - 2]))))
+    {
+        return code_raw_end(text, i, len, -1);
+    }
+    if (rust) {
+        size_t h = 0;
+        while (h < i && text[i - 1 - h] == '#') {
+            h++;
+        }
+        size_t r = i - h; // just past the 'r'
+        if (r > 0 && text[r - 1] == 'r' &&
+            (r < 2 || !is_ident(text[r - 2]) || text[r - 2] == 'b'))
+        {
+            return code_raw_end(text, i, len, (long)h);
+        }
+    }
+    return code_string_end(text, i, len, true, rust);
+}
+
+/*
+   code_pass: The first pass under the source-code formats. One forward
+   lexer walks the code, skipping string, character and raw literals so
+   that nothing inside them reads as a comment, and feeds every comment
+   line to the sentence rules where it stands. A run of line comments on
+   consecutive lines is one paragraph; code, a blank line or an empty
+   comment line ends it. Each block comment and Python docstring is its
+   own paragraph. Chunks cover comment text only, plus the markers
+   between the lines of a sentence that spans lines.
+*/
+static inline void code_pass(aml_buffer_t *bh, const char *text, size_t len,
+                             a_sentence_chunker_format_t format,
+                             const a_sentence_chunker_lang_t *lang,
+                             a_sentence_chunker_trace_t *trace)
+{
+    bool py = format == A_SENTENCE_CHUNKER_FORMAT_PYTHON;
+    run_sentence_t s = { false, 0, 0 };
+    bool chain = false;    // the last thing seen was a line comment
+    unsigned newlines = 0; // since it ended
+    size_t i = 0;
+    if (py && len >= 2 && text[0] == '#' && text[1] == '!') {
+        // #! interpreter line
+        const char *nl = (const char *)memchr(text, '\n', len);
+        i = nl ? (size_t)(nl - text) : len;
+    }
+    while (i < len) {
+        char c = text[i];
+        if (is_whitespace(c)) {
+            newlines += c == '\n';
+            i++;
+            continue;
+        }
+        char d = i + 1 < len ? text[i + 1] : 0;
+        if (py ? c == '#' : c == '/' && d == '/') {
+            if (!chain || newlines > 1) {
+                run_close(bh, &s);
+            }
+            size_t a = i + 1;
+            while (a < len && (text[a] == c || text[a] == '!')) {
+                a++;
+            }
+            const char *nl = (const char *)memchr(text + a, '\n', len - a);
+            size_t eol = nl ? (size_t)(nl - text) : len;
+            code_line(bh, text, a, eol, &s, lang, trace);
+            chain = true;
+            newlines = 0;
+            i = eol;
+            continue;
+        }
+        // Anything else ends a comment paragraph
+        run_close(bh, &s);
+        chain = false;
+        if (!py && c == '/' && d == '*') {
+            size_t a = i + 2;
+            size_t end = code_comment_end(text, a, len, format == A_SENTENCE_CHUNKER_FORMAT_RUST);
+            while (a < end && (text[a] == '*' || text[a] == '!')) {
+                a++;
+            }
+            code_block(bh, text, a, end, true, &s, lang, trace);
+            run_close(bh, &s);
+            i = end < len ? end + 2 : len;
+        } else if (py && (c == '"' || c == '\'') && d == c && i + 2 < len && text[i + 2] == c) {
+            size_t end = code_triple_end(text, i + 3, len, c);
+            if (code_docstring(text, i)) {
+                code_block(bh, text, i + 3, end, false, &s, lang, trace);
+                run_close(bh, &s);
+            }
+            i = end < len ? end + 3 : len;
+        } else if (c == '"' || c == '\'' || c == '`') {
+            i = code_literal_end(text, i, len, format);
+        } else {
+            i++;
+        }
+    }
+    run_close(bh, &s);
+}
+
+// ----------------------------------------------------------------------------
+//                     PDF: PARAGRAPHS IN THE FIRST PASS
+// ----------------------------------------------------------------------------
+
+/*
+   pdf_pass: The first pass under A_SENTENCE_CHUNKER_FORMAT_PDF. A single
+   line break is already just whitespace to the sentence rules. A blank
+   line is a paragraph break in extracted text, so each paragraph is
+   chunked on its own and a sentence never runs into the next one (or a
+   heading, or a page number).
+*/
+static inline void pdf_pass(aml_buffer_t *bh, const char *text, size_t len,
+                            const a_sentence_chunker_lang_t *lang, nesting_state_t *nest,
+                            a_sentence_chunker_trace_t *trace)
+{
+    size_t para = skip_spaces(text, 0, len);
+    for (size_t i = para; i < len;) {
+        const char *nl = (const char *)memchr(text + i, '\n', len - i);
+        if (!nl) break;
+        size_t eol = (size_t)(nl - text);
+        size_t next = eol + 1;
+        while (next < len && (text[next] == ' ' || text[next] == '\t' || text[next] == '\r')) {
+            next++;
+        }
+        if (next < len && text[next] == '\n') {
+            md_prose(bh, text, para, para, md_trim(text, para, eol), lang, nest, trace);
+            para = skip_spaces(text, next, len);
+            i = para;
+        } else {
+            i = eol + 1;
+        }
+    }
+    if (para < len) {
+        md_prose(bh, text, para, para, md_trim(text, para, len), lang, nest, trace);
+    }
+}
+
+// ----------------------------------------------------------------------------
+//                     SUBTITLES AND TRANSCRIPTS: CUE TEXT IN THE FIRST PASS
+// ----------------------------------------------------------------------------
+
+/* True for the subtitle and transcript formats, whose chunks come from
+   cue text only. */
+static inline bool is_cue_format(a_sentence_chunker_format_t format) {
+    return format == A_SENTENCE_CHUNKER_FORMAT_SRT || format == A_SENTENCE_CHUNKER_FORMAT_VTT ||
+           format == A_SENTENCE_CHUNKER_FORMAT_TRANSCRIPT;
+}
+
+/* End of the line at text[i]: its '\n', or len. */
+static inline size_t cue_eol(const char *text, size_t i, size_t len) {
+    const char *nl = (const char *)memchr(text + i, '\n', len - i);
+    return nl ? (size_t)(nl - text) : len;
+}
+
+static inline size_t cue_blanks(const char *text, size_t i, size_t b) {
+    while (i < b && (text[i] == ' ' || text[i] == '\t')) {
+        i++;
+    }
+    return i;
+}
+
+/*
+   cue_time: Parse a timestamp at text[i..b): [h:]mm:ss with an optional
+   .fff or ,fff fraction (hours of any width, as in "0:03" or "1:02:03").
+   Returns the index past it, or i when there is none.
+*/
+static inline size_t cue_time(const char *text, size_t i, size_t b, int64_t *ms) {
+    int64_t parts[3] = { 0, 0, 0 };
+    int n = 0;
+    size_t p = i;
+    for (;;) {
+        size_t d = p;
+        int64_t v = 0;
+        while (p < b && p - d < 9 && isdigit((unsigned char)text[p])) {
+            v = v * 10 + (text[p++] - '0');
+        }
+        if (p == d || (n > 0 && p - d != 2)) return i;
+        parts[n++] = v;
+        if (n == 3 || p + 1 >= b || text[p] != ':' || !isdigit((unsigned char)text[p + 1])) break;
+        p++;
+    }
+    if (n < 2) return i;
+    int64_t frac = 0;
+    if (p + 1 < b && (text[p] == '.' || text[p] == ',') && isdigit((unsigned char)text[p + 1])) {
+        int64_t scale = 100;
+        for (p++; p < b && isdigit((unsigned char)text[p]); p++) {
+            frac += (text[p] - '0') * scale;
+            scale /= 10;
+        }
+    }
+    int64_t hours = n == 3 ? parts[0] : 0;
+    *ms = ((hours * 60 + parts[n - 2]) * 60 + parts[n - 1]) * 1000 + frac;
+    return p;
+}
+
+/* True when text[a..b) is a timing line, "00:00:01,000 --> 00:00:04,000"
+   (SRT) or "00:01.000 --> 00:04.000 align:start" (VTT). */
+static inline bool cue_timing(const char *text, size_t a, size_t b, int64_t *start_ms,
+                              int64_t *end_ms)
+{
+    size_t p = cue_blanks(text, a, b);
+    size_t t = cue_time(text, p, b, start_ms);
+    if (t == p) return false;
+    p = cue_blanks(text, t, b);
+    if (b - p < 3 || memcmp(text + p, "-->", 3) != 0) return false;
+    p = cue_blanks(text, p + 3, b);
+    return cue_time(text, p, b, end_ms) > p;
+}
+
+/* True when the line at text[i] is a timing line. */
+static inline bool cue_timing_at(const char *text, size_t i, size_t len) {
+    int64_t s, e;
+    return i < len && cue_timing(text, i, cue_eol(text, i, len), &s, &e);
+}
+
+/*
+   cue_stamp: A transcript line's leading stamp, "[00:01:02]", "(1:02)"
+   or a bare "00:01:02" followed by a space. Returns the index of the
+   text after it, or a when there is none.
+*/
+static inline size_t cue_stamp(const char *text, size_t a, size_t b, int64_t *ms) {
+    size_t p = a;
+    char close = 0;
+    if (text[p] == '[' || text[p] == '(') {
+        close = text[p++] == '[' ? ']' : ')';
+    }
+    size_t t = cue_time(text, p, b, ms);
+    if (t == p) return a;
+    if (close) {
+        if (t == b || text[t] != close) return a;
+        t++;
+    } else if (t < b && text[t] != ' ' && text[t] != '\t') {
+        return a;
+    }
+    return cue_blanks(text, t, b);
+}
+
+/*
+   cue_label: A speaker label at text[a..b): up to four words of at most
+   40 bytes before a ':' that ends the line or is followed by a space, as
+   in "Alice:", "Dr. Smith:" or "SPEAKER 2:". With caps (subtitles, where
+   dialogue may well contain "Note: ..."), no lowercase ASCII letters.
+   Returns the index of the text after it and sets *name_end, or returns
+   a when there is none.
+*/
+static inline size_t cue_label(const char *text, size_t a, size_t b, bool caps,
+                               size_t *name_end)
+{
+    if (a == b || !(isalnum((unsigned char)text[a]) || (unsigned char)text[a] >= 0x80)) return a;
+    unsigned spaces = 0;
+    bool letter = false;
+    for (size_t k = a; k < b && k - a <= 40; k++) {
+        unsigned char c = (unsigned char)text[k];
+        if (c == ':') {
+            if ((k + 1 < b && text[k + 1] != ' ' && text[k + 1] != '\t') || text[k - 1] == ' ' ||
+                !letter)
+            {
+                return a;
+            }
+            *name_end = k;
+            return cue_blanks(text, k + 1, b);
+        }
+        if (c == ' ') {
+            if (++spaces > 3) return a;
+        } else if (islower(c)) {
+            if (caps) return a;
+            letter = true;
+        } else if (isupper(c) || c >= 0x80) {
+            letter = true;
+        } else if (!isdigit(c) && c != '.' && c != '-' && c != '_' && c != '\'' && c != '#') {
+            return a;
+        }
+    }
+    return a;
+}
+
+/* A WebVTT voice span opening the line, "<v Name>" or "<v.class Name>":
+   sets the name's bounds. */
+static inline bool cue_voice(const char *text, size_t a, size_t b, size_t *name,
+                             size_t *name_end)
+{
+    if (b - a < 4 || text[a] != '<' || text[a + 1] != 'v' ||
+        (text[a + 2] != ' ' && text[a + 2] != '.'))
+    {
+        return false;
+    }
+    const char *gt = (const char *)memchr(text + a, '>', b - a);
+    if (!gt) return false;
+    size_t e = (size_t)(gt - text);
+    const char *sp = (const char *)memchr(text + a + 2, ' ', e - a - 2);
+    if (!sp) return false;
+    size_t n = cue_blanks(text, (size_t)(sp - text), e);
+    while (e > n && text[e - 1] == ' ') {
+        e--;
+    }
+    if (n == e) return false;
+    *name = n;
+    *name_end = e;
+    return true;
+}
+
+/* Length of the inline markup at text[i], a tag ("<i>", "</v>",
+   "<00:00:01.500>", "<font color=...>") or an SRT override ("{\an8}"),
+   or 0. */
+static inline size_t cue_markup(const char *text, size_t i, size_t b) {
+    char close;
+    if (text[i] == '<' && i + 1 < b &&
+        (isalnum((unsigned char)text[i + 1]) || text[i + 1] == '/'))
+    {
+        close = '>';
+    } else if (text[i] == '{' && i + 1 < b && text[i + 1] == '\\') {
+        close = '}';
+    } else {
+        return 0;
+    }
+    const char *end = (const char *)memchr(text + i, close, b - i);
+    return end ? (size_t)(end - text) - i + 1 : 0;
+}
 
-    // If we get here, treat '.' or '?' or '!' as a real boundary.
-    return true;
+/* A line of cue text, with what the lines before it established. */
+typedef struct {
+    size_t a, b;               // its text, past any stamp, label or dash
+    bool turn;                 // a new turn starts here
+    size_t turns;              // turns so far, this one included
+    int64_t start_ms, end_ms;  // its cue, or the stamp of its turn (end -1)
+    size_t speaker, speaker_length; // its speaker's name (length 0: none)
+} cue_line_t;
+
+typedef struct {
+    a_sentence_chunker_format_t format;
+    size_t i;        // start of the next line
+    bool cue;        // inside a cue's text (SRT, VTT)
+    bool blank;      // a blank line came before the next line
+    cue_line_t line; // carried from line to line
+} cue_reader_t;
+
+static inline void cue_reader_init(cue_reader_t *r, a_sentence_chunker_format_t format) {
+    memset(r, 0, sizeof(*r));
+    r->format = format;
+    r->line.start_ms = r->line.end_ms = -1;
 }
 
 /*
-   consume_multiple_punctuation:
-   If we encounter consecutive punctuation like "!!" or "...", treat them as one run.
-   Return the index of the last punctuation in that consecutive run.
+   cue_next: Read up to the next line of cue text. Subtitles: lines after
+   a timing line up to a blank line; index and identifier lines, the
+   WEBVTT header and NOTE, STYLE and REGION blocks are skipped. A dash
+   ("- Where?") starts a turn with no speaker, and a speaker label or VTT
+   voice span starts one when the speaker changes (they repeat on every
+   cue). Transcripts: every non-blank line; a label or a blank line
+   starts a turn, and a stamp sets the time until the next one.
 */
-static size_t consume_multiple_punctuation(const char *text,
-                                           size_t start_i,
-                                           size_t len)
-{
-    size_t i = start_i;
-    while ((i + 1) < len && is_sentence_punct(text[i + 1])) {
-        i++;
+static inline bool cue_next(cue_reader_t *r, const char *text, size_t len, cue_line_t *out) {
+    cue_line_t *l = &r->line;
+    while (r->i < len) {
+        size_t eol = cue_eol(text, r->i, len);
+        size_t b = md_trim(text, r->i, eol);
+        size_t a = skip_spaces(text, r->i, b);
+        r->i = eol < len ? eol + 1 : len;
+        if (a == b) {
+            r->cue = false;
+            r->blank = true;
+            continue;
+        }
+        bool turn = false;
+        int64_t start_ms, end_ms;
+        if (r->format != A_SENTENCE_CHUNKER_FORMAT_TRANSCRIPT) {
+            if (cue_timing(text, a, b, &start_ms, &end_ms)) {
+                r->cue = true;
+                l->start_ms = start_ms;
+                l->end_ms = end_ms;
+                continue;
+            }
+            // An index with no blank line before it ends the cue as well
+            if (!r->cue || cue_timing_at(text, r->i, len)) continue;
+            size_t name = a, name_end = a, p = a;
+            if (text[a] == '-' && a + 1 < b && is_whitespace(text[a + 1])) {
+                turn = true;
+                l->speaker_length = 0;
+                a = skip_spaces(text, a + 1, b);
+            } else if (!(r->format == A_SENTENCE_CHUNKER_FORMAT_VTT &&
+                         cue_voice(text, a, b, &name, &name_end)))
+            {
+                p = cue_label(text, a, b, true, &name_end);
+            }
+            if (name_end > name) {
+                size_t n = name_end - name;
+                turn = n != l->speaker_length || memcmp(text + name, text + l->speaker, n) != 0;
+                l->speaker = name;
+                l->speaker_length = n;
+                a = p;
+            }
+        } else {
+            size_t p = cue_stamp(text, a, b, &start_ms);
+            if (p > a) {
+                l->start_ms = start_ms;
+            }
+            size_t name_end = p;
+            a = cue_label(text, p, b, false, &name_end);
+            turn = r->blank || a > p;
+            if (a > p) {
+                l->speaker = p;
+                l->speaker_length = name_end - p;
+            }
+        }
+        r->blank = false;
+        l->turns += turn;
+        l->turn = turn;
+        l->a = a;
+        l->b = b;
+        *out = *l;
+        return true;
     }
-    return i;
+    return false;
 }
 
 /*
-   consume_trailing_closers:
-   Include trailing quotes/brackets after the end punctuation.
-   E.g. "Hello (anyone?)."
+   cue_pass: The first pass under the subtitle and transcript formats.
+   The lines of cue text are runs, split again at inline markup, so a
+   sentence spans lines and cues (and the timing lines between them) as
+   long as the speaker does not change. A new turn ends the open sentence.
 */
-static size_t consume_trailing_closers(const char *text, size_t i, size_t len)
+static inline void cue_pass(aml_buffer_t *bh, const char *text, size_t len,
+                            a_sentence_chunker_format_t format,
+                            const a_sentence_chunker_lang_t *lang,
+                            a_sentence_chunker_trace_t *trace)
 {
-    while ((i + 1) < len) {
-        char next_char = text[i + 1];
-        if (next_char == '\"' || next_char == '\'' ||
-            next_char == ')'  || next_char == ']'  ||
-            next_char == '}'  || is_sentence_punct(next_char))
-        {
-            i++;
+    run_sentence_t s = { false, 0, 0 };
+    cue_reader_t r;
+    cue_reader_init(&r, format);
+    bool markup = format != A_SENTENCE_CHUNKER_FORMAT_TRANSCRIPT;
+    cue_line_t line;
+    while (cue_next(&r, text, len, &line)) {
+        if (line.turn) {
+            run_close(bh, &s);
         }
-        else {
-            break;
+        size_t run = line.a;
+        for (size_t i = line.a; markup && i < line.b;) {
+            size_t skip = cue_markup(text, i, line.b);
+            if (!skip) {
+                i++;
+                continue;
+            }
+            run_text(bh, text, run, i, &s, lang, trace);
+            i += skip;
+            run = i;
         }
+        run_text(bh, text, run, line.b, &s, lang, trace);
     }
-    return i;
+    run_close(bh, &s);
 }
 
-// ----------------------------------------------------------------------------
-//                     FIRST PASS: CHUNK INTO SENTENCES
-// ----------------------------------------------------------------------------
+/* Lines of cue text in step with offsets into the text that never
+   decrease (the second pass and a_sentence_chunker_timed()). */
+typedef struct {
+    cue_reader_t r;
+    cue_line_t cur, next;
+    bool has_cur, has_next;
+    size_t prev_b; // end of the text of the line before cur (0: none)
+} cue_cursor_t;
+
+static inline void cue_cursor_init(cue_cursor_t *c, a_sentence_chunker_format_t format,
+                                   const char *text, size_t len)
+{
+    cue_reader_init(&c->r, format);
+    c->has_cur = false;
+    c->prev_b = 0;
+    c->has_next = cue_next(&c->r, text, len, &c->next);
+}
 
-a_sentence_chunk_t *a_sentence_chunker(
+/* The last line of cue text that starts at or before p, or NULL. */
+static inline const cue_line_t *cue_at(cue_cursor_t *c, const char *text, size_t len, size_t p) {
+    while (c->has_next && c->next.a <= p) {
+        c->prev_b = c->has_cur ? c->cur.b : 0;
+        c->cur = c->next;
+        c->has_cur = true;
+        c->has_next = cue_next(&c->r, text, len, &c->next);
+    }
+    return c->has_cur ? &c->cur : NULL;
+}
+
+A_SENTENCE_CHUNKER_API a_sentence_chunk_t *a_sentence_chunker(
     size_t *num_sentences_out,
     aml_buffer_t *bh,
     const char *text)
+{
+    return a_sentence_chunker_len(num_sentences_out, bh, text,
+                                  text ? strlen(text) : 0);
+}
+
+/*
+   first_pass: The whole first pass over text[0..len) under lang's rules
+   (NULL: built-in), with probes, stats and trace.
+*/
+static inline a_sentence_chunk_t *first_pass(size_t *num_sentences_out, aml_buffer_t *bh,
+                                             const char *text, size_t len,
+                                             const a_sentence_chunker_lang_t *lang,
+                                             const a_sc_dfa_t *dfa, nesting_state_t *nest,
+                                             a_sentence_chunker_format_t format)
 {
     aml_buffer_clear(bh);
     *num_sentences_out = 0;
-    if (!text || !*text) {
+    A_SC_PROBE2(chunker_entry, text, len);
+    a_sentence_chunker_stats_t *stats = a_sc_tls_stats;
+    uint64_t started = stats ? a_sc_now_ns() : 0;
+    a_sentence_chunker_trace_t *trace = a_sc_tls_trace;
+    if (trace) {
+        a_sc_trace_document(trace, A_SENTENCE_CHUNKER_PASS_FIRST, len);
+    }
+    if (!text || !len) {
+        A_SC_PROBE2(chunker_exit, len, 0);
+        if (stats) {
+            a_sc_stats_record_pass(stats, A_SENTENCE_CHUNKER_PASS_FIRST,
+                                   a_sc_now_ns() - started, 0, NULL, 0);
+        }
         return NULL;
     }
 
-    size_t len = strlen(text);
     size_t start_off = 0;
-    size_t i = 0;
-
-    while (i < len) {
-        char c = text[i];
-
-        if (is_sentence_punct(c)) {
-            // Gather consecutive punctuation
-            size_t last_punct = consume_multiple_punctuation(text, i, len);
-
-            // Check if it's end-of-sentence
-            if (is_end_of_sentence_heuristic(text, last_punct, len)) {
-                // Include any trailing closers
-                last_punct = consume_trailing_closers(text, last_punct, len);
-
-                // Boundary is [start_off.. last_punct+1]
-                size_t boundary_len = (last_punct + 1) - start_off;
-                if (boundary_len > 0) {
-                    a_sentence_chunk_t sb;
-                    sb.start_offset = start_off;
-                    sb.length = boundary_len;
-                    aml_buffer_append(bh, &sb, sizeof(sb));
-                }
-
-                // Next sentence starts after last_punct + 1
-                i = last_punct + 1;
-                start_off = i;
-
-                // Skip trailing spaces
-                while (start_off < len && is_whitespace(text[start_off])) {
-                    start_off++;
-                }
-                continue;
-            }
-            else {
-                // Not a boundary -> skip punctuation
-                i = last_punct + 1;
-                continue;
-            }
-        }
-        else {
-            // Normal character
-            i++;
-        }
+    if (format == A_SENTENCE_CHUNKER_FORMAT_MARKDOWN) {
+        markdown_pass(bh, text, len, lang, nest, trace);
+        start_off = len;
+    } else if (format == A_SENTENCE_CHUNKER_FORMAT_HTML) {
+        html_pass(bh, text, len, lang, trace);
+        start_off = len;
+    } else if (is_code_format(format)) {
+        code_pass(bh, text, len, format, lang, trace);
+        start_off = len;
+    } else if (format == A_SENTENCE_CHUNKER_FORMAT_PDF) {
+        pdf_pass(bh, text, len, lang, nest, trace);
+        start_off = len;
+    } else if (is_cue_format(format)) {
+        cue_pass(bh, text, len, format, lang, trace);
+        start_off = len;
+    } else if (dfa) {
+        start_off = a_sc_dfa_scan(dfa, bh, text, len);
+    } else {
+        first_pass_loop(bh, text, len, 0, &start_off, 0, false, lang, nest, trace);
     }
 
     // Capture leftover from [start_off..end]
@@ -284,18 +1832,127 @@ a_sentence_chunk_t *a_sentence_chunker(
 
     // Build array
     size_t total = aml_buffer_length(bh) / sizeof(a_sentence_chunk_t);
+    A_SC_PROBE2(chunker_exit, len, total);
+    a_sentence_chunk_t *array = (a_sentence_chunk_t *)aml_buffer_data(bh);
+    if (stats) {
+        a_sc_stats_record_pass(stats, A_SENTENCE_CHUNKER_PASS_FIRST,
+                               a_sc_now_ns() - started, len, array, total);
+    }
     if (total == 0) {
         return NULL;
     }
-    a_sentence_chunk_t *array = (a_sentence_chunk_t *)aml_buffer_data(bh);
     *num_sentences_out = total;
     return array;
 }
 
+A_SENTENCE_CHUNKER_API a_sentence_chunk_t *a_sentence_chunker_len(
+    size_t *num_sentences_out,
+    aml_buffer_t *bh,
+    const char *text,
+    size_t len)
+{
+    return first_pass(num_sentences_out, bh, text, len, NULL, NULL, NULL,
+                      A_SENTENCE_CHUNKER_FORMAT_TEXT);
+}
+
+/*
+   builtin_dfa: The built-in rules compiled by a_sc_dfa_compile(), built by
+   the first caller that asks for the DFA engine. Callers that find it
+   still being built use the rule engine, which gives the same chunks.
+*/
+static a_sc_dfa_t builtin_dfa;
+static atomic_int builtin_dfa_state; // 0 unbuilt, 1 building, 2 ready, 3 failed
+
+static inline const a_sc_dfa_t *builtin_dfa_get(void) {
+    int state = atomic_load_explicit(&builtin_dfa_state, memory_order_acquire);
+    if (state == 2) return &builtin_dfa;
+    if (state == 0 &&
+        atomic_compare_exchange_strong_explicit(&builtin_dfa_state, &state, 1,
+                                                memory_order_acq_rel, memory_order_acquire))
+    {
+        bool ok = a_sc_dfa_compile(&builtin_dfa, ABBREVS);
+        atomic_store_explicit(&builtin_dfa_state, ok ? 2 : 3, memory_order_release);
+        return ok ? &builtin_dfa : NULL;
+    }
+    return NULL;
+}
+
+A_SENTENCE_CHUNKER_API a_sentence_chunk_t *a_sentence_chunker_opts(
+    size_t *num_sentences_out,
+    aml_buffer_t *bh,
+    const char *text,
+    size_t len,
+    const a_sentence_chunker_options_t *opts)
+{
+    const a_sentence_chunker_lang_t *lang = opts ? opts->lang : NULL;
+    if (opts && (opts->nesting != A_SENTENCE_CHUNKER_NESTING_OFF ||
+                 opts->format != A_SENTENCE_CHUNKER_FORMAT_TEXT))
+    {
+        nesting_state_t nest;
+        memset(&nest, 0, sizeof(nest));
+        nest.mode = opts->nesting;
+        nest.max_depth = opts->nesting_max_depth ? opts->nesting_max_depth : 8;
+        // Nesting is not tracked across the runs of HTML text, comments or cues
+        bool nested = opts->nesting != A_SENTENCE_CHUNKER_NESTING_OFF &&
+                      (opts->format == A_SENTENCE_CHUNKER_FORMAT_TEXT ||
+                       opts->format == A_SENTENCE_CHUNKER_FORMAT_MARKDOWN ||
+                       opts->format == A_SENTENCE_CHUNKER_FORMAT_PDF);
+        return first_pass(num_sentences_out, bh, text, len, lang, NULL,
+                          nested ? &nest : NULL, opts->format);
+    }
+    // A constant NULL keeps the built-in rules' copy free of pack lookups
+    if (!lang) {
+        const a_sc_dfa_t *dfa =
+            opts && opts->engine == A_SENTENCE_CHUNKER_ENGINE_DFA ? builtin_dfa_get() : NULL;
+        return first_pass(num_sentences_out, bh, text, len, NULL, dfa, NULL,
+                          A_SENTENCE_CHUNKER_FORMAT_TEXT);
+    }
+    return first_pass(num_sentences_out, bh, text, len, lang, NULL, NULL,
+                      A_SENTENCE_CHUNKER_FORMAT_TEXT);
+}
+
+#ifndef A_SENTENCE_CHUNKER_HEADER_ONLY
+/*
+   a_sc_first_pass_step: first_pass_loop() for the stream chunker, which
+   re-enters it on a sliding window (base is the window's offset).
+*/
+size_t a_sc_first_pass_step(aml_buffer_t *bh, const char *text, size_t len,
+                            size_t i, size_t *start_off, size_t base, bool settle)
+{
+    return first_pass_loop(bh, text, len, i, start_off, base, settle, NULL, NULL,
+                           a_sc_tls_trace);
+}
+#endif
+
 // ----------------------------------------------------------------------------
 //        SECOND PASS: LENGTH-BASED RE-CHUNKING WITHOUT SPLITTING TOKENS
 // ----------------------------------------------------------------------------
 
+/*
+   hyphen_break: True when the whitespace at text[j] is the line break of
+   a word hyphenated across lines ("infor-\nmation"): a whitespace run
+   holding one newline, between a lowercase letter and '-' and a
+   lowercase letter.
+*/
+static inline bool hyphen_break(const char *text, size_t chunk_start, size_t chunk_end,
+                                size_t j)
+{
+    size_t a = j, b = j + 1, newlines = 0;
+    while (a > chunk_start && is_whitespace(text[a - 1])) {
+        a--;
+    }
+    if (a < chunk_start + 2 || text[a - 1] != '-' || !islower((unsigned char)text[a - 2])) {
+        return false;
+    }
+    while (b < chunk_end && is_whitespace(text[b])) {
+        b++;
+    }
+    for (size_t k = a; k < b; k++) {
+        newlines += text[k] == '\n';
+    }
+    return newlines == 1 && b < chunk_end && islower((unsigned char)text[b]);
+}
+
 /*
    Adjust the candidate split index so that we never split in the
    middle of a token (defined here as a contiguous run of non-whitespace).
@@ -303,11 +1960,10 @@ a_sentence_chunk_t *a_sentence_chunker(
      between [start_offset+1.. i].
    - Otherwise, we move forward to the next whitespace if possible.
    - If no whitespace can be found in either direction, we skip splitting.
+   With joins, the line break of a hyphenated word is part of the token.
 */
-static size_t adjust_for_token_boundary(const char *text,
-                                        size_t chunk_start,
-                                        size_t chunk_end,
-                                        size_t candidate)
+static inline size_t token_boundary(const char *text, size_t chunk_start, size_t chunk_end,
+                                    size_t candidate, bool joins)
 {
     // Safety checks
     if (candidate <= chunk_start || candidate >= chunk_end) {
@@ -318,17 +1974,23 @@ static size_t adjust_for_token_boundary(const char *text,
     {
         size_t j = candidate;
         while (j > chunk_start) {
-            if (is_whitespace(text[j])) {
+            if (is_whitespace(text[j]) &&
+                !(joins && hyphen_break(text, chunk_start, chunk_end, j)))
+            {
+                A_SC_COUNT_N(backward_walk_bytes, candidate - j);
                 return j; // found a suitable boundary
             }
             j--;
         }
+        A_SC_COUNT_N(backward_walk_bytes, candidate - chunk_start);
     }
     // 2) If that fails, try moving forward until we hit whitespace
     {
         size_t j = candidate;
         while (j < chunk_end) {
-            if (is_whitespace(text[j])) {
+            if (is_whitespace(text[j]) &&
+                !(joins && hyphen_break(text, chunk_start, chunk_end, j)))
+            {
                 return j; // found a suitable boundary
             }
             j++;
@@ -338,12 +2000,29 @@ static size_t adjust_for_token_boundary(const char *text,
     return 0; // signal "no valid boundary" => skip
 }
 
+A_SC_INTERNAL size_t adjust_for_token_boundary(const char *text,
+                                               size_t chunk_start,
+                                               size_t chunk_end,
+                                               size_t candidate)
+{
+    return token_boundary(text, chunk_start, chunk_end, candidate, false);
+}
+
 /*
-   find_split_point: tries to find a suitable break point within [start_offset..(start_offset+length)]
+   find_split_heuristic: tries to find a suitable break point within [start_offset..(start_offset+length)]
    that satisfies min_length <= chunk <= max_length and doesn't break tokens.
+   Reports which heuristic produced the split, the position it picked
+   before the token-boundary adjustment and how many positions the
+   backward searches visited. With soft (PDF-extracted text), a single
+   newline is only a space: heuristic 2 is off and hyphenated words stay
+   whole.
 */
-size_t find_split_point(const char *text, size_t start_offset, size_t length,
-                        size_t min_length, size_t max_length)
+static inline size_t find_split_heuristic(const char *text, size_t start_offset, size_t length,
+                                          size_t min_length, size_t max_length,
+                                          a_split_heuristic_t *heuristic,
+                                          size_t *candidate,
+                                          size_t *iterations,
+                                          bool soft)
 {
     size_t end_offset = start_offset + length;
 
@@ -370,12 +2049,15 @@ size_t find_split_point(const char *text, size_t start_offset, size_t length,
 
     // Heuristic 1: 2 consecutive newlines
     for (size_t i = search_end; i > search_start; i--) {
+        (*iterations)++;
         if ((i - 1) >= search_start && i < end_offset &&
             text[i - 1] == '\n' && text[i] == '\n')
         {
             // Adjust for token boundary
-            size_t adjusted = adjust_for_token_boundary(text, start_offset, end_offset, i);
+            *candidate = i;
+            size_t adjusted = token_boundary(text, start_offset, end_offset, i, soft);
             if (adjusted > start_offset && adjusted < end_offset) {
+                *heuristic = A_SPLIT_DOUBLE_NEWLINE;
                 return adjusted;
             }
             else {
@@ -386,13 +2068,16 @@ size_t find_split_point(const char *text, size_t start_offset, size_t length,
 
     // Heuristic 1b: 3 whitespace chars in a row
     for (size_t i = search_end; i > search_start; i--) {
+        (*iterations)++;
         if ((i - 2) >= search_start && i < end_offset &&
             isspace((unsigned char)text[i - 2]) &&
             isspace((unsigned char)text[i - 1]) &&
             isspace((unsigned char)text[i]))
         {
-            size_t adjusted = adjust_for_token_boundary(text, start_offset, end_offset, i);
+            *candidate = i;
+            size_t adjusted = token_boundary(text, start_offset, end_offset, i, soft);
             if (adjusted > start_offset && adjusted < end_offset) {
+                *heuristic = A_SPLIT_TRIPLE_SPACE;
                 return adjusted;
             }
             else {
@@ -402,10 +2087,13 @@ size_t find_split_point(const char *text, size_t start_offset, size_t length,
     }
 
     // Heuristic 2: single newline
-    for (size_t i = search_end; i > search_start; i--) {
+    for (size_t i = search_end; !soft && i > search_start; i--) {
+        (*iterations)++;
         if (text[i] == '\n') {
-            size_t adjusted = adjust_for_token_boundary(text, start_offset, end_offset, i);
+            *candidate = i;
+            size_t adjusted = token_boundary(text, start_offset, end_offset, i, soft);
             if (adjusted > start_offset && adjusted < end_offset) {
+                *heuristic = A_SPLIT_NEWLINE;
                 return adjusted;
             }
             else {
@@ -416,6 +2104,7 @@ size_t find_split_point(const char *text, size_t start_offset, size_t length,
 
     // Heuristic 3: punctuation + whitespace + uppercase letter
     for (size_t i = search_end; i > search_start; i--) {
+        (*iterations)++;
         if (i < end_offset) {
             char prev = text[i - 1];
             char curr = text[i];
@@ -426,8 +2115,10 @@ size_t find_split_point(const char *text, size_t start_offset, size_t length,
                     j++;
                 }
                 if (j < end_offset && isupper((unsigned char)text[j])) {
-                    size_t adjusted = adjust_for_token_boundary(text, start_offset, end_offset, i);
+                    *candidate = i;
+                    size_t adjusted = token_boundary(text, start_offset, end_offset, i, soft);
                     if (adjusted > start_offset && adjusted < end_offset) {
+                        *heuristic = A_SPLIT_PUNCT_UPPER;
                         return adjusted;
                     }
                     else {
@@ -440,9 +2131,12 @@ size_t find_split_point(const char *text, size_t start_offset, size_t length,
 
     // Heuristic 4: fallback - any whitespace in the allowed range
     for (size_t i = search_end; i > search_start; i--) {
+        (*iterations)++;
         if (isspace((unsigned char)text[i])) {
-            size_t adjusted = adjust_for_token_boundary(text, start_offset, end_offset, i);
+            *candidate = i;
+            size_t adjusted = token_boundary(text, start_offset, end_offset, i, soft);
             if (adjusted > start_offset && adjusted < end_offset) {
+                *heuristic = A_SPLIT_WHITESPACE;
                 return adjusted;
             }
             else {
@@ -454,8 +2148,11 @@ size_t find_split_point(const char *text, size_t start_offset, size_t length,
     // ============== NO HEURISTIC FOUND ==============
     // Fall back to search_end -> but must adjust for token boundary
     {
-        size_t adjusted = adjust_for_token_boundary(text, start_offset, end_offset, search_end);
+        *candidate = search_end;
+        size_t adjusted = token_boundary(text, start_offset, end_offset, search_end,
+                                         soft);
         if (adjusted > start_offset && adjusted < end_offset) {
+            *heuristic = A_SPLIT_FALLBACK;
             return adjusted;
         }
         else {
@@ -465,26 +2162,220 @@ size_t find_split_point(const char *text, size_t start_offset, size_t length,
 }
 
 /*
-   a_rechunk_sentences: Takes the first pass of chunked sentences
-   and merges/splits them based on min_length/max_length, but ensures
-   we never split in the middle of a token.
+   split_point: The split search; accounts for the heuristic that fired
+   when counters are compiled in and records the decision when a trace
+   is attached.
+*/
+static inline size_t split_point(const char *text, size_t start_offset, size_t length,
+                                 size_t min_length, size_t max_length, bool soft)
+{
+    a_split_heuristic_t heuristic = A_SPLIT_NONE;
+    size_t candidate = 0;
+    size_t iterations = 0;
+    A_SC_PROBE2(split_entry, start_offset, length);
+    size_t split = find_split_heuristic(text, start_offset, length,
+                                        min_length, max_length,
+                                        &heuristic, &candidate, &iterations, soft);
+    A_SC_PROBE4(split_exit, length, split - start_offset, iterations, (int)heuristic);
+    a_sentence_chunker_trace_t *trace = a_sc_tls_trace;
+    if (trace) {
+        a_sc_trace_split(trace, start_offset, length, split, candidate,
+                         heuristic, iterations);
+    }
+    A_SC_COUNT(split_calls);
+    A_SC_COUNT_AT(split_heuristic, heuristic, 1);
+    A_SC_COUNT_N(backward_walk_bytes, iterations);
+    return split;
+}
+
+A_SENTENCE_CHUNKER_API size_t find_split_point(const char *text, size_t start_offset,
+                                               size_t length, size_t min_length,
+                                               size_t max_length)
+{
+    return split_point(text, start_offset, length, min_length, max_length, false);
+}
+
+/*
+   md_chunk_kind: The Markdown block a first-pass chunk starts, from its
+   first bytes (MD_PROSE unless it starts a line). Only code blocks start
+   with indentation.
+*/
+static inline md_line_t md_chunk_kind(const char *text, a_sentence_chunk_t c) {
+    size_t end = c.start_offset + c.length;
+    size_t line = c.start_offset;
+    while (line > 0 && (text[line - 1] == ' ' || text[line - 1] == '\t')) {
+        line--;
+    }
+    if (!c.length || (line > 0 && text[line - 1] != '\n')) return MD_PROSE;
+    if (text[c.start_offset] == ' ' || text[c.start_offset] == '\t') return MD_FENCE;
+    size_t p, indent;
+    md_line_t kind = md_classify(text, c.start_offset, end, &p, &indent);
+    return kind == MD_RULE || kind == MD_BLANK ? MD_PROSE : kind;
+}
+
+/*
+   md_block_start: True when first-pass chunk i must not be merged with
+   the chunk before it: it starts a block, follows a heading, table row
+   or code block, or a blank line or skipped markup separates them.
+*/
+static inline bool md_block_start(const char *text, const a_sentence_chunk_t *chunks, size_t i) {
+    if (i == 0 || md_chunk_kind(text, chunks[i]) != MD_PROSE) return true;
+    md_line_t prev = md_chunk_kind(text, chunks[i - 1]);
+    if (prev == MD_HEADING || prev == MD_TABLE || prev == MD_FENCE) return true;
+    size_t newlines = 0;
+    for (size_t k = chunks[i - 1].start_offset + chunks[i - 1].length;
+         k < chunks[i].start_offset; k++)
+    {
+        if (!is_whitespace(text[k])) return true;
+        newlines += text[k] == '\n';
+    }
+    return newlines >= 2;
+}
+
+/* True when a block-level tag lies in text[i..end), between two chunks. */
+static inline bool html_block_between(const char *text, size_t i, size_t end) {
+    for (; i < end; i++) {
+        bool block;
+        size_t n = text[i] == '<' ? html_markup(text, i, end, &block) : 0;
+        if (n) {
+            if (block) return true;
+            i += n - 1;
+        }
+    }
+    return false;
+}
+
+/* A split point inside a tag moves back to the tag's '<', or past its
+   '>' when the tag opens text[start..end). */
+static inline size_t html_split(const char *text, size_t start, size_t end, size_t split) {
+    for (size_t k = split; k > start; k--) {
+        char c = text[k - 1];
+        if (c == '>') break;
+        if (c != '<') continue;
+        if (k - 1 > start) return k - 1;
+        const char *close = (const char *)memchr(text + split, '>', end - split);
+        return close ? (size_t)(close - text) + 1 : split;
+    }
+    return split;
+}
+
+/* True when text[i..end), between two chunks, holds code, a blank line
+   or the end of a block comment: chunks merge only across the markers
+   and single newlines inside one comment paragraph. */
+static inline bool code_block_between(const char *text, size_t i, size_t end) {
+    unsigned newlines = 0;
+    for (; i < end; i++) {
+        if (!is_comment_marker(text[i]) || (text[i] == '\n' && ++newlines > 1) ||
+            (text[i] == '*' && i + 1 < end && text[i + 1] == '/'))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+   code_split: When split falls in the whitespace and markers between the
+   lines of a comment, the head of text[start..end) ends on the earlier
+   line's text and the tail starts on the later line's text, leaving the
+   markers out.
+*/
+static inline void code_split(const char *text, size_t start, size_t end, size_t split,
+                              size_t *head_end, size_t *tail)
+{
+    *head_end = *tail = split;
+    size_t h = split, t = split;
+    while (h > start && is_comment_marker(text[h - 1]) && text[h - 1] != '\n') {
+        h--;
+    }
+    bool newline = h > start && text[h - 1] == '\n';
+    while (h > start && is_whitespace(text[h - 1])) {
+        h--;
+    }
+    while (t < end && is_comment_marker(text[t])) {
+        newline |= text[t] == '\n';
+        t++;
+    }
+    if (newline && h > start && t < end) {
+        *head_end = h;
+        *tail = t;
+    }
+}
+
+/*
+   cue_split: When split falls between the text of two cue lines (on a
+   timing line, an index or a repeated label, or right at the start of
+   the later line's text), the head of text[start..end) ends on the
+   earlier line's text and the tail starts on the later one's.
+*/
+static inline void cue_split(cue_cursor_t *c, const char *text, size_t len, size_t start,
+                             size_t end, size_t split, size_t *head_end, size_t *tail)
+{
+    *head_end = *tail = split;
+    const cue_line_t *line = cue_at(c, text, len, split);
+    if (!line) return;
+    if (split == line->a && c->prev_b > start) {
+        *head_end = c->prev_b;
+    } else if (split >= line->b && line->b > start && c->has_next && c->next.a < end) {
+        *head_end = line->b;
+        *tail = c->next.a;
+    }
+}
+
+/*
+   rechunk_pass: The second pass. Under Markdown, merges stay inside a block
+   and code blocks pass through whole. Under HTML, merges stay inside a
+   block and splits never land inside a tag. Under the source-code
+   formats, merges stay inside a comment paragraph and splits leave out
+   comment markers. Under the subtitle and transcript formats, merges stay
+   inside a turn and splits leave out what lies between cue lines.
 */
-a_sentence_chunk_t *a_rechunk_sentences(
+static inline a_sentence_chunk_t *rechunk_pass(
     size_t *num_sentences_out,
     aml_buffer_t *second_buffer,
     const char *text,
     a_sentence_chunk_t *first_pass_chunks,
     size_t first_pass_count,
     size_t min_length,
-    size_t max_length)
+    size_t max_length,
+    a_sentence_chunker_format_t format)
 {
+    bool md = format == A_SENTENCE_CHUNKER_FORMAT_MARKDOWN;
+    bool html = format == A_SENTENCE_CHUNKER_FORMAT_HTML;
+    bool code = is_code_format(format);
+    bool pdf = format == A_SENTENCE_CHUNKER_FORMAT_PDF;
+    bool cue = is_cue_format(format);
+    bool tags = html || (cue && format != A_SENTENCE_CHUNKER_FORMAT_TRANSCRIPT);
     aml_buffer_clear(second_buffer);
     *num_sentences_out = 0;
 
+    // Bytes spanned by the first pass (the input size of this pass)
+    size_t span_end = first_pass_count
+        ? first_pass_chunks[first_pass_count - 1].start_offset +
+          first_pass_chunks[first_pass_count - 1].length
+        : 0;
+    size_t span_bytes = first_pass_count ? span_end - first_pass_chunks[0].start_offset : 0;
+    // Subtitles and transcripts: the cue lines, read alongside the chunks
+    cue_cursor_t cues;
+    size_t turn = 0, last_turn = 0;
+    if (cue) {
+        cue_cursor_init(&cues, format, text, span_end);
+    }
+    A_SC_PROBE4(rechunk_entry, span_bytes, first_pass_count, min_length, max_length);
+    a_sentence_chunker_stats_t *stats = a_sc_tls_stats;
+    uint64_t started = stats ? a_sc_now_ns() : 0;
+    if (a_sc_tls_trace) {
+        a_sc_trace_document(a_sc_tls_trace, A_SENTENCE_CHUNKER_PASS_RECHUNK, span_bytes);
+    }
+
     for (size_t i = 0; i < first_pass_count; i++) {
         a_sentence_chunk_t current = first_pass_chunks[i];
-        size_t chunk_start = current.start_offset;
         size_t chunk_length = current.length;
+        if (cue) {
+            const cue_line_t *line = cue_at(&cues, text, span_end, current.start_offset);
+            last_turn = turn;
+            turn = line ? line->turns : 0;
+        }
 
         // CASE 1: length within [min_length, max_length]
         if (chunk_length >= min_length && chunk_length <= max_length) {
@@ -495,25 +2386,38 @@ a_sentence_chunk_t *a_rechunk_sentences(
         else if (chunk_length < min_length) {
             bool merged = false;
             // Attempt to merge with the previously appended chunk if that won't exceed max_length
-            if (i > 0) {
+            if (i > 0 && !(md && md_block_start(text, first_pass_chunks, i))) {
                 // Access the last chunk in second_buffer
                 a_sentence_chunk_t *last =
                     (a_sentence_chunk_t *)aml_buffer_end(second_buffer) - 1;
                 // New combined length
                 size_t combined_len = (current.start_offset + current.length)
                                     - last->start_offset;
-                if (combined_len <= max_length) {
+                size_t gap = last->start_offset + last->length;
+                if (combined_len <= max_length &&
+                    !(html && html_block_between(text, gap, current.start_offset)) &&
+                    !(code && code_block_between(text, gap, current.start_offset)) &&
+                    !(cue && turn != last_turn))
+                {
                     last->length = combined_len;
                     merged = true;
                 }
             }
 
             // If not merged with the previous chunk, try merging forward with the next chunk
-            if (!merged && (i + 1) < first_pass_count) {
+            if (!merged && (i + 1) < first_pass_count &&
+                !(md && md_block_start(text, first_pass_chunks, i + 1)))
+            {
                 size_t next_start = first_pass_chunks[i + 1].start_offset;
                 size_t next_len   = first_pass_chunks[i + 1].length;
                 size_t combined_len = (next_start + next_len) - current.start_offset;
-                if (combined_len <= max_length) {
+                size_t gap = current.start_offset + current.length;
+                const cue_line_t *line = cue ? cue_at(&cues, text, span_end, next_start) : NULL;
+                if (combined_len <= max_length &&
+                    !(html && html_block_between(text, gap, next_start)) &&
+                    !(code && code_block_between(text, gap, next_start)) &&
+                    !(cue && (line ? line->turns : 0) != turn))
+                {
                     // Merge them: we skip appending 'current' alone,
                     // and create a new merged chunk that covers both.
                     a_sentence_chunk_t merged_chunk;
@@ -530,29 +2434,51 @@ a_sentence_chunk_t *a_rechunk_sentences(
                 aml_buffer_append(second_buffer, &current, sizeof(current));
             }
         }
+        // Code blocks are opaque under Markdown
+        else if (md && md_chunk_kind(text, current) == MD_FENCE) {
+            aml_buffer_append(second_buffer, &current, sizeof(current));
+        }
         // CASE 3: chunk is too long => split
         else {
             a_sentence_chunk_t remaining = current;
             while (remaining.length > max_length) {
-                size_t split_pt = find_split_point(
+                size_t split_pt = split_point(
                     text,
                     remaining.start_offset,
                     remaining.length,
                     min_length,
-                    max_length
+                    max_length,
+                    pdf
                 );
+                if (tags) {
+                    split_pt = html_split(text, remaining.start_offset,
+                                          remaining.start_offset + remaining.length, split_pt);
+                }
                 // If no valid split found or split == entire chunk, we give up
                 if (split_pt <= remaining.start_offset ||
                     split_pt >= (remaining.start_offset + remaining.length))
                 {
                     // just break and append the leftover whole
+                    if (stats) {
+                        a_sc_stats_gave_up(stats);
+                    }
                     break;
                 }
+                size_t head_end = split_pt;
+                if (code) {
+                    code_split(text, remaining.start_offset,
+                               remaining.start_offset + remaining.length, split_pt,
+                               &head_end, &split_pt);
+                } else if (cue) {
+                    cue_split(&cues, text, span_end, remaining.start_offset,
+                              remaining.start_offset + remaining.length, split_pt,
+                              &head_end, &split_pt);
+                }
 
                 // Create the sub-chunk
                 a_sentence_chunk_t chunk;
                 chunk.start_offset = remaining.start_offset;
-                chunk.length = split_pt - remaining.start_offset;
+                chunk.length = head_end - remaining.start_offset;
                 aml_buffer_append(second_buffer, &chunk, sizeof(chunk));
 
                 // Update "remaining" to reflect leftover
@@ -567,10 +2493,143 @@ a_sentence_chunk_t *a_rechunk_sentences(
 
     // Build final array
     size_t total = aml_buffer_length(second_buffer) / sizeof(a_sentence_chunk_t);
+    A_SC_PROBE3(rechunk_exit, span_bytes, first_pass_count, total);
+    a_sentence_chunk_t *array = (a_sentence_chunk_t *)aml_buffer_data(second_buffer);
+    if (stats) {
+        a_sc_stats_record_pass(stats, A_SENTENCE_CHUNKER_PASS_RECHUNK,
+                               a_sc_now_ns() - started, span_bytes, array, total);
+    }
     if (total == 0) {
         return NULL;
     }
-    a_sentence_chunk_t *array = (a_sentence_chunk_t *)aml_buffer_data(second_buffer);
     *num_sentences_out = total;
     return array;
 }
+
+/*
+   a_rechunk_sentences: Takes the first pass of chunked sentences
+   and merges/splits them based on min_length/max_length, but ensures
+   we never split in the middle of a token.
+*/
+A_SENTENCE_CHUNKER_API a_sentence_chunk_t *a_rechunk_sentences(
+    size_t *num_sentences_out,
+    aml_buffer_t *second_buffer,
+    const char *text,
+    a_sentence_chunk_t *first_pass_chunks,
+    size_t first_pass_count,
+    size_t min_length,
+    size_t max_length)
+{
+    return rechunk_pass(num_sentences_out, second_buffer, text, first_pass_chunks, first_pass_count,
+                   min_length, max_length, A_SENTENCE_CHUNKER_FORMAT_TEXT);
+}
+
+A_SENTENCE_CHUNKER_API a_sentence_chunk_t *a_rechunk_sentences_opts(
+    size_t *num_sentences_out,
+    aml_buffer_t *second_buffer,
+    const char *text,
+    a_sentence_chunk_t *first_pass_chunks,
+    size_t first_pass_count,
+    size_t min_length,
+    size_t max_length,
+    const a_sentence_chunker_options_t *opts)
+{
+    return rechunk_pass(num_sentences_out, second_buffer, text, first_pass_chunks, first_pass_count,
+                   min_length, max_length, opts ? opts->format : A_SENTENCE_CHUNKER_FORMAT_TEXT);
+}
+
+// ----------------------------------------------------------------------------
+//                     TIMED CHUNKS: SUBTITLES AND TRANSCRIPTS
+// ----------------------------------------------------------------------------
+
+/*
+   a_sentence_chunker_timed: Reads the cue lines alongside the chunks, so
+   each chunk takes the time and speaker of the line it starts in and the
+   end time of the line it ends in. A transcript turn ends where the next
+   stamp starts; the lines up to it are looked ahead to once per stamp.
+*/
+A_SENTENCE_CHUNKER_API a_sentence_chunk_timed_t *a_sentence_chunker_timed(
+    size_t *num_out,
+    aml_buffer_t *bh,
+    const char *text,
+    size_t len,
+    const a_sentence_chunk_t *chunks,
+    size_t num_chunks,
+    const a_sentence_chunker_options_t *opts)
+{
+    aml_buffer_clear(bh);
+    *num_out = 0;
+    if (!num_chunks) return NULL;
+    a_sentence_chunker_format_t format = opts ? opts->format : A_SENTENCE_CHUNKER_FORMAT_TEXT;
+    bool cue = is_cue_format(format) && text;
+    cue_cursor_t c;
+    if (cue) {
+        cue_cursor_init(&c, format, text, len);
+    }
+    size_t *names = NULL; // offset and length of each speaker's first name
+    size_t num_names = 0, cap_names = 0;
+    int64_t stamp_end = -1;
+    size_t stamp_until = 0; // stamp_end holds for lines before this offset
+    for (size_t k = 0; k < num_chunks; k++) {
+        a_sentence_chunk_timed_t t;
+        memset(&t, 0, sizeof(t));
+        t.start_offset = chunks[k].start_offset;
+        t.length = chunks[k].length;
+        t.start_ms = t.end_ms = -1;
+        t.speaker = -1;
+        const cue_line_t *line = cue ? cue_at(&c, text, len, t.start_offset) : NULL;
+        if (line) {
+            t.start_ms = line->start_ms;
+            if (line->speaker_length) {
+                t.speaker_offset = line->speaker;
+                t.speaker_length = line->speaker_length;
+                int id = 0;
+                while ((size_t)id < num_names &&
+                       (names[2 * id + 1] != t.speaker_length ||
+                        memcmp(text + names[2 * id], text + t.speaker_offset, t.speaker_length)))
+                {
+                    id++;
+                }
+                if ((size_t)id == num_names) {
+                    if (num_names == cap_names) {
+                        size_t cap = cap_names ? 2 * cap_names : 8;
+                        size_t *grown = (size_t *)aml_realloc(names, 2 * cap * sizeof(size_t));
+                        if (!grown) {
+                            aml_free(names);
+                            aml_buffer_clear(bh);
+                            return NULL;
+                        }
+                        names = grown;
+                        cap_names = cap;
+                    }
+                    names[2 * id] = t.speaker_offset;
+                    names[2 * id + 1] = t.speaker_length;
+                    num_names++;
+                }
+                t.speaker = id;
+            }
+        }
+        if (cue && t.length) {
+            line = cue_at(&c, text, len, t.start_offset + t.length - 1);
+        }
+        if (line && format != A_SENTENCE_CHUNKER_FORMAT_TRANSCRIPT) {
+            t.end_ms = line->end_ms;
+        } else if (line && line->start_ms >= 0) {
+            if (line->a >= stamp_until) {
+                cue_reader_t ahead = c.r;
+                cue_line_t next = c.next;
+                bool more = c.has_next;
+                while (more && next.start_ms == line->start_ms) {
+                    more = cue_next(&ahead, text, len, &next);
+                }
+                stamp_end = more ? next.start_ms : -1;
+                stamp_until = more ? next.a : len;
+            }
+            t.end_ms = stamp_end;
+        }
+        aml_buffer_append(bh, &t, sizeof(t));
+    }
+    aml_free(names);
+    *num_out = num_chunks;
+    return (a_sentence_chunk_timed_t *)aml_buffer_data(bh);
+}
@@ -0,0 +1,107 @@
+// SPDX-FileCopyrightText: 2025 Andy Curtis <contactandyc@gmail.com>
+// SPDX-FileCopyrightText: 2024–2025 Knode.ai — technical questions: contact Andy (above)
+// SPDX-License-Identifier: Apache-2.0
+
+#include <string.h>
+
+#include "a_sentence_chunker_instrument.h"
+
+#ifdef A_SENTENCE_CHUNKER_COUNTERS
+
+#include <pthread.h>
+#include "a-memory-library/aml_alloc.h"
+
+/*
+   Per-thread counter blocks live on a global list so snapshots can find
+   them. The mutex is only taken when a thread first counts, when it exits
+   and when counters are snapshotted or reset -- never on the hot path.
+
+   Only the owning thread writes its block (a relaxed load and store), so
+   reset never touches live counters: it records the current totals and
+   snapshots report the difference.
+*/
+_Thread_local a_sc_counter_block_t *a_sc_tls_counters = NULL;
+
+static pthread_mutex_t counters_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t counters_once = PTHREAD_ONCE_INIT;
+static pthread_key_t counters_key;
+static a_sc_counter_block_t *live_blocks = NULL;
+static uint64_t retired[A_SC_COUNTER_SLOTS]; // totals of exited threads
+static uint64_t reset_at[A_SC_COUNTER_SLOTS]; // totals at the last reset
+
+static void block_retire(void *arg) {
+    a_sc_counter_block_t *b = (a_sc_counter_block_t *)arg;
+    pthread_mutex_lock(&counters_lock);
+    for (size_t i = 0; i < A_SC_COUNTER_SLOTS; i++) {
+        retired[i] += atomic_load_explicit(&b->v[i], memory_order_relaxed);
+    }
+    if (b->prev) b->prev->next = b->next;
+    else live_blocks = b->next;
+    if (b->next) b->next->prev = b->prev;
+    pthread_mutex_unlock(&counters_lock);
+    aml_free(b);
+}
+
+static void counters_key_init(void) {
+    pthread_key_create(&counters_key, block_retire);
+}
+
+a_sc_counter_block_t *a_sc_counters_attach(void) {
+    pthread_once(&counters_once, counters_key_init);
+
+    a_sc_counter_block_t *b = (a_sc_counter_block_t *)aml_calloc(sizeof(*b));
+    pthread_mutex_lock(&counters_lock);
+    b->next = live_blocks;
+    if (live_blocks) live_blocks->prev = b;
+    live_blocks = b;
+    pthread_mutex_unlock(&counters_lock);
+
+    pthread_setspecific(counters_key, b);
+    a_sc_tls_counters = b;
+    return b;
+}
+
+bool a_sentence_chunker_counters_enabled(void) {
+    return true;
+}
+
+/* Totals since the process started; the caller holds counters_lock. */
+static void counters_total(uint64_t *dst) {
+    memcpy(dst, retired, sizeof(retired));
+    for (a_sc_counter_block_t *b = live_blocks; b; b = b->next) {
+        for (size_t i = 0; i < A_SC_COUNTER_SLOTS; i++) {
+            dst[i] += atomic_load_explicit(&b->v[i], memory_order_relaxed);
+        }
+    }
+}
+
+void a_sentence_chunker_counters_snapshot(a_sentence_chunker_counters_t *out) {
+    uint64_t *dst = (uint64_t *)out;
+    pthread_mutex_lock(&counters_lock);
+    counters_total(dst);
+    for (size_t i = 0; i < A_SC_COUNTER_SLOTS; i++) {
+        dst[i] -= reset_at[i];
+    }
+    pthread_mutex_unlock(&counters_lock);
+}
+
+void a_sentence_chunker_counters_reset(void) {
+    pthread_mutex_lock(&counters_lock);
+    counters_total(reset_at);
+    pthread_mutex_unlock(&counters_lock);
+}
+
+#else
+
+bool a_sentence_chunker_counters_enabled(void) {
+    return false;
+}
+
+void a_sentence_chunker_counters_snapshot(a_sentence_chunker_counters_t *out) {
+    memset(out, 0, sizeof(*out));
+}
+
+void a_sentence_chunker_counters_reset(void) {
+}
+
+#endif
@@ -0,0 +1,422 @@
+// SPDX-FileCopyrightText: 2025 Andy Curtis <contactandyc@gmail.com>
+// SPDX-FileCopyrightText: 2024–2025 Knode.ai — technical questions: contact Andy (above)
+// SPDX-License-Identifier: Apache-2.0
+
+#include <stdint.h>
+#include <string.h>
+
+#include "a-memory-library/aml_alloc.h"
+#include "a-sentence-chunker-library/a_sentence_chunker.h"
+#include "a_sentence_chunker_dfa.h"
+
+/*
+   Rule compiler for the DFA engine. The boundary grammar is written once,
+   below, as a step function over a small abstract state: what the
+   backward walks of the rule engine would find (the word since the last
+   whitespace, its abbreviation-trie node, the digit run since the last
+   '.' or whitespace, the previous byte) plus what the forward lookahead
+   is still waiting for. Exploring every reachable abstract state under
+   every byte class yields a DFA; Mealy minimization then merges states
+   that no later input can tell apart.
+*/
+
+#define DFA_WORD_CAP 32          // abbreviation_rule() ignores words this long
+#define DFA_NODE_DEAD 0xFFFFu
+#define DFA_NODE_FROZEN 0xFFFEu  // a NUL ended a full abbreviation (strcasecmp stops there)
+
+enum { PH_TEXT, PH_RUN, PH_CLOSERS, PH_PENDING };
+enum { SEG_EMPTY, SEG_DIGITS, SEG_OTHER };
+enum { OUT_BOUNDARY, OUT_SKIP, OUT_PENDING };
+
+// What end_of_sentence_rule() knows about the word before a '.'
+enum {
+    SIG_PREV_DIGIT = 1,
+    SIG_LEN0 = 2,
+    SIG_LEN1 = 4,
+    SIG_LEN1_UPPER = 8,
+    SIG_ABBREV = 16,
+    SIG_DIGITS = 32
+};
+
+typedef struct {
+    uint8_t phase;
+    uint8_t lead;       // PH_TEXT: still in the whitespace before a sentence
+    uint8_t len;        // bytes since whitespace, capped at DFA_WORD_CAP
+    uint8_t upper1;     // len == 1 and that byte is uppercase
+    uint8_t seg;        // bytes since whitespace or '.': empty, digits, other
+    uint8_t prev_digit;
+    uint8_t run_dot;    // PH_RUN: the run so far ends in '.'
+    uint8_t sig;        // PH_RUN: SIG_* for the word before that '.'
+    uint16_t node;      // abbreviation trie, DFA_NODE_DEAD, DFA_NODE_FROZEN
+} dstate_t;
+
+typedef struct {
+    uint32_t *next;     // [node * 256 + folded byte], 0 = none (root is never a child)
+    uint8_t *terminal;
+    uint32_t num_nodes;
+} trie_t;
+
+// ----------------------------------------------------------------------------
+//                      THE RULES (mirror a_sentence_chunker.c)
+// ----------------------------------------------------------------------------
+
+static inline bool d_ws(uint8_t c) { return c == ' ' || c == '\t' || c == '\n' || c == '\r'; }
+static inline bool d_term(uint8_t c) { return c == '.' || c == '?' || c == '!'; }
+static inline bool d_closer(uint8_t c) {
+    return c == '"' || c == '\'' || c == ')' || c == ']' || c == '}';
+}
+static inline bool d_digit(uint8_t c) { return c >= '0' && c <= '9'; }
+static inline bool d_lower(uint8_t c) { return c >= 'a' && c <= 'z'; }
+static inline bool d_upper(uint8_t c) { return c >= 'A' && c <= 'Z'; }
+static inline uint8_t d_fold(uint8_t c) { return d_upper(c) ? (uint8_t)(c + 32) : c; }
+
+static void word_step(dstate_t *s, const trie_t *t, uint8_t b) {
+    if (d_ws(b)) {
+        s->len = 0;
+        s->upper1 = 0;
+        s->seg = SEG_EMPTY;
+        s->node = 0;
+    } else {
+        s->upper1 = s->len == 0 && d_upper(b);
+        if (s->len < DFA_WORD_CAP) s->len++;
+        if (s->node != DFA_NODE_DEAD && s->node != DFA_NODE_FROZEN) {
+            if (b == 0) {
+                s->node = t->terminal[s->node] ? DFA_NODE_FROZEN : DFA_NODE_DEAD;
+            } else {
+                uint32_t n = t->next[(size_t)s->node * 256 + d_fold(b)];
+                s->node = n ? (uint16_t)n : DFA_NODE_DEAD;
+            }
+        }
+        if (b == '.') s->seg = SEG_EMPTY;
+        else if (d_digit(b)) s->seg = s->seg == SEG_OTHER ? SEG_OTHER : SEG_DIGITS;
+        else s->seg = SEG_OTHER;
+    }
+    s->prev_digit = d_digit(b);
+    // Canonical form: forget what no rule can look at any more
+    if (s->len >= DFA_WORD_CAP) s->node = DFA_NODE_DEAD;
+    if (s->node == DFA_NODE_DEAD && s->len > 2) s->len = 2;
+}
+
+static uint8_t word_sig(const dstate_t *s, const trie_t *t) {
+    uint8_t sig = 0;
+    if (s->prev_digit) sig |= SIG_PREV_DIGIT;
+    if (s->len == 0) sig |= SIG_LEN0;
+    if (s->len == 1) sig |= s->upper1 ? (SIG_LEN1 | SIG_LEN1_UPPER) : SIG_LEN1;
+    if (s->len < DFA_WORD_CAP &&
+        (s->node == DFA_NODE_FROZEN || (s->node != DFA_NODE_DEAD && t->terminal[s->node])))
+        sig |= SIG_ABBREV;
+    if (s->seg == SEG_DIGITS) sig |= SIG_DIGITS;
+    return sig;
+}
+
+/* end_of_sentence_rule() for a run ending in '.', given the byte after it:
+   decimals, abbreviations, then ordinals (which may wait for the first
+   byte after whitespace). */
+static int decide(uint8_t sig, bool dot, uint8_t x) {
+    if (!dot) return OUT_BOUNDARY;
+    if ((sig & SIG_PREV_DIGIT) && d_digit(x)) return OUT_SKIP;
+    if (!(sig & SIG_LEN0)) {
+        if (d_lower(x) || d_upper(x)) return OUT_SKIP;
+        if (sig & SIG_LEN1_UPPER) return OUT_SKIP;
+        if ((sig & SIG_LEN1) && !d_ws(x)) return OUT_SKIP;
+        if (sig & SIG_ABBREV) return OUT_SKIP;
+    }
+    if (sig & SIG_DIGITS) {
+        if (d_ws(x)) return OUT_PENDING;
+        if (d_digit(x) || d_lower(x)) return OUT_SKIP;
+    }
+    return OUT_BOUNDARY;
+}
+
+// A byte scanned as ordinary text (first_pass_loop's main loop)
+static void text_step(dstate_t *s, const trie_t *t, uint8_t b, uint8_t *act) {
+    s->phase = PH_TEXT;
+    if (s->lead) {
+        if (d_ws(b)) {
+            *act |= A_SC_DFA_START_NEXT;
+            word_step(s, t, b);
+            return;
+        }
+        s->lead = 0;
+    }
+    if (d_term(b)) {
+        s->phase = PH_RUN;
+        s->run_dot = b == '.';
+        s->sig = s->run_dot ? word_sig(s, t) : 0;
+    }
+    word_step(s, t, b);
+}
+
+static dstate_t step(dstate_t s, const trie_t *t, uint8_t b, uint8_t *act) {
+    *act = 0;
+    switch (s.phase) {
+    case PH_TEXT:
+        text_step(&s, t, b, act);
+        break;
+    case PH_RUN:
+        if (d_term(b)) { // the run goes on; only its last byte is judged
+            text_step(&s, t, b, act);
+            break;
+        }
+        switch (decide(s.sig, s.run_dot, b)) {
+        case OUT_SKIP:
+            text_step(&s, t, b, act);
+            break;
+        case OUT_PENDING: // "<digits>." then whitespace: wait for the next word
+            *act |= A_SC_DFA_MARK;
+            word_step(&s, t, b);
+            s.phase = PH_PENDING;
+            break;
+        default:
+            if (d_closer(b)) {
+                word_step(&s, t, b);
+                s.phase = PH_CLOSERS;
+            } else {
+                *act |= A_SC_DFA_MARK | A_SC_DFA_EMIT;
+                s.lead = 1;
+                text_step(&s, t, b, act);
+            }
+            break;
+        }
+        break;
+    case PH_CLOSERS: // consume_trailing_closers()
+        if (d_closer(b) || d_term(b)) {
+            word_step(&s, t, b);
+        } else {
+            *act |= A_SC_DFA_MARK | A_SC_DFA_EMIT;
+            s.lead = 1;
+            text_step(&s, t, b, act);
+        }
+        break;
+    default: // PH_PENDING
+        if (d_ws(b)) {
+            word_step(&s, t, b);
+        } else {
+            if (!d_digit(b) && !d_lower(b)) {
+                *act |= A_SC_DFA_EMIT | A_SC_DFA_START_HERE;
+            }
+            text_step(&s, t, b, act);
+        }
+        break;
+    }
+    if (s.phase != PH_RUN) {
+        s.run_dot = 0;
+        s.sig = 0;
+    }
+    if (s.phase != PH_TEXT) s.lead = 0;
+    return s;
+}
+
+// ----------------------------------------------------------------------------
+//                              CONSTRUCTION
+// ----------------------------------------------------------------------------
+
+static bool trie_build(trie_t *t, const char *const *abbrevs) {
+    size_t chars = 1;
+    for (size_t k = 0; abbrevs[k]; k++) chars += strlen(abbrevs[k]);
+    if (chars >= DFA_NODE_FROZEN) return false;
+    t->next = (uint32_t *)aml_calloc(chars * 256 * sizeof(uint32_t));
+    t->terminal = (uint8_t *)aml_calloc(chars);
+    t->num_nodes = 1;
+    for (size_t k = 0; abbrevs[k]; k++) {
+        uint32_t n = 0;
+        for (const char *p = abbrevs[k]; *p; p++) {
+            uint32_t *slot = &t->next[(size_t)n * 256 + d_fold((uint8_t)*p)];
+            if (!*slot) *slot = t->num_nodes++;
+            n = *slot;
+        }
+        t->terminal[n] = 1;
+    }
+    return true;
+}
+
+static inline uint64_t state_key(const dstate_t *s) {
+    return (uint64_t)s->phase | (uint64_t)s->lead << 2 | (uint64_t)s->len << 3 |
+           (uint64_t)s->upper1 << 9 | (uint64_t)s->seg << 10 | (uint64_t)s->prev_digit << 12 |
+           (uint64_t)s->run_dot << 13 | (uint64_t)s->sig << 14 | (uint64_t)s->node << 20;
+}
+
+static inline uint32_t mix(uint64_t k) {
+    k ^= k >> 33;
+    k *= 0xff51afd7ed558ccdull;
+    k ^= k >> 33;
+    return (uint32_t)k;
+}
+
+typedef struct {
+    dstate_t *states;
+    uint64_t *keys;
+    uint32_t num, cap;
+    uint32_t *slots;     // open addressing, index + 1
+    uint32_t mask;
+} state_set_t;
+
+static uint32_t state_add(state_set_t *set, const dstate_t *s) {
+    uint64_t key = state_key(s);
+    if (2 * (set->num + 1) > set->mask + 1) {
+        uint32_t size = (set->mask + 1) * 2;
+        aml_free(set->slots);
+        set->slots = (uint32_t *)aml_calloc(size * sizeof(uint32_t));
+        set->mask = size - 1;
+        for (uint32_t k = 0; k < set->num; k++) {
+            uint32_t h = mix(set->keys[k]) & set->mask;
+            while (set->slots[h]) h = (h + 1) & set->mask;
+            set->slots[h] = k + 1;
+        }
+    }
+    uint32_t h = mix(key) & set->mask;
+    for (; set->slots[h]; h = (h + 1) & set->mask) {
+        if (set->keys[set->slots[h] - 1] == key) return set->slots[h] - 1;
+    }
+    if (set->num == set->cap) {
+        set->cap *= 2;
+        set->states = (dstate_t *)aml_realloc(set->states, set->cap * sizeof(dstate_t));
+        set->keys = (uint64_t *)aml_realloc(set->keys, set->cap * sizeof(uint64_t));
+    }
+    set->states[set->num] = *s;
+    set->keys[set->num] = key;
+    set->slots[h] = ++set->num;
+    return set->num - 1;
+}
+
+/* Byte classes: bytes every rule treats alike (same predicates, same trie
+   edge) share a column. */
+static uint32_t byte_classes(const trie_t *t, uint8_t klass[256], uint8_t reps[256]) {
+    uint32_t sigs[256];
+    uint32_t n = 0;
+    for (int c = 0; c < 256; c++) {
+        uint8_t b = (uint8_t)c;
+        bool edge = false;
+        for (uint32_t node = 0; node < t->num_nodes && !edge; node++) {
+            edge = t->next[(size_t)node * 256 + d_fold(b)] != 0;
+        }
+        uint32_t sig = (uint32_t)d_ws(b) | (uint32_t)(b == '.') << 1 | (uint32_t)d_term(b) << 2 |
+                       (uint32_t)d_closer(b) << 3 | (uint32_t)d_digit(b) << 4 |
+                       (uint32_t)d_lower(b) << 5 | (uint32_t)d_upper(b) << 6 |
+                       (uint32_t)(b == 0) << 7 | (edge ? (uint32_t)d_fold(b) + 1 : 0) << 8;
+        uint32_t k = 0;
+        while (k < n && sigs[k] != sig) k++;
+        if (k == n) {
+            sigs[n] = sig;
+            reps[n] = b;
+            n++;
+        }
+        klass[c] = (uint8_t)k;
+    }
+    return n;
+}
+
+/* Mealy minimization: start from states with the same actions per class,
+   split blocks until every member has the same successor blocks. Returns
+   the number of blocks; block[s] is each state's. */
+static uint32_t minimize(const uint32_t *next, const uint8_t *act, uint32_t num, uint32_t k,
+                         uint32_t *block)
+{
+    uint32_t *sig = (uint32_t *)aml_malloc((size_t)num * (2 * k + 1) * sizeof(uint32_t));
+    uint32_t *fresh = (uint32_t *)aml_malloc((size_t)num * sizeof(uint32_t));
+    uint32_t size = 16;
+    while (size < 2 * num) size <<= 1;
+    uint32_t *slots = (uint32_t *)aml_malloc(size * sizeof(uint32_t));
+    uint32_t blocks = 1;
+    memset(block, 0, num * sizeof(uint32_t));
+    for (;;) {
+        size_t w = 2 * (size_t)k + 1;
+        for (uint32_t s = 0; s < num; s++) {
+            uint32_t *row = sig + s * w;
+            row[0] = block[s];
+            for (uint32_t c = 0; c < k; c++) {
+                row[1 + c] = act[(size_t)s * k + c];
+                row[1 + k + c] = block[next[(size_t)s * k + c]];
+            }
+        }
+        memset(slots, 0, size * sizeof(uint32_t));
+        uint32_t count = 0;
+        for (uint32_t s = 0; s < num; s++) {
+            const uint32_t *row = sig + s * w;
+            uint64_t h = 1469598103934665603ull;
+            for (size_t j = 0; j < w; j++) h = (h ^ row[j]) * 1099511628211ull;
+            uint32_t p = mix(h) & (size - 1);
+            for (;; p = (p + 1) & (size - 1)) {
+                if (!slots[p]) {
+                    slots[p] = s + 1;
+                    fresh[s] = count++;
+                    break;
+                }
+                uint32_t o = slots[p] - 1;
+                if (memcmp(sig + o * w, row, w * sizeof(uint32_t)) == 0) {
+                    fresh[s] = fresh[o];
+                    break;
+                }
+            }
+        }
+        memcpy(block, fresh, num * sizeof(uint32_t));
+        if (count == blocks) break;
+        blocks = count;
+    }
+    aml_free(sig);
+    aml_free(fresh);
+    aml_free(slots);
+    return blocks;
+}
+
+A_SENTENCE_CHUNKER_API bool a_sc_dfa_compile(a_sc_dfa_t *dfa, const char *const *abbrevs) {
+    trie_t t;
+    if (!trie_build(&t, abbrevs)) return false;
+    uint8_t reps[256];
+    uint32_t k = byte_classes(&t, dfa->klass, reps);
+
+    state_set_t set;
+    set.cap = 1024;
+    set.num = 0;
+    set.states = (dstate_t *)aml_malloc(set.cap * sizeof(dstate_t));
+    set.keys = (uint64_t *)aml_malloc(set.cap * sizeof(uint64_t));
+    set.mask = 2047;
+    set.slots = (uint32_t *)aml_calloc((set.mask + 1) * sizeof(uint32_t));
+    size_t cap = set.cap;
+    uint32_t *next = (uint32_t *)aml_malloc(cap * k * sizeof(uint32_t));
+    uint8_t *act = (uint8_t *)aml_malloc(cap * k);
+
+    dstate_t init;
+    memset(&init, 0, sizeof(init));
+    state_add(&set, &init);
+    // Breadth-first over reachable states; rows fill in discovery order
+    for (uint32_t s = 0; s < set.num; s++) {
+        for (uint32_t c = 0; c < k; c++) {
+            uint8_t a;
+            dstate_t to = step(set.states[s], &t, reps[c], &a);
+            uint32_t n = state_add(&set, &to);
+            if (set.cap > cap) {
+                cap = set.cap;
+                next = (uint32_t *)aml_realloc(next, cap * k * sizeof(uint32_t));
+                act = (uint8_t *)aml_realloc(act, cap * k);
+            }
+            next[(size_t)s * k + c] = n;
+            act[(size_t)s * k + c] = a;
+        }
+    }
+
+    uint32_t *block = (uint32_t *)aml_malloc(set.num * sizeof(uint32_t));
+    uint32_t blocks = minimize(next, act, set.num, k, block);
+    bool ok = blocks <= A_SC_DFA_MAX_STATES && k <= A_SC_DFA_MAX_CLASSES;
+    if (ok) {
+        dfa->num_classes = k;
+        dfa->num_states = blocks;
+        dfa->start = block[0] * k;
+        for (uint32_t s = 0; s < set.num; s++) {
+            uint32_t *row = dfa->table + (size_t)block[s] * k;
+            for (uint32_t c = 0; c < k; c++) {
+                row[c] = block[next[(size_t)s * k + c]] * k |
+                         (uint32_t)act[(size_t)s * k + c] << A_SC_DFA_ACTION_SHIFT;
+            }
+        }
+    }
+    aml_free(block);
+    aml_free(next);
+    aml_free(act);
+    aml_free(set.states);
+    aml_free(set.keys);
+    aml_free(set.slots);
+    aml_free(t.next);
+    aml_free(t.terminal);
+    return ok;
+}
@@ -0,0 +1,85 @@
+// SPDX-FileCopyrightText: 2025 Andy Curtis <contactandyc@gmail.com>
+// SPDX-FileCopyrightText: 2024–2025 Knode.ai — technical questions: contact Andy (above)
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _a_sentence_chunker_dfa_h
+#define _a_sentence_chunker_dfa_h
+
+/*
+   Table-driven first pass (A_SENTENCE_CHUNKER_ENGINE_DFA).
+   a_sc_dfa_compile() turns the boundary rules (terminator runs, trailing
+   closers, decimals, ordinals, the abbreviation list) into a minimal
+   forward DFA over byte classes. The scan is then one table lookup per
+   byte and never walks backward.
+
+   Transitions carry action bits that move two registers: `mark`, the end
+   of the sentence being decided, and `start`, the first byte of the
+   current sentence. A decision that waits on later bytes ("1." then
+   spaces, closers after a terminator) lives in the state, not in a
+   rescan.
+*/
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "a-memory-library/aml_buffer.h"
+#include "a-sentence-chunker-library/a_sentence_chunker.h"
+
+#define A_SC_DFA_MAX_STATES 256
+#define A_SC_DFA_MAX_CLASSES 64
+#define A_SC_DFA_ACTION_SHIFT 24
+#define A_SC_DFA_ROW_MASK 0x00FFFFFFu
+
+// Transition actions, applied in this order
+enum {
+    A_SC_DFA_MARK = 1,       // mark = i
+    A_SC_DFA_EMIT = 2,       // emit [start, mark), start = mark
+    A_SC_DFA_START_HERE = 4, // start = i
+    A_SC_DFA_START_NEXT = 8  // start = i + 1 (whitespace before a sentence)
+};
+
+typedef struct {
+    uint8_t klass[256];      // byte -> class
+    uint32_t num_classes;
+    uint32_t num_states;
+    uint32_t start;          // row offset of the start state
+    // [row + class] = next row offset | actions << A_SC_DFA_ACTION_SHIFT,
+    // where row = state * num_classes
+    uint32_t table[A_SC_DFA_MAX_STATES * A_SC_DFA_MAX_CLASSES];
+} a_sc_dfa_t;
+
+/* Compile the built-in rules with the given NULL-terminated abbreviation
+   list (matched case-insensitively, as abbreviation_rule() does) into
+   *dfa. Returns false if the automaton does not fit. */
+A_SENTENCE_CHUNKER_API bool a_sc_dfa_compile(a_sc_dfa_t *dfa, const char *const *abbrevs);
+
+/* Append every sentence of text[0..len) that ends inside it to bh and
+   return the start of the unfinished one (len if none). */
+static inline size_t a_sc_dfa_scan(const a_sc_dfa_t *dfa, aml_buffer_t *bh,
+                                   const char *text, size_t len)
+{
+    const uint32_t *table = dfa->table;
+    const uint8_t *klass = dfa->klass;
+    uint32_t row = dfa->start;
+    size_t start = 0, mark = 0;
+    for (size_t i = 0; i < len; i++) {
+        uint32_t e = table[row + klass[(uint8_t)text[i]]];
+        row = e & A_SC_DFA_ROW_MASK;
+        uint32_t act = e >> A_SC_DFA_ACTION_SHIFT;
+        if (act) {
+            if (act & A_SC_DFA_MARK) mark = i;
+            if (act & A_SC_DFA_EMIT) {
+                a_sentence_chunk_t sb;
+                sb.start_offset = start;
+                sb.length = mark - start;
+                aml_buffer_append(bh, &sb, sizeof(sb));
+                start = mark;
+            }
+            if (act & A_SC_DFA_START_HERE) start = i;
+            if (act & A_SC_DFA_START_NEXT) start = i + 1;
+        }
+    }
+    return start;
+}
+
+#endif
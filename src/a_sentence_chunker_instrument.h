@@ -0,0 +1,165 @@
+// SPDX-FileCopyrightText: 2025 Andy Curtis <contactandyc@gmail.com>
+// SPDX-FileCopyrightText: 2024–2025 Knode.ai — technical questions: contact Andy (above)
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _a_sentence_chunker_instrument_h
+#define _a_sentence_chunker_instrument_h
+
+/*
+   Private instrumentation hooks used by the chunker. Every hook compiles to
+   nothing unless the matching feature macro is defined for the build.
+*/
+
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "a-sentence-chunker-library/a_sentence_chunker.h"
+#include "a-sentence-chunker-library/a_sentence_chunker_counters.h"
+#include "a-sentence-chunker-library/a_sentence_chunker_stats.h"
+#include "a-sentence-chunker-library/a_sentence_chunker_trace.h"
+
+#ifdef A_SENTENCE_CHUNKER_HEADER_ONLY
+#undef A_SENTENCE_CHUNKER_COUNTERS
+#undef A_SENTENCE_CHUNKER_USDT
+#endif
+
+#ifdef A_SENTENCE_CHUNKER_COUNTERS
+
+#include <stdatomic.h>
+
+#define A_SC_COUNTER_SLOTS \
+    (sizeof(a_sentence_chunker_counters_t) / sizeof(uint64_t))
+#define A_SC_COUNTER_SLOT(field) \
+    (offsetof(a_sentence_chunker_counters_t, field) / sizeof(uint64_t))
+
+/* One per thread; only the owning thread writes, snapshots read. */
+typedef struct a_sc_counter_block_s {
+    _Atomic uint64_t v[A_SC_COUNTER_SLOTS];
+    struct a_sc_counter_block_s *next;
+    struct a_sc_counter_block_s *prev;
+} a_sc_counter_block_t;
+
+extern _Thread_local a_sc_counter_block_t *a_sc_tls_counters;
+a_sc_counter_block_t *a_sc_counters_attach(void);
+
+static inline void a_sc_count_add(size_t slot, uint64_t n) {
+    a_sc_counter_block_t *b = a_sc_tls_counters;
+    if (!b) b = a_sc_counters_attach();
+    // Single writer: a relaxed load/store pair avoids a locked add
+    uint64_t cur = atomic_load_explicit(&b->v[slot], memory_order_relaxed);
+    atomic_store_explicit(&b->v[slot], cur + n, memory_order_relaxed);
+}
+
+/* An index past the counter array (say, a language pack entry) is dropped. */
+static inline void a_sc_count_at(size_t slot, size_t slots, size_t idx, uint64_t n) {
+    if (idx < slots) a_sc_count_add(slot + idx, n);
+}
+
+#define A_SC_COUNTER_LEN(field) \
+    (sizeof(((a_sentence_chunker_counters_t *)0)->field) / sizeof(uint64_t))
+
+#define A_SC_COUNT(field)      a_sc_count_add(A_SC_COUNTER_SLOT(field), 1)
+#define A_SC_COUNT_N(field, n) a_sc_count_add(A_SC_COUNTER_SLOT(field), (uint64_t)(n))
+#define A_SC_COUNT_AT(field, idx, n) \
+    a_sc_count_at(A_SC_COUNTER_SLOT(field), A_SC_COUNTER_LEN(field), (size_t)(idx), (uint64_t)(n))
+
+#else
+
+#define A_SC_COUNT(field)            ((void)0)
+#define A_SC_COUNT_N(field, n)       ((void)(n))
+#define A_SC_COUNT_AT(field, idx, n) ((void)(idx), (void)(n))
+
+#endif
+
+#ifdef A_SENTENCE_CHUNKER_HEADER_ONLY
+
+/*
+   Header-only builds carry no stats or trace objects: the pointers are
+   constant NULL, so every hook folds away and nothing links back to the
+   library.
+*/
+#define a_sc_tls_stats ((a_sentence_chunker_stats_t *)NULL)
+#define a_sc_tls_trace ((a_sentence_chunker_trace_t *)NULL)
+
+static inline void a_sc_stats_record_pass(a_sentence_chunker_stats_t *s, int pass,
+                                          uint64_t latency_ns, size_t input_bytes,
+                                          const a_sentence_chunk_t *chunks,
+                                          size_t num_chunks)
+{
+    (void)s; (void)pass; (void)latency_ns; (void)input_bytes; (void)chunks; (void)num_chunks;
+}
+static inline void a_sc_stats_gave_up(a_sentence_chunker_stats_t *s) { (void)s; }
+static inline void a_sc_trace_document(a_sentence_chunker_trace_t *t, int pass, size_t length) {
+    (void)t; (void)pass; (void)length;
+}
+static inline void a_sc_trace_punct_run(a_sentence_chunker_trace_t *t, size_t first, size_t last,
+                                        int rule, size_t result, size_t walked)
+{
+    (void)t; (void)first; (void)last; (void)rule; (void)result; (void)walked;
+}
+static inline void a_sc_trace_split(a_sentence_chunker_trace_t *t, size_t start, size_t length,
+                                    size_t split, size_t candidate, int heuristic, size_t walked)
+{
+    (void)t; (void)start; (void)length; (void)split; (void)candidate; (void)heuristic; (void)walked;
+}
+
+#else
+
+/*
+   Stats are a runtime opt-in: a NULL thread-local pointer costs one load
+   and a predictable branch per call.
+*/
+extern _Thread_local a_sentence_chunker_stats_t *a_sc_tls_stats;
+
+void a_sc_stats_record_pass(a_sentence_chunker_stats_t *s, int pass,
+                            uint64_t latency_ns, size_t input_bytes,
+                            const a_sentence_chunk_t *chunks, size_t num_chunks);
+void a_sc_stats_gave_up(a_sentence_chunker_stats_t *s);
+
+/* Decision traces follow the same runtime opt-in as stats. */
+extern _Thread_local a_sentence_chunker_trace_t *a_sc_tls_trace;
+
+void a_sc_trace_document(a_sentence_chunker_trace_t *t, int pass, size_t length);
+void a_sc_trace_punct_run(a_sentence_chunker_trace_t *t, size_t first, size_t last,
+                          int rule, size_t result, size_t walked);
+void a_sc_trace_split(a_sentence_chunker_trace_t *t, size_t start, size_t length,
+                      size_t split, size_t candidate, int heuristic, size_t walked);
+
+#endif
+
+#ifdef A_SENTENCE_CHUNKER_HEADER_ONLY
+static inline uint64_t a_sc_now_ns(void) {
+    return 0;
+}
+#else
+static inline uint64_t a_sc_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+#endif
+
+/*
+   USDT static tracepoints (provider "a_sentence_chunker"). With
+   A_SENTENCE_CHUNKER_USDT each probe site is a single nop plus an ELF note
+   until a tracer (bpftrace, perf, systemtap) attaches to it.
+*/
+#if defined(A_SENTENCE_CHUNKER_USDT) && defined(__has_include)
+#  if __has_include(<sys/sdt.h>)
+#    include <sys/sdt.h>
+#    define A_SC_HAVE_USDT 1
+#  endif
+#endif
+
+#ifdef A_SC_HAVE_USDT
+#define A_SC_PROBE2(name, a, b)       DTRACE_PROBE2(a_sentence_chunker, name, a, b)
+#define A_SC_PROBE3(name, a, b, c)    DTRACE_PROBE3(a_sentence_chunker, name, a, b, c)
+#define A_SC_PROBE4(name, a, b, c, d) DTRACE_PROBE4(a_sentence_chunker, name, a, b, c, d)
+#else
+#define A_SC_PROBE2(name, a, b)       ((void)(a), (void)(b))
+#define A_SC_PROBE3(name, a, b, c)    ((void)(a), (void)(b), (void)(c))
+#define A_SC_PROBE4(name, a, b, c, d) ((void)(a), (void)(b), (void)(c), (void)(d))
+#endif
+
+#endif
@@ -0,0 +1,43 @@
+// SPDX-FileCopyrightText: 2025 Andy Curtis <contactandyc@gmail.com>
+// SPDX-FileCopyrightText: 2024–2025 Knode.ai — technical questions: contact Andy (above)
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _a_sentence_chunker_internal_h
+#define _a_sentence_chunker_internal_h
+
+/*
+   Internal view of the chunker shared with the other library sources, and
+   (test-only) its heuristics. The library keeps the heuristics static;
+   compiling src/a_sentence_chunker.c with A_SENTENCE_CHUNKER_EXPOSE_INTERNALS
+   gives them external linkage so microbenchmarks and unit tests can call
+   them directly. Never install.
+*/
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "a-sentence-chunker-library/a_sentence_chunker.h"
+
+#ifdef A_SENTENCE_CHUNKER_EXPOSE_INTERNALS
+#define A_SC_INTERNAL
+
+bool matches_abbreviation(const char *text, size_t i, size_t len);
+bool is_end_of_sentence_heuristic(const char *text, size_t i, size_t len);
+size_t consume_trailing_closers(const char *text, size_t i, size_t len);
+size_t adjust_for_token_boundary(const char *text, size_t chunk_start,
+                                 size_t chunk_end, size_t candidate);
+#else
+#define A_SC_INTERNAL static inline
+#endif
+
+/* The first-pass loop, re-entrant for the stream chunker. With settle it
+   stops at the first punctuation run whose decision needs bytes past len
+   and returns its index. */
+size_t a_sc_first_pass_step(aml_buffer_t *bh, const char *text, size_t len,
+                            size_t i, size_t *start_off, size_t base, bool settle);
+
+/* External (except header-only); used by a_rechunk_sentences(). */
+A_SENTENCE_CHUNKER_API size_t find_split_point(const char *text, size_t start_offset,
+                                               size_t length, size_t min_length,
+                                               size_t max_length);
+
+#endif
@@ -0,0 +1,311 @@
+// SPDX-FileCopyrightText: 2025 Andy Curtis <contactandyc@gmail.com>
+// SPDX-FileCopyrightText: 2024–2025 Knode.ai — technical questions: contact Andy (above)
+// SPDX-License-Identifier: Apache-2.0
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "a-memory-library/aml_alloc.h"
+#include "a-sentence-chunker-library/a_sentence_chunker_lang.h"
+#include "a_sentence_chunker_lang_format.h"
+
+// ----------------------------------------------------------------------------
+//                                  LOADING
+// ----------------------------------------------------------------------------
+
+/*
+   Header and bounds checks, so lookups never leave the blob even for a
+   corrupt or hostile file. Every slot is visited once to check its string
+   range; at least one must be empty for probes to terminate.
+*/
+static bool lang_validate(const void *data, size_t len, a_sentence_chunker_lang_t *lang) {
+    const a_sc_lang_header_t *h = (const a_sc_lang_header_t *)data;
+    if (!data || len < sizeof(*h) || ((uintptr_t)data & 3) != 0) return false;
+    if (memcmp(h->magic, A_SC_LANG_MAGIC, sizeof(h->magic)) != 0 ||
+        h->version != A_SC_LANG_VERSION || h->byte_order != A_SC_LANG_BYTE_ORDER ||
+        h->size > len || memchr(h->name, 0, sizeof(h->name)) == NULL)
+    {
+        return false;
+    }
+    uint64_t slots = (uint64_t)h->slot_mask + 1;
+    if ((slots & (slots - 1)) != 0 || h->slots_offset < sizeof(*h) || (h->slots_offset & 3) != 0 ||
+        h->slots_offset + slots * sizeof(a_sc_lang_slot_t) > h->size ||
+        (uint64_t)h->strings_offset + h->strings_size > h->size)
+    {
+        return false;
+    }
+    const a_sc_lang_slot_t *s = (const a_sc_lang_slot_t *)((const char *)data + h->slots_offset);
+    uint64_t empty = 0;
+    for (uint64_t k = 0; k < slots; k++) {
+        if (s[k].length == 0) {
+            empty++;
+        } else if (s[k].length > A_SC_LANG_MAX_WORD ||
+                   (uint64_t)s[k].offset + s[k].length > h->strings_size) {
+            return false;
+        }
+    }
+    if (empty == 0) return false;
+
+    lang->h = h;
+    lang->slots = s;
+    lang->strings = (const char *)data + h->strings_offset;
+    lang->default_terminators = true;
+    for (int c = 0; c < 256; c++) {
+        bool term = (h->klass[c] & A_SC_CLASS_TERMINATOR) != 0;
+        if (term != (c == '.' || c == '?' || c == '!')) {
+            lang->default_terminators = false;
+        }
+    }
+    return true;
+}
+
+A_SENTENCE_CHUNKER_API a_sentence_chunker_lang_t *a_sentence_chunker_lang_from_memory(
+    const void *data, size_t len)
+{
+    a_sentence_chunker_lang_t probe;
+    if (!lang_validate(data, len, &probe)) {
+        return NULL;
+    }
+    a_sentence_chunker_lang_t *lang = (a_sentence_chunker_lang_t *)aml_calloc(sizeof(*lang));
+    *lang = probe;
+    return lang;
+}
+
+A_SENTENCE_CHUNKER_API a_sentence_chunker_lang_t *a_sentence_chunker_lang_load(const char *path) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return NULL;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        close(fd);
+        return NULL;
+    }
+    size_t len = (size_t)st.st_size;
+    void *map = mmap(NULL, len, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        return NULL;
+    }
+    a_sentence_chunker_lang_t *lang = a_sentence_chunker_lang_from_memory(map, len);
+    if (!lang) {
+        munmap(map, len);
+        return NULL;
+    }
+    lang->map = map;
+    lang->map_len = len;
+    return lang;
+}
+
+A_SENTENCE_CHUNKER_API void a_sentence_chunker_lang_destroy(a_sentence_chunker_lang_t *lang) {
+    if (!lang) return;
+    if (lang->map) {
+        munmap(lang->map, lang->map_len);
+    }
+    aml_free(lang);
+}
+
+A_SENTENCE_CHUNKER_API const char *a_sentence_chunker_lang_name(const a_sentence_chunker_lang_t *lang) {
+    return lang->h->name;
+}
+
+// ----------------------------------------------------------------------------
+//                                 COMPILING
+// ----------------------------------------------------------------------------
+
+typedef struct {
+    const char *p;
+    size_t n;
+    uint8_t flags;
+} lang_word_t;
+
+static inline bool lang_space(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+// Next whitespace-separated token on the line [*pos..end)
+static bool lang_token(const char *src, size_t *pos, size_t end, const char **tok, size_t *n) {
+    size_t i = *pos;
+    while (i < end && lang_space(src[i])) i++;
+    if (i >= end || src[i] == '#') {
+        *pos = end;
+        return false;
+    }
+    size_t start = i;
+    while (i < end && !lang_space(src[i])) i++;
+    *tok = src + start;
+    *n = i - start;
+    *pos = i;
+    return true;
+}
+
+static bool lang_is(const char *tok, size_t n, const char *word) {
+    return strlen(word) == n && memcmp(tok, word, n) == 0;
+}
+
+// Add a 1..4 byte sequence to a NUL-padded table
+static bool lang_add_seq(uint8_t seqs[A_SC_LANG_MAX_SEQS][4], const char *tok, size_t n) {
+    if (n == 0 || n > 4) return false;
+    for (size_t k = 0; k < A_SC_LANG_MAX_SEQS; k++) {
+        if (seqs[k][0] == 0) {
+            memcpy(seqs[k], tok, n);
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool lang_directive(a_sc_lang_header_t *h, aml_buffer_t *words,
+                           const char *dir, size_t dn,
+                           const char *src, size_t pos, size_t end,
+                           bool *seen_terminators, bool *seen_closers)
+{
+    const char *tok;
+    size_t n;
+    if (lang_is(dir, dn, "name")) {
+        if (!lang_token(src, &pos, end, &tok, &n) || n >= sizeof(h->name)) return false;
+        memset(h->name, 0, sizeof(h->name));
+        memcpy(h->name, tok, n);
+    } else if (lang_is(dir, dn, "terminators")) {
+        if (!*seen_terminators) {
+            for (int c = 0; c < 256; c++) h->klass[c] &= (uint8_t)~A_SC_CLASS_TERMINATOR;
+            *seen_terminators = true;
+        }
+        while (lang_token(src, &pos, end, &tok, &n)) {
+            for (size_t k = 0; k < n; k++) {
+                if ((uint8_t)tok[k] >= 0x80) return false; // ASCII only
+                h->klass[(uint8_t)tok[k]] |= A_SC_CLASS_TERMINATOR;
+            }
+        }
+    } else if (lang_is(dir, dn, "closers")) {
+        if (!*seen_closers) {
+            for (int c = 0; c < 256; c++) h->klass[c] &= (uint8_t)~A_SC_CLASS_CLOSER;
+            *seen_closers = true;
+        }
+        while (lang_token(src, &pos, end, &tok, &n)) {
+            if (n == 1 && (uint8_t)tok[0] < 0x80) {
+                h->klass[(uint8_t)tok[0]] |= A_SC_CLASS_CLOSER;
+            } else if ((uint8_t)tok[0] < 0x80 || !lang_add_seq(h->closers, tok, n)) {
+                return false;
+            }
+        }
+    } else if (lang_is(dir, dn, "spaced_closers")) {
+        if (!lang_token(src, &pos, end, &tok, &n)) return false;
+        if (lang_is(tok, n, "yes")) h->flags |= A_SC_LANG_SPACED_CLOSERS;
+        else if (lang_is(tok, n, "no")) h->flags &= ~(uint32_t)A_SC_LANG_SPACED_CLOSERS;
+        else return false;
+    } else if (lang_is(dir, dn, "ordinal_next")) {
+        h->ordinal_next = 0;
+        while (lang_token(src, &pos, end, &tok, &n)) {
+            if (lang_is(tok, n, "digit")) h->ordinal_next |= A_SC_ORDINAL_DIGIT;
+            else if (lang_is(tok, n, "lower")) h->ordinal_next |= A_SC_ORDINAL_LOWER;
+            else if (lang_is(tok, n, "upper")) h->ordinal_next |= A_SC_ORDINAL_UPPER;
+            else if (!lang_is(tok, n, "none")) return false;
+        }
+    } else if (lang_is(dir, dn, "ordinal_max_digits")) {
+        if (!lang_token(src, &pos, end, &tok, &n) || n > 3) return false;
+        uint32_t v = 0;
+        for (size_t k = 0; k < n; k++) {
+            if (tok[k] < '0' || tok[k] > '9') return false;
+            v = v * 10 + (uint32_t)(tok[k] - '0');
+        }
+        h->ordinal_max_digits = v;
+    } else if (lang_is(dir, dn, "ordinal_marks")) {
+        while (lang_token(src, &pos, end, &tok, &n)) {
+            if (!lang_add_seq(h->ordinal_marks, tok, n)) return false;
+        }
+    } else if (lang_is(dir, dn, "abbrev") || lang_is(dir, dn, "abbrev_exact")) {
+        uint8_t flags = lang_is(dir, dn, "abbrev_exact") ? A_SC_ABBREV_EXACT : 0;
+        while (lang_token(src, &pos, end, &tok, &n)) {
+            lang_word_t w = { tok, n, flags };
+            if (n > 1 && tok[n - 1] == '*') {
+                w.n--;
+                w.flags |= A_SC_ABBREV_MAY_END;
+            }
+            if (w.n == 0 || w.n > A_SC_LANG_MAX_WORD) return false;
+            aml_buffer_append(words, &w, sizeof(w));
+        }
+    } else {
+        return false;
+    }
+    return true;
+}
+
+A_SENTENCE_CHUNKER_API bool a_sentence_chunker_lang_compile(aml_buffer_t *out,
+                                                            const char *source,
+                                                            size_t len,
+                                                            size_t *error_line)
+{
+    // Defaults are the built-in rules, minus the abbreviation list
+    a_sc_lang_header_t h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, A_SC_LANG_MAGIC, sizeof(h.magic));
+    h.version = A_SC_LANG_VERSION;
+    h.byte_order = A_SC_LANG_BYTE_ORDER;
+    h.klass['.'] = h.klass['?'] = h.klass['!'] = A_SC_CLASS_TERMINATOR;
+    h.klass['"'] = h.klass['\''] = h.klass[')'] = h.klass[']'] = h.klass['}'] = A_SC_CLASS_CLOSER;
+    h.ordinal_next = A_SC_ORDINAL_DIGIT | A_SC_ORDINAL_LOWER;
+
+    aml_buffer_clear(out);
+    *error_line = 0;
+    aml_buffer_t *words = aml_buffer_init(256 * sizeof(lang_word_t));
+    bool seen_terminators = false, seen_closers = false;
+    size_t line = 0;
+    for (size_t pos = 0; pos < len; line++) {
+        const char *nl = memchr(source + pos, '\n', len - pos);
+        size_t end = nl ? (size_t)(nl - source) : len;
+        const char *dir;
+        size_t dn;
+        size_t p = pos;
+        if (lang_token(source, &p, end, &dir, &dn) &&
+            !lang_directive(&h, words, dir, dn, source, p, end,
+                            &seen_terminators, &seen_closers))
+        {
+            *error_line = line + 1;
+            aml_buffer_destroy(words);
+            return false;
+        }
+        pos = end + 1;
+    }
+
+    const lang_word_t *w = (const lang_word_t *)aml_buffer_data(words);
+    size_t count = aml_buffer_length(words) / sizeof(lang_word_t);
+    size_t slots = 16;
+    while (slots < 2 * count) slots <<= 1;
+    size_t strings = 0;
+    for (size_t k = 0; k < count; k++) strings += w[k].n;
+
+    h.slot_mask = (uint32_t)(slots - 1);
+    h.abbrev_count = (uint32_t)count;
+    h.slots_offset = (uint32_t)sizeof(h);
+    h.strings_offset = (uint32_t)(sizeof(h) + slots * sizeof(a_sc_lang_slot_t));
+    h.strings_size = (uint32_t)strings;
+    h.size = (uint32_t)((h.strings_offset + strings + 3) & ~(size_t)3);
+
+    aml_buffer_resize(out, h.size);
+    char *blob = aml_buffer_data(out);
+    memset(blob, 0, h.size);
+    memcpy(blob, &h, sizeof(h));
+    a_sc_lang_slot_t *table = (a_sc_lang_slot_t *)(blob + h.slots_offset);
+    char *str = blob + h.strings_offset;
+    size_t at = 0;
+    for (size_t k = 0; k < count; k++) {
+        uint32_t hash = a_sc_lang_hash(w[k].p, w[k].n);
+        size_t slot = hash & h.slot_mask;
+        while (table[slot].length) slot = (slot + 1) & h.slot_mask;
+        table[slot].hash = hash;
+        table[slot].offset = (uint32_t)at;
+        table[slot].length = (uint8_t)w[k].n;
+        table[slot].flags = w[k].flags;
+        for (size_t j = 0; j < w[k].n; j++) {
+            uint8_t c = (uint8_t)w[k].p[j];
+            str[at++] = (char)((w[k].flags & A_SC_ABBREV_EXACT) ? c : a_sc_lang_fold(c));
+        }
+    }
+    aml_buffer_destroy(words);
+    return true;
+}
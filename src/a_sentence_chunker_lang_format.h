@@ -0,0 +1,153 @@
+// SPDX-FileCopyrightText: 2025 Andy Curtis <contactandyc@gmail.com>
+// SPDX-FileCopyrightText: 2024–2025 Knode.ai — technical questions: contact Andy (above)
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _a_sentence_chunker_lang_format_h
+#define _a_sentence_chunker_lang_format_h
+
+/*
+   Binary layout of a compiled language pack. A pack is used exactly as it
+   sits in memory (mapped file, embedded array, shared memory), so every
+   field is fixed-size, native-endian and 4-byte aligned:
+
+     a_sc_lang_header_t
+     a_sc_lang_slot_t[slot_mask + 1]   open-addressing abbreviation table
+     char strings[strings_size]        abbreviation bytes, not terminated
+
+   Loading validates the header and slot bounds once; lookups then read the
+   tables directly.
+*/
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "a-sentence-chunker-library/a_sentence_chunker_lang.h"
+
+#define A_SC_LANG_MAGIC      "ASCLANG"
+#define A_SC_LANG_VERSION    1
+#define A_SC_LANG_BYTE_ORDER 0x01020304u
+#define A_SC_LANG_MAX_SEQS   8   // multi-byte closers / ordinal marks
+#define A_SC_LANG_MAX_WORD   31  // longest abbreviation the rules look up
+
+// klass[] bits
+enum {
+    A_SC_CLASS_TERMINATOR = 1,   // ends a sentence ('.', '?', '!')
+    A_SC_CLASS_CLOSER = 2        // trails a terminator ('"', ')', ...)
+};
+
+// ordinal_next bits: what may follow "<digits>." for it to be an ordinal
+enum {
+    A_SC_ORDINAL_DIGIT = 1,
+    A_SC_ORDINAL_LOWER = 2,
+    A_SC_ORDINAL_UPPER = 4
+};
+
+// header flags
+enum {
+    A_SC_LANG_SPACED_CLOSERS = 1 // closers may follow spaces/NBSP (« ... »)
+};
+
+// slot flags
+enum {
+    A_SC_ABBREV_MAY_END = 1,     // a boundary when the next word is capitalized
+    A_SC_ABBREV_EXACT = 2        // case-sensitive match
+};
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    uint32_t size;               // total bytes, header included
+    uint32_t flags;
+    char name[16];
+    uint8_t klass[256];
+    uint8_t closers[A_SC_LANG_MAX_SEQS][4];       // UTF-8, NUL padded
+    uint8_t ordinal_marks[A_SC_LANG_MAX_SEQS][4]; // "º", "ª" after "1."
+    uint32_t ordinal_next;
+    uint32_t ordinal_max_digits; // 0 = any length
+    uint32_t slot_mask;          // slots - 1, slots a power of two
+    uint32_t abbrev_count;
+    uint32_t slots_offset;
+    uint32_t strings_offset;
+    uint32_t strings_size;
+    uint32_t reserved;
+} a_sc_lang_header_t;
+
+typedef struct {
+    uint32_t hash;               // a_sc_lang_hash() of the folded word
+    uint32_t offset;             // into strings
+    uint8_t length;              // 0 = empty slot
+    uint8_t flags;
+    uint16_t reserved;
+} a_sc_lang_slot_t;
+
+struct a_sentence_chunker_lang_s {
+    const a_sc_lang_header_t *h;
+    const a_sc_lang_slot_t *slots;
+    const char *strings;
+    bool default_terminators;    // exactly ".?!": the SIMD scan applies
+    void *map;                   // owned mapping, or NULL
+    size_t map_len;
+};
+
+static inline uint8_t a_sc_lang_fold(uint8_t c) {
+    return (c >= 'A' && c <= 'Z') ? (uint8_t)(c + 32) : c;
+}
+
+// FNV-1a over ASCII-lowercased bytes
+static inline uint32_t a_sc_lang_hash(const char *w, size_t n) {
+    uint32_t h = 2166136261u;
+    for (size_t k = 0; k < n; k++) {
+        h ^= a_sc_lang_fold((uint8_t)w[k]);
+        h *= 16777619u;
+    }
+    return h;
+}
+
+/* The slot matching w[0..n), or NULL. Stored case-insensitive words are
+   already folded. */
+static inline const a_sc_lang_slot_t *a_sc_lang_lookup(const a_sentence_chunker_lang_t *lang,
+                                                       const char *w, size_t n)
+{
+    uint32_t hash = a_sc_lang_hash(w, n);
+    uint32_t mask = lang->h->slot_mask;
+    for (uint32_t k = hash & mask;; k = (k + 1) & mask) {
+        const a_sc_lang_slot_t *s = lang->slots + k;
+        if (s->length == 0) {
+            return NULL;
+        }
+        if (s->hash != hash || s->length != n) {
+            continue;
+        }
+        const char *stored = lang->strings + s->offset;
+        if (s->flags & A_SC_ABBREV_EXACT) {
+            if (memcmp(stored, w, n) == 0) return s;
+            continue;
+        }
+        size_t j = 0;
+        while (j < n && (uint8_t)stored[j] == a_sc_lang_fold((uint8_t)w[j])) {
+            j++;
+        }
+        if (j == n) {
+            return s;
+        }
+    }
+}
+
+/* Length of the sequence from seqs[] starting at text[i], or 0. */
+static inline size_t a_sc_lang_match_seq(const uint8_t seqs[A_SC_LANG_MAX_SEQS][4],
+                                         const char *text, size_t i, size_t len)
+{
+    for (size_t k = 0; k < A_SC_LANG_MAX_SEQS && seqs[k][0]; k++) {
+        size_t n = 1;
+        while (n < 4 && seqs[k][n]) n++;
+        if (i + n <= len && memcmp(text + i, seqs[k], n) == 0) {
+            return n;
+        }
+    }
+    return 0;
+}
+
+#endif
@@ -0,0 +1,164 @@
+// SPDX-FileCopyrightText: 2025 Andy Curtis <contactandyc@gmail.com>
+// SPDX-FileCopyrightText: 2024–2025 Knode.ai — technical questions: contact Andy (above)
+// SPDX-License-Identifier: Apache-2.0
+
+#include <stdbool.h>
+#include <string.h>
+
+#include "a-sentence-chunker-library/a_sentence_chunker.h"
+#include "a_sentence_chunker_scan.h"
+
+#ifdef A_SENTENCE_CHUNKER_DISPATCH
+
+/*
+   Each SIMD kernel compares a block against '.', '?' and '!', ORs the
+   three masks and jumps to the lowest set bit; the tail shorter than one
+   block falls back to the scalar loop. Kernels are compiled with target
+   attributes, so the rest of the library stays at the baseline ISA.
+*/
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define A_SC_HAVE_X86_KERNELS 1
+#include <immintrin.h>
+
+static size_t scan_punct_sse2(const char *text, size_t from, size_t len) {
+    const __m128i dot = _mm_set1_epi8('.');
+    const __m128i question = _mm_set1_epi8('?');
+    const __m128i bang = _mm_set1_epi8('!');
+    size_t i = from;
+    while (i + 16 <= len) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(text + i));
+        __m128i hit = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, dot),
+                                                _mm_cmpeq_epi8(v, question)),
+                                   _mm_cmpeq_epi8(v, bang));
+        unsigned mask = (unsigned)_mm_movemask_epi8(hit);
+        if (mask) return i + (size_t)__builtin_ctz(mask);
+        i += 16;
+    }
+    return a_sc_scan_punct_scalar(text, i, len);
+}
+
+__attribute__((target("avx2")))
+static size_t scan_punct_avx2(const char *text, size_t from, size_t len) {
+    const __m256i dot = _mm256_set1_epi8('.');
+    const __m256i question = _mm256_set1_epi8('?');
+    const __m256i bang = _mm256_set1_epi8('!');
+    size_t i = from;
+    while (i + 32 <= len) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)(text + i));
+        __m256i hit = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, dot),
+                                                      _mm256_cmpeq_epi8(v, question)),
+                                      _mm256_cmpeq_epi8(v, bang));
+        unsigned mask = (unsigned)_mm256_movemask_epi8(hit);
+        if (mask) return i + (size_t)__builtin_ctz(mask);
+        i += 32;
+    }
+    return scan_punct_sse2(text, i, len);
+}
+
+__attribute__((target("avx512f,avx512bw")))
+static size_t scan_punct_avx512bw(const char *text, size_t from, size_t len) {
+    const __m512i dot = _mm512_set1_epi8('.');
+    const __m512i question = _mm512_set1_epi8('?');
+    const __m512i bang = _mm512_set1_epi8('!');
+    size_t i = from;
+    while (i + 64 <= len) {
+        __m512i v = _mm512_loadu_si512((const void *)(text + i));
+        __mmask64 mask = _mm512_cmpeq_epi8_mask(v, dot) |
+                         _mm512_cmpeq_epi8_mask(v, question) |
+                         _mm512_cmpeq_epi8_mask(v, bang);
+        if (mask) return i + (size_t)__builtin_ctzll(mask);
+        i += 64;
+    }
+    return scan_punct_sse2(text, i, len);
+}
+#endif
+
+static size_t scan_punct_scalar(const char *text, size_t from, size_t len) {
+    return a_sc_scan_punct_scalar(text, from, len);
+}
+
+typedef struct {
+    const char *name;
+    a_sc_scan_fn_t fn;
+    bool (*supported)(void);
+} kernel_t;
+
+static bool always(void) {
+    return true;
+}
+
+#ifdef A_SC_HAVE_X86_KERNELS
+static bool has_avx2(void) {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+}
+
+static bool has_avx512bw(void) {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx512bw");
+}
+#endif
+
+/* Best first */
+static const kernel_t KERNELS[] = {
+#ifdef A_SC_HAVE_X86_KERNELS
+    { "avx512bw", scan_punct_avx512bw, has_avx512bw },
+    { "avx2", scan_punct_avx2, has_avx2 },
+    { "sse2", scan_punct_sse2, always },
+#endif
+    { "scalar", scan_punct_scalar, always }
+};
+#define NUM_KERNELS (sizeof(KERNELS) / sizeof(KERNELS[0]))
+
+static _Atomic(const kernel_t *) selected = NULL;
+
+static const kernel_t *best_kernel(void) {
+    for (size_t k = 0; k < NUM_KERNELS; k++) {
+        if (KERNELS[k].supported()) return &KERNELS[k];
+    }
+    return &KERNELS[NUM_KERNELS - 1];
+}
+
+/* First call from any thread picks the kernel; racing callers pick the
+   same one, so relaxed stores are enough. */
+static size_t scan_punct_resolve(const char *text, size_t from, size_t len) {
+    const kernel_t *k = best_kernel();
+    atomic_store_explicit(&selected, k, memory_order_relaxed);
+    atomic_store_explicit(&a_sc_scan_punct_fn, k->fn, memory_order_relaxed);
+    return k->fn(text, from, len);
+}
+
+_Atomic(a_sc_scan_fn_t) a_sc_scan_punct_fn = scan_punct_resolve;
+
+const char *a_sentence_chunker_kernel(void) {
+    const kernel_t *k = atomic_load_explicit(&selected, memory_order_relaxed);
+    if (!k) {
+        k = best_kernel();
+        atomic_store_explicit(&selected, k, memory_order_relaxed);
+        atomic_store_explicit(&a_sc_scan_punct_fn, k->fn, memory_order_relaxed);
+    }
+    return k->name;
+}
+
+bool a_sentence_chunker_kernel_select(const char *name) {
+    for (size_t k = 0; k < NUM_KERNELS; k++) {
+        if (!strcmp(KERNELS[k].name, name) && KERNELS[k].supported()) {
+            atomic_store_explicit(&selected, &KERNELS[k], memory_order_relaxed);
+            atomic_store_explicit(&a_sc_scan_punct_fn, KERNELS[k].fn, memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+#else
+
+A_SENTENCE_CHUNKER_API const char *a_sentence_chunker_kernel(void) {
+    return "scalar";
+}
+
+A_SENTENCE_CHUNKER_API bool a_sentence_chunker_kernel_select(const char *name) {
+    return !strcmp(name, "scalar");
+}
+
+#endif
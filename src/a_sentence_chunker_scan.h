@@ -0,0 +1,53 @@
+// SPDX-FileCopyrightText: 2025 Andy Curtis <contactandyc@gmail.com>
+// SPDX-FileCopyrightText: 2024–2025 Knode.ai — technical questions: contact Andy (above)
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _a_sentence_chunker_scan_h
+#define _a_sentence_chunker_scan_h
+
+/*
+   Private scan kernels. a_sc_scan_punct() returns the index of the first
+   '.', '?' or '!' in text[from..len), or len if there is none.
+
+   The `fast` variant (A_SENTENCE_CHUNKER_DISPATCH) calls through a pointer
+   that resolves to the widest SIMD kernel the CPU supports on first use;
+   every other variant inlines the scalar loop.
+*/
+
+#include <stddef.h>
+
+/* Header-only builds always use the inlined scalar loop */
+#ifdef A_SENTENCE_CHUNKER_HEADER_ONLY
+#undef A_SENTENCE_CHUNKER_DISPATCH
+#endif
+
+typedef size_t (*a_sc_scan_fn_t)(const char *text, size_t from, size_t len);
+
+static inline size_t a_sc_scan_punct_scalar(const char *text, size_t from, size_t len) {
+    size_t i = from;
+    while (i < len && text[i] != '.' && text[i] != '?' && text[i] != '!') {
+        i++;
+    }
+    return i;
+}
+
+#ifdef A_SENTENCE_CHUNKER_DISPATCH
+
+#include <stdatomic.h>
+
+extern _Atomic(a_sc_scan_fn_t) a_sc_scan_punct_fn;
+
+static inline size_t a_sc_scan_punct(const char *text, size_t from, size_t len) {
+    a_sc_scan_fn_t fn = atomic_load_explicit(&a_sc_scan_punct_fn, memory_order_relaxed);
+    return fn(text, from, len);
+}
+
+#else
+
+static inline size_t a_sc_scan_punct(const char *text, size_t from, size_t len) {
+    return a_sc_scan_punct_scalar(text, from, len);
+}
+
+#endif
+
+#endif
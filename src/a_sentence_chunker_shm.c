@@ -0,0 +1,459 @@
+// SPDX-FileCopyrightText: 2025 Andy Curtis <contactandyc@gmail.com>
+// SPDX-FileCopyrightText: 2024–2025 Knode.ai — technical questions: contact Andy (above)
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE // memfd_create, F_ADD_SEALS
+#endif
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+#include "a-memory-library/aml_alloc.h"
+#include "a-sentence-chunker-library/a_sentence_chunker_shm.h"
+
+// ----------------------------------------------------------------------------
+//                          HELPER FUNCTIONS
+// ----------------------------------------------------------------------------
+
+static size_t page_round(size_t n) {
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    return (n + page - 1) & ~(page - 1);
+}
+
+static bool write_all(int fd, const void *data, size_t len) {
+    const char *p = (const char *)data;
+    while (len) {
+        ssize_t n = send(fd, p, len, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        p += n;
+        len -= (size_t)n;
+    }
+    return true;
+}
+
+/*
+   read_message: Read exactly len bytes, picking up an SCM_RIGHTS fd if one
+   rides along with the first segment. Returns 1 on success, 0 on EOF before
+   any byte, -1 on error.
+*/
+static int read_message(int sock, void *data, size_t len, int *fd_out) {
+    char *p = (char *)data;
+    size_t got = 0;
+    while (got < len) {
+        struct iovec iov = { p + got, len - got };
+        union {
+            char buf[CMSG_SPACE(sizeof(int))];
+            struct cmsghdr align;
+        } control;
+        struct msghdr msg;
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+        msg.msg_control = control.buf;
+        msg.msg_controllen = sizeof(control.buf);
+
+        ssize_t n = recvmsg(sock, &msg, MSG_CMSG_CLOEXEC);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        if (n == 0) {
+            return got == 0 ? 0 : -1;
+        }
+        for (struct cmsghdr *c = CMSG_FIRSTHDR(&msg); c; c = CMSG_NXTHDR(&msg, c)) {
+            if (c->cmsg_level == SOL_SOCKET && c->cmsg_type == SCM_RIGHTS) {
+                int fd;
+                memcpy(&fd, CMSG_DATA(c), sizeof(fd));
+                if (fd_out && *fd_out < 0) *fd_out = fd;
+                else close(fd);
+            }
+        }
+        got += (size_t)n;
+    }
+    return 1;
+}
+
+static bool send_with_fd(int sock, const void *data, size_t len, int fd) {
+    if (fd < 0) {
+        return write_all(sock, data, len);
+    }
+    struct iovec iov = { (void *)data, len };
+    union {
+        char buf[CMSG_SPACE(sizeof(int))];
+        struct cmsghdr align;
+    } control;
+    memset(&control, 0, sizeof(control));
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control.buf;
+    msg.msg_controllen = sizeof(control.buf);
+
+    struct cmsghdr *c = CMSG_FIRSTHDR(&msg);
+    c->cmsg_level = SOL_SOCKET;
+    c->cmsg_type = SCM_RIGHTS;
+    c->cmsg_len = CMSG_LEN(sizeof(int));
+    memcpy(CMSG_DATA(c), &fd, sizeof(fd));
+
+    ssize_t n;
+    do {
+        n = sendmsg(sock, &msg, MSG_NOSIGNAL);
+    } while (n < 0 && errno == EINTR);
+    if (n < 0) return false;
+    // Any remainder goes without the fd
+    return write_all(sock, (const char *)data + n, len - (size_t)n);
+}
+
+// ----------------------------------------------------------------------------
+//                                 CLIENT
+// ----------------------------------------------------------------------------
+
+struct a_sentence_chunker_shm_s {
+    int fd;
+    char *base;
+    size_t size;
+    a_sentence_chunker_shm_header_t *header;
+    // Connection the fd was last handed to, by socket inode: fd numbers are
+    // reused after close, inodes are not (sent_ino 0: none)
+    dev_t sent_dev;
+    ino_t sent_ino;
+};
+
+static bool socket_id(int sock, dev_t *dev, ino_t *ino) {
+    struct stat st;
+    if (fstat(sock, &st) != 0) return false;
+    *dev = st.st_dev;
+    *ino = st.st_ino;
+    return true;
+}
+
+static bool shm_map(a_sentence_chunker_shm_t *h, size_t text_capacity,
+                    size_t chunk_capacity)
+{
+    size_t text_offset = page_round(sizeof(a_sentence_chunker_shm_header_t));
+    size_t response_offset = text_offset + page_round(text_capacity ? text_capacity : 1);
+    size_t size = response_offset +
+                  page_round((chunk_capacity ? chunk_capacity : 1) * sizeof(a_sentence_chunk_t));
+
+    if (ftruncate(h->fd, (off_t)size) != 0) {
+        return false;
+    }
+    char *base = (char *)mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, h->fd, 0);
+    if (base == MAP_FAILED) {
+        return false;
+    }
+    if (h->base) {
+        munmap(h->base, h->size);
+    }
+    h->base = base;
+    h->size = size;
+    h->header = (a_sentence_chunker_shm_header_t *)base;
+    h->header->magic = A_SENTENCE_CHUNKER_SHM_MAGIC;
+    h->header->text_offset = text_offset;
+    h->header->text_capacity = response_offset - text_offset;
+    h->header->response_offset = response_offset;
+    h->header->response_capacity = (size - response_offset) / sizeof(a_sentence_chunk_t);
+    return true;
+}
+
+a_sentence_chunker_shm_t *a_sentence_chunker_shm_init(size_t text_capacity,
+                                                      size_t chunk_capacity)
+{
+    a_sentence_chunker_shm_t *h =
+        (a_sentence_chunker_shm_t *)aml_calloc(sizeof(a_sentence_chunker_shm_t));
+    // The server maps what we send; sealed, the segment can grow but never shrink
+    h->fd = memfd_create("a_sentence_chunker", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if (h->fd < 0 || fcntl(h->fd, F_ADD_SEALS, F_SEAL_SHRINK) != 0 ||
+        !shm_map(h, text_capacity, chunk_capacity))
+    {
+        a_sentence_chunker_shm_destroy(h);
+        return NULL;
+    }
+    return h;
+}
+
+void a_sentence_chunker_shm_destroy(a_sentence_chunker_shm_t *h) {
+    if (!h) return;
+    if (h->base) munmap(h->base, h->size);
+    if (h->fd >= 0) close(h->fd);
+    aml_free(h);
+}
+
+char *a_sentence_chunker_shm_text(a_sentence_chunker_shm_t *h) {
+    return h->base + h->header->text_offset;
+}
+
+size_t a_sentence_chunker_shm_text_capacity(a_sentence_chunker_shm_t *h) {
+    return (size_t)h->header->text_capacity;
+}
+
+int a_sentence_chunker_shm_connect(const char *path) {
+    struct sockaddr_un addr;
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        return -1;
+    }
+    int sock = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (sock < 0) {
+        return -1;
+    }
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, path);
+    if (connect(sock, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+        close(sock);
+        return -1;
+    }
+    return sock;
+}
+
+a_sentence_chunk_t *a_sentence_chunker_shm_request(
+    size_t *num,
+    a_sentence_chunker_shm_t *h,
+    int sock,
+    size_t text_length,
+    size_t min_length,
+    size_t max_length)
+{
+    *num = 0;
+    if (text_length == 0 || text_length > h->header->text_capacity) {
+        return NULL;
+    }
+
+    dev_t dev;
+    ino_t ino;
+    if (!socket_id(sock, &dev, &ino)) {
+        return NULL;
+    }
+
+    // The first ETOOSMALL reply tells us the exact size; ENOSEG means the
+    // server has no segment for this connection, so send the fd again
+    for (int attempt = 0; attempt < 3; attempt++) {
+        a_sentence_chunker_shm_request_t req;
+        req.segment_size = h->size;
+        req.text_length = text_length;
+        req.min_length = min_length;
+        req.max_length = max_length;
+
+        bool sent = h->sent_ino == ino && h->sent_dev == dev;
+        if (!send_with_fd(sock, &req, sizeof(req), sent ? -1 : h->fd)) {
+            return NULL;
+        }
+        h->sent_dev = dev;
+        h->sent_ino = ino;
+
+        a_sentence_chunker_shm_reply_t reply;
+        if (read_message(sock, &reply, sizeof(reply), NULL) != 1) {
+            return NULL;
+        }
+        if (reply.status == A_SENTENCE_CHUNKER_SHM_OK) {
+            if (reply.num_chunks == 0) {
+                return NULL;
+            }
+            *num = (size_t)reply.num_chunks;
+            return (a_sentence_chunk_t *)(h->base + h->header->response_offset);
+        }
+        if (reply.status == A_SENTENCE_CHUNKER_SHM_ENOSEG && sent) {
+            h->sent_ino = 0;
+            continue;
+        }
+        if (reply.status != A_SENTENCE_CHUNKER_SHM_ETOOSMALL ||
+            !shm_map(h, (size_t)h->header->text_capacity, (size_t)reply.num_chunks))
+        {
+            return NULL;
+        }
+    }
+    return NULL;
+}
+
+// ----------------------------------------------------------------------------
+//                                 SERVER
+// ----------------------------------------------------------------------------
+
+int a_sentence_chunker_shm_listen(const char *path) {
+    struct sockaddr_un addr;
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        return -1;
+    }
+    int sock = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (sock < 0) {
+        return -1;
+    }
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, path);
+    unlink(path);
+    if (bind(sock, (struct sockaddr *)&addr, sizeof(addr)) != 0 ||
+        listen(sock, SOMAXCONN) != 0)
+    {
+        close(sock);
+        return -1;
+    }
+    return sock;
+}
+
+typedef struct {
+    int fd;
+    char *base;
+    size_t size;
+    aml_buffer_t *first;
+    aml_buffer_t *second;
+} shm_session_t;
+
+static void session_unmap(shm_session_t *s) {
+    if (s->base) munmap(s->base, s->size);
+    s->base = NULL;
+    s->size = 0;
+}
+
+/*
+   segment_sealed: True when fd can never shrink under a mapping (a
+   segment the client truncates after the handshake would SIGBUS us).
+*/
+static bool segment_sealed(int fd) {
+    int seals = fcntl(fd, F_GET_SEALS);
+    return seals >= 0 && (seals & F_SEAL_SHRINK);
+}
+
+/*
+   handle_request: Chunk the client's document where it lies and copy only
+   the resulting spans into the response region. No size the client sends
+   is trusted: the mapping is checked against the segment's real size.
+*/
+static a_sentence_chunker_shm_reply_t handle_request(shm_session_t *s,
+                                                     const a_sentence_chunker_shm_request_t *req)
+{
+    a_sentence_chunker_shm_reply_t reply;
+    memset(&reply, 0, sizeof(reply));
+
+    if (s->fd < 0) {
+        reply.status = A_SENTENCE_CHUNKER_SHM_ENOSEG;
+        return reply;
+    }
+    // The client grows the segment in place; follow it
+    if (!s->base || s->size != req->segment_size) {
+        session_unmap(s);
+        struct stat st;
+        if (fstat(s->fd, &st) != 0 || req->segment_size == 0 ||
+            req->segment_size > (uint64_t)st.st_size)
+        {
+            reply.status = A_SENTENCE_CHUNKER_SHM_EINVAL;
+            return reply;
+        }
+        void *base = mmap(NULL, (size_t)req->segment_size, PROT_READ | PROT_WRITE,
+                          MAP_SHARED, s->fd, 0);
+        if (base == MAP_FAILED) {
+            reply.status = A_SENTENCE_CHUNKER_SHM_EINVAL;
+            return reply;
+        }
+        s->base = (char *)base;
+        s->size = (size_t)req->segment_size;
+    }
+
+    // The client can rewrite the header at any time: read each field exactly
+    // once (volatile, so the compiler cannot reload it), then validate and
+    // use only the copy
+    a_sentence_chunker_shm_header_t hdr;
+    if (s->size < sizeof(hdr)) {
+        reply.status = A_SENTENCE_CHUNKER_SHM_EINVAL;
+        return reply;
+    }
+    const volatile a_sentence_chunker_shm_header_t *shared =
+        (const volatile a_sentence_chunker_shm_header_t *)s->base;
+    hdr.magic = shared->magic;
+    hdr.text_offset = shared->text_offset;
+    hdr.text_capacity = shared->text_capacity;
+    hdr.response_offset = shared->response_offset;
+    hdr.response_capacity = shared->response_capacity;
+    if (hdr.magic != A_SENTENCE_CHUNKER_SHM_MAGIC ||
+        hdr.text_offset > s->size ||
+        req->text_length > hdr.text_capacity ||
+        hdr.text_capacity > s->size - hdr.text_offset ||
+        hdr.response_offset > s->size ||
+        hdr.response_capacity > (s->size - hdr.response_offset) / sizeof(a_sentence_chunk_t))
+    {
+        reply.status = A_SENTENCE_CHUNKER_SHM_EINVAL;
+        return reply;
+    }
+
+    const char *text = s->base + hdr.text_offset;
+    size_t n = 0;
+    a_sentence_chunk_t *chunks =
+        a_sentence_chunker_len(&n, s->first, text, (size_t)req->text_length);
+    if (req->max_length && n) {
+        chunks = a_rechunk_sentences(&n, s->second, text, chunks, n,
+                                     (size_t)req->min_length, (size_t)req->max_length);
+    }
+
+    reply.num_chunks = n;
+    if (n > hdr.response_capacity) {
+        reply.status = A_SENTENCE_CHUNKER_SHM_ETOOSMALL;
+        return reply;
+    }
+    if (n) {
+        memcpy(s->base + hdr.response_offset, chunks, n * sizeof(a_sentence_chunk_t));
+    }
+    reply.status = A_SENTENCE_CHUNKER_SHM_OK;
+    return reply;
+}
+
+int a_sentence_chunker_shm_serve(int conn_fd) {
+    shm_session_t s;
+    memset(&s, 0, sizeof(s));
+    s.fd = -1;
+    s.first = aml_buffer_init(4096);
+    s.second = aml_buffer_init(4096);
+
+    int rc = 0;
+    while (true) {
+        a_sentence_chunker_shm_request_t req;
+        int fd = -1;
+        int r = read_message(conn_fd, &req, sizeof(req), &fd);
+        if (r <= 0) {
+            if (fd >= 0) close(fd);
+            rc = r;
+            break;
+        }
+        bool refused = false;
+        if (fd >= 0) {
+            // A new segment replaces the old one
+            session_unmap(&s);
+            if (s.fd >= 0) close(s.fd);
+            s.fd = fd;
+            if (!segment_sealed(fd)) {
+                close(fd);
+                s.fd = -1;
+                refused = true;
+            }
+        }
+        a_sentence_chunker_shm_reply_t reply;
+        if (refused) {
+            memset(&reply, 0, sizeof(reply));
+            reply.status = A_SENTENCE_CHUNKER_SHM_EINVAL;
+        } else {
+            reply = handle_request(&s, &req);
+        }
+        if (!write_all(conn_fd, &reply, sizeof(reply))) {
+            rc = -1;
+            break;
+        }
+    }
+
+    session_unmap(&s);
+    if (s.fd >= 0) close(s.fd);
+    aml_buffer_destroy(s.first);
+    aml_buffer_destroy(s.second);
+    return rc;
+}
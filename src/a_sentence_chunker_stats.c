@@ -0,0 +1,228 @@
+// SPDX-FileCopyrightText: 2025 Andy Curtis <contactandyc@gmail.com>
+// SPDX-FileCopyrightText: 2024–2025 Knode.ai — technical questions: contact Andy (above)
+// SPDX-License-Identifier: Apache-2.0
+
+#include <stdatomic.h>
+#include <string.h>
+
+#include "a-memory-library/aml_alloc.h"
+#include "a-sentence-chunker-library/a_sentence_chunker_stats.h"
+#include "a_sentence_chunker_instrument.h"
+
+/*
+   The object mirrors a_sentence_chunker_stats_snapshot_t slot for slot, but
+   with atomic slots so a snapshot from another thread never tears a value.
+   The owning thread updates with relaxed load/store pairs (plain moves on
+   every mainstream ISA). A histogram's min is stored inverted so that a
+   zeroed object means "no samples".
+*/
+#define STATS_SLOTS (sizeof(a_sentence_chunker_stats_snapshot_t) / sizeof(uint64_t))
+#define HIST_SLOTS  (sizeof(a_sentence_chunker_histogram_t) / sizeof(uint64_t))
+#define SLOT(field) (offsetof(a_sentence_chunker_stats_snapshot_t, field) / sizeof(uint64_t))
+#define HIST_FIELD(field) (offsetof(a_sentence_chunker_histogram_t, field) / sizeof(uint64_t))
+
+struct a_sentence_chunker_stats_s {
+    _Atomic uint64_t v[STATS_SLOTS];
+};
+
+_Thread_local a_sentence_chunker_stats_t *a_sc_tls_stats = NULL;
+
+// ----------------------------------------------------------------------------
+//                          HELPER FUNCTIONS
+// ----------------------------------------------------------------------------
+
+static inline uint64_t slot_get(a_sentence_chunker_stats_t *s, size_t slot) {
+    return atomic_load_explicit(&s->v[slot], memory_order_relaxed);
+}
+
+static inline void slot_set(a_sentence_chunker_stats_t *s, size_t slot, uint64_t v) {
+    atomic_store_explicit(&s->v[slot], v, memory_order_relaxed);
+}
+
+static inline void slot_add(a_sentence_chunker_stats_t *s, size_t slot, uint64_t n) {
+    slot_set(s, slot, slot_get(s, slot) + n);
+}
+
+/* Log-linear bucket: exact below 16, then 8 sub-buckets per power of two. */
+static inline size_t bucket_index(uint64_t v) {
+    if (v < 16) {
+        return (size_t)v;
+    }
+    unsigned e = 63u - (unsigned)__builtin_clzll(v);  // e >= 4
+    size_t sub = (size_t)((v >> (e - 3)) & 7);
+    return 16 + (size_t)(e - 4) * 8 + sub;
+}
+
+static inline uint64_t bucket_upper(size_t idx) {
+    if (idx < 16) {
+        return idx;
+    }
+    unsigned e = 4 + (unsigned)((idx - 16) / 8);
+    uint64_t sub = (idx - 16) % 8;
+    uint64_t width = 1ull << (e - 3);
+    return ((8 + sub) << (e - 3)) + width - 1;
+}
+
+static void hist_record(a_sentence_chunker_stats_t *s, size_t hist, uint64_t v) {
+    slot_add(s, hist + HIST_FIELD(count), 1);
+    slot_add(s, hist + HIST_FIELD(sum), v);
+    if (~v > slot_get(s, hist + HIST_FIELD(min))) {
+        slot_set(s, hist + HIST_FIELD(min), ~v);
+    }
+    if (v > slot_get(s, hist + HIST_FIELD(max))) {
+        slot_set(s, hist + HIST_FIELD(max), v);
+    }
+    slot_add(s, hist + HIST_FIELD(buckets) + bucket_index(v), 1);
+}
+
+// ----------------------------------------------------------------------------
+//                          RECORDING (library-internal)
+// ----------------------------------------------------------------------------
+
+void a_sc_stats_record_pass(a_sentence_chunker_stats_t *s, int pass,
+                            uint64_t latency_ns, size_t input_bytes,
+                            const a_sentence_chunk_t *chunks, size_t num_chunks)
+{
+    hist_record(s, SLOT(latency_ns[pass]), latency_ns);
+    hist_record(s, SLOT(input_bytes[pass]), input_bytes);
+    hist_record(s, SLOT(output_chunks[pass]), num_chunks);
+    size_t lengths = SLOT(chunk_length[pass]);
+    for (size_t i = 0; i < num_chunks; i++) {
+        hist_record(s, lengths, chunks[i].length);
+    }
+}
+
+void a_sc_stats_gave_up(a_sentence_chunker_stats_t *s) {
+    slot_add(s, SLOT(split_gave_up), 1);
+}
+
+// ----------------------------------------------------------------------------
+//                                 PUBLIC API
+// ----------------------------------------------------------------------------
+
+a_sentence_chunker_stats_t *a_sentence_chunker_stats_init(void) {
+    return (a_sentence_chunker_stats_t *)aml_calloc(sizeof(a_sentence_chunker_stats_t));
+}
+
+void a_sentence_chunker_stats_destroy(a_sentence_chunker_stats_t *stats) {
+    if (!stats) return;
+    if (a_sc_tls_stats == stats) {
+        a_sc_tls_stats = NULL;
+    }
+    aml_free(stats);
+}
+
+a_sentence_chunker_stats_t *a_sentence_chunker_stats_attach(a_sentence_chunker_stats_t *stats) {
+    a_sentence_chunker_stats_t *prev = a_sc_tls_stats;
+    a_sc_tls_stats = stats;
+    return prev;
+}
+
+void a_sentence_chunker_stats_snapshot(a_sentence_chunker_stats_snapshot_t *out,
+                                       a_sentence_chunker_stats_t *stats)
+{
+    uint64_t *dst = (uint64_t *)out;
+    for (size_t i = 0; i < STATS_SLOTS; i++) {
+        dst[i] = slot_get(stats, i);
+    }
+    // Un-invert the histogram minimums
+    a_sentence_chunker_histogram_t *h = (a_sentence_chunker_histogram_t *)out;
+    size_t nhist = SLOT(split_gave_up) / HIST_SLOTS;
+    for (size_t i = 0; i < nhist; i++) {
+        h[i].min = h[i].count ? ~h[i].min : 0;
+    }
+}
+
+void a_sentence_chunker_stats_reset(a_sentence_chunker_stats_t *stats) {
+    for (size_t i = 0; i < STATS_SLOTS; i++) {
+        slot_set(stats, i, 0);
+    }
+}
+
+static void hist_merge(a_sentence_chunker_histogram_t *dst,
+                       const a_sentence_chunker_histogram_t *src)
+{
+    if (!src->count) return;
+    if (!dst->count || src->min < dst->min) dst->min = src->min;
+    if (src->max > dst->max) dst->max = src->max;
+    dst->count += src->count;
+    dst->sum += src->sum;
+    for (size_t i = 0; i < A_SENTENCE_CHUNKER_HISTOGRAM_BUCKETS; i++) {
+        dst->buckets[i] += src->buckets[i];
+    }
+}
+
+void a_sentence_chunker_stats_merge(a_sentence_chunker_stats_snapshot_t *dst,
+                                    const a_sentence_chunker_stats_snapshot_t *src)
+{
+    for (int p = 0; p < A_SENTENCE_CHUNKER_PASS_COUNT; p++) {
+        hist_merge(&dst->latency_ns[p], &src->latency_ns[p]);
+        hist_merge(&dst->input_bytes[p], &src->input_bytes[p]);
+        hist_merge(&dst->output_chunks[p], &src->output_chunks[p]);
+        hist_merge(&dst->chunk_length[p], &src->chunk_length[p]);
+    }
+    dst->split_gave_up += src->split_gave_up;
+}
+
+uint64_t a_sentence_chunker_histogram_percentile(const a_sentence_chunker_histogram_t *h,
+                                                 double p)
+{
+    if (!h->count) {
+        return 0;
+    }
+    if (p < 0.0) p = 0.0;
+    if (p > 100.0) p = 100.0;
+    uint64_t rank = (uint64_t)((p / 100.0) * (double)h->count + 0.5);
+    if (rank == 0) rank = 1;
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < A_SENTENCE_CHUNKER_HISTOGRAM_BUCKETS; i++) {
+        seen += h->buckets[i];
+        if (seen >= rank) {
+            uint64_t v = bucket_upper(i);
+            if (v > h->max) v = h->max;
+            if (v < h->min) v = h->min;
+            return v;
+        }
+    }
+    return h->max;
+}
+
+static void hist_to_json(aml_buffer_t *bh, const char *name,
+                         const a_sentence_chunker_histogram_t *h)
+{
+    aml_buffer_appendf(bh,
+        "\"%s\":{\"count\":%llu,\"min\":%llu,\"max\":%llu,\"mean\":%.1f,"
+        "\"p50\":%llu,\"p90\":%llu,\"p99\":%llu,\"p999\":%llu}",
+        name,
+        (unsigned long long)h->count,
+        (unsigned long long)h->min,
+        (unsigned long long)h->max,
+        h->count ? (double)h->sum / (double)h->count : 0.0,
+        (unsigned long long)a_sentence_chunker_histogram_percentile(h, 50.0),
+        (unsigned long long)a_sentence_chunker_histogram_percentile(h, 90.0),
+        (unsigned long long)a_sentence_chunker_histogram_percentile(h, 99.0),
+        (unsigned long long)a_sentence_chunker_histogram_percentile(h, 99.9));
+}
+
+void a_sentence_chunker_stats_to_json(aml_buffer_t *bh,
+                                      const a_sentence_chunker_stats_snapshot_t *s)
+{
+    static const char *pass_names[A_SENTENCE_CHUNKER_PASS_COUNT] = {
+        "first_pass", "rechunk"
+    };
+    aml_buffer_appendc(bh, '{');
+    for (int p = 0; p < A_SENTENCE_CHUNKER_PASS_COUNT; p++) {
+        aml_buffer_appendf(bh, "\"%s\":{", pass_names[p]);
+        hist_to_json(bh, "latency_ns", &s->latency_ns[p]);
+        aml_buffer_appendc(bh, ',');
+        hist_to_json(bh, "input_bytes", &s->input_bytes[p]);
+        aml_buffer_appendc(bh, ',');
+        hist_to_json(bh, "output_chunks", &s->output_chunks[p]);
+        aml_buffer_appendc(bh, ',');
+        hist_to_json(bh, "chunk_length", &s->chunk_length[p]);
+        aml_buffer_appends(bh, "},");
+    }
+    aml_buffer_appendf(bh, "\"split_gave_up\":%llu}",
+                       (unsigned long long)s->split_gave_up);
+}
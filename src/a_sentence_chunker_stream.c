@@ -0,0 +1,154 @@
+// SPDX-FileCopyrightText: 2025 Andy Curtis <contactandyc@gmail.com>
+// SPDX-FileCopyrightText: 2024–2025 Knode.ai — technical questions: contact Andy (above)
+// SPDX-License-Identifier: Apache-2.0
+
+#include <string.h>
+
+#include "a-memory-library/aml_alloc.h"
+#include "a-sentence-chunker-library/a_sentence_chunker_stream.h"
+#include "a_sentence_chunker_internal.h"
+
+struct a_sentence_chunker_stream_s {
+    aml_buffer_t *window; // buffered bytes, window[0] is at stream offset base
+    size_t base;
+    size_t start_off;     // stream offset of the unfinished sentence
+    size_t scan;          // stream offset where the scan resumes
+    size_t max_pending;
+    bool finished;
+};
+
+static inline bool is_whitespace(char c) {
+    return (c == ' ' || c == '\t' || c == '\n' || c == '\r');
+}
+
+static void append_chunk(aml_buffer_t *bh, size_t start, size_t length) {
+    a_sentence_chunk_t sb;
+    sb.start_offset = start;
+    sb.length = length;
+    aml_buffer_append(bh, &sb, sizeof(sb));
+}
+
+static a_sentence_chunk_t *result(size_t *num, aml_buffer_t *bh) {
+    size_t total = aml_buffer_length(bh) / sizeof(a_sentence_chunk_t);
+    if (total == 0) {
+        return NULL;
+    }
+    *num = total;
+    return (a_sentence_chunk_t *)aml_buffer_data(bh);
+}
+
+/* Drop bytes before the unfinished sentence, keeping the look-behind the
+   backward walks need. */
+static void compact(a_sentence_chunker_stream_t *s) {
+    size_t keep = s->start_off > s->base + A_SENTENCE_CHUNKER_STREAM_LOOKBEHIND
+                      ? s->start_off - A_SENTENCE_CHUNKER_STREAM_LOOKBEHIND
+                      : s->base;
+    if (keep == s->base) {
+        return;
+    }
+    char *w = aml_buffer_data(s->window);
+    size_t drop = keep - s->base;
+    size_t rest = aml_buffer_length(s->window) - drop;
+    memmove(w, w + drop, rest);
+    aml_buffer_resize(s->window, rest);
+    s->base = keep;
+}
+
+static void step(a_sentence_chunker_stream_t *s, aml_buffer_t *bh, bool final) {
+    char *w = aml_buffer_data(s->window);
+    size_t wlen = aml_buffer_length(s->window);
+    size_t start = s->start_off - s->base;
+    size_t i = a_sc_first_pass_step(bh, w, wlen, s->scan - s->base, &start, s->base, !final);
+
+    if (final) {
+        if (start < wlen) {
+            append_chunk(bh, s->base + start, wlen - start);
+        }
+        start = i = wlen;
+    }
+    else if (s->max_pending && wlen - start > s->max_pending) {
+        // Cut before the unsettled run (at i), preferably at whitespace
+        size_t cut = i;
+        while (cut > start && !is_whitespace(w[cut - 1])) {
+            cut--;
+        }
+        if (cut > start + 1) {
+            cut--; // end before the last whitespace
+        } else {
+            cut = i > start ? i : wlen;
+        }
+        append_chunk(bh, s->base + start, cut - start);
+        start = cut;
+        while (start < wlen && is_whitespace(w[start])) {
+            start++;
+        }
+        if (i < start) {
+            i = start;
+        }
+    }
+    s->start_off = s->base + start;
+    s->scan = s->base + i;
+}
+
+a_sentence_chunker_stream_t *a_sentence_chunker_stream_init(size_t max_pending) {
+    a_sentence_chunker_stream_t *s =
+        (a_sentence_chunker_stream_t *)aml_calloc(sizeof(*s));
+    s->window = aml_buffer_init(4096);
+    s->max_pending = max_pending;
+    return s;
+}
+
+void a_sentence_chunker_stream_destroy(a_sentence_chunker_stream_t *s) {
+    if (!s) return;
+    aml_buffer_destroy(s->window);
+    aml_free(s);
+}
+
+void a_sentence_chunker_stream_reset(a_sentence_chunker_stream_t *s) {
+    aml_buffer_clear(s->window);
+    s->base = s->start_off = s->scan = 0;
+    s->finished = false;
+}
+
+a_sentence_chunk_t *a_sentence_chunker_stream_feed(size_t *num, aml_buffer_t *bh,
+                                                   a_sentence_chunker_stream_t *s,
+                                                   const char *data, size_t len)
+{
+    aml_buffer_clear(bh);
+    *num = 0;
+    if (s->finished || !len) {
+        return NULL;
+    }
+    compact(s);
+    aml_buffer_append(s->window, data, len);
+    step(s, bh, false);
+    return result(num, bh);
+}
+
+a_sentence_chunk_t *a_sentence_chunker_stream_finish(size_t *num, aml_buffer_t *bh,
+                                                     a_sentence_chunker_stream_t *s)
+{
+    aml_buffer_clear(bh);
+    *num = 0;
+    if (s->finished) {
+        return NULL;
+    }
+    s->finished = true;
+    step(s, bh, true);
+    return result(num, bh);
+}
+
+const char *a_sentence_chunker_stream_text(a_sentence_chunker_stream_t *s,
+                                           const a_sentence_chunk_t *chunk)
+{
+    if (chunk->start_offset < s->base ||
+        chunk->start_offset + chunk->length > s->base + aml_buffer_length(s->window))
+    {
+        return NULL;
+    }
+    return aml_buffer_data(s->window) + (chunk->start_offset - s->base);
+}
+
+size_t a_sentence_chunker_stream_buffered(a_sentence_chunker_stream_t *s) {
+    return aml_buffer_length(s->window);
+}
@@ -0,0 +1,189 @@
+// SPDX-FileCopyrightText: 2025 Andy Curtis <contactandyc@gmail.com>
+// SPDX-FileCopyrightText: 2024–2025 Knode.ai — technical questions: contact Andy (above)
+// SPDX-License-Identifier: Apache-2.0
+
+
+#include "a-memory-library/aml_alloc.h"
+#include "a-sentence-chunker-library/a_sentence_chunker_trace.h"
+#include "a_sentence_chunker_instrument.h"
+
+struct a_sentence_chunker_trace_s {
+    a_sentence_chunker_trace_record_t *records;
+    size_t mask;
+    uint64_t written;
+};
+
+_Thread_local a_sentence_chunker_trace_t *a_sc_tls_trace = NULL;
+
+static const char *RULE_NAMES[A_SENTENCE_CHUNKER_RULE_COUNT] = {
+    "boundary", "decimal", "abbrev_next_alpha", "abbrev_single_upper",
+    "abbrev_single_letter", "abbrev_list", "ordinal", "nested"
+};
+
+static const char *SPLIT_NAMES[A_SPLIT_HEURISTIC_COUNT] = {
+    "double_newline", "triple_space", "newline", "punct_upper",
+    "whitespace", "fallback", "none"
+};
+
+static const char *PASS_NAMES[A_SENTENCE_CHUNKER_PASS_COUNT] = {
+    "first", "rechunk"
+};
+
+// ----------------------------------------------------------------------------
+//                          RECORDING (library-internal)
+// ----------------------------------------------------------------------------
+
+static inline uint16_t saturate16(size_t v) {
+    return v > 0xFFFF ? 0xFFFF : (uint16_t)v;
+}
+
+static inline void trace_push(a_sentence_chunker_trace_t *t,
+                              const a_sentence_chunker_trace_record_t *r)
+{
+    t->records[t->written++ & t->mask] = *r;
+}
+
+void a_sc_trace_document(a_sentence_chunker_trace_t *t, int pass, size_t length) {
+    a_sentence_chunker_trace_record_t r = {
+        0, (uint32_t)length, 0, 0, 0,
+        A_SENTENCE_CHUNKER_TRACE_DOCUMENT, (uint8_t)pass
+    };
+    trace_push(t, &r);
+}
+
+void a_sc_trace_punct_run(a_sentence_chunker_trace_t *t, size_t first, size_t last,
+                          int rule, size_t result, size_t walked)
+{
+    a_sentence_chunker_trace_record_t r = {
+        (uint32_t)first, (uint32_t)(last + 1 - first), (uint32_t)result, 0,
+        saturate16(walked), A_SENTENCE_CHUNKER_TRACE_PUNCT_RUN, (uint8_t)rule
+    };
+    trace_push(t, &r);
+}
+
+void a_sc_trace_split(a_sentence_chunker_trace_t *t, size_t start, size_t length,
+                      size_t split, size_t candidate, int heuristic, size_t walked)
+{
+    a_sentence_chunker_trace_record_t r = {
+        (uint32_t)start, (uint32_t)length, (uint32_t)(split - start),
+        heuristic == A_SPLIT_NONE ? 0 : (int32_t)((int64_t)split - (int64_t)candidate),
+        saturate16(walked), A_SENTENCE_CHUNKER_TRACE_SPLIT, (uint8_t)heuristic
+    };
+    trace_push(t, &r);
+}
+
+// ----------------------------------------------------------------------------
+//                                 PUBLIC API
+// ----------------------------------------------------------------------------
+
+a_sentence_chunker_trace_t *a_sentence_chunker_trace_init(size_t capacity) {
+    size_t n = 64;
+    while (n < capacity) n <<= 1;
+    a_sentence_chunker_trace_t *t =
+        (a_sentence_chunker_trace_t *)aml_calloc(sizeof(*t));
+    t->records = (a_sentence_chunker_trace_record_t *)
+        aml_malloc(n * sizeof(a_sentence_chunker_trace_record_t));
+    t->mask = n - 1;
+    return t;
+}
+
+void a_sentence_chunker_trace_destroy(a_sentence_chunker_trace_t *trace) {
+    if (!trace) return;
+    if (a_sc_tls_trace == trace) a_sc_tls_trace = NULL;
+    aml_free(trace->records);
+    aml_free(trace);
+}
+
+a_sentence_chunker_trace_t *a_sentence_chunker_trace_attach(a_sentence_chunker_trace_t *trace) {
+    a_sentence_chunker_trace_t *prev = a_sc_tls_trace;
+    a_sc_tls_trace = trace;
+    return prev;
+}
+
+void a_sentence_chunker_trace_reset(a_sentence_chunker_trace_t *trace) {
+    trace->written = 0;
+}
+
+uint64_t a_sentence_chunker_trace_written(const a_sentence_chunker_trace_t *trace) {
+    return trace->written;
+}
+
+size_t a_sentence_chunker_trace_read(const a_sentence_chunker_trace_t *trace,
+                                     a_sentence_chunker_trace_record_t *out,
+                                     size_t max)
+{
+    uint64_t retained = trace->written;
+    if (retained > trace->mask + 1) retained = trace->mask + 1;
+    if (retained > max) retained = max;
+    uint64_t first = trace->written - retained;
+    for (uint64_t k = 0; k < retained; k++) {
+        out[k] = trace->records[(first + k) & trace->mask];
+    }
+    return (size_t)retained;
+}
+
+const char *a_sentence_chunker_trace_rule_name(const a_sentence_chunker_trace_record_t *r) {
+    switch (r->event) {
+    case A_SENTENCE_CHUNKER_TRACE_DOCUMENT:
+        return r->rule < A_SENTENCE_CHUNKER_PASS_COUNT ? PASS_NAMES[r->rule] : "?";
+    case A_SENTENCE_CHUNKER_TRACE_PUNCT_RUN:
+        return r->rule < A_SENTENCE_CHUNKER_RULE_COUNT ? RULE_NAMES[r->rule] : "?";
+    case A_SENTENCE_CHUNKER_TRACE_SPLIT:
+        return r->rule < A_SPLIT_HEURISTIC_COUNT ? SPLIT_NAMES[r->rule] : "?";
+    default:
+        return "?";
+    }
+}
+
+static void append_excerpt(aml_buffer_t *bh, const char *text, size_t len, size_t pos) {
+    size_t from = pos > 12 ? pos - 12 : 0;
+    size_t to = pos + 12 < len ? pos + 12 : len;
+    aml_buffer_appends(bh, "  \"");
+    for (size_t k = from; k < to; k++) {
+        char c = text[k];
+        if (c == '\n') aml_buffer_appends(bh, "\\n");
+        else if (c == '\r') aml_buffer_appends(bh, "\\r");
+        else if (c == '\t') aml_buffer_appends(bh, "\\t");
+        else aml_buffer_appendc(bh, c);
+    }
+    aml_buffer_appendc(bh, '"');
+}
+
+void a_sentence_chunker_trace_to_text(aml_buffer_t *bh, const char *text, size_t len,
+                                      const a_sentence_chunker_trace_record_t *records,
+                                      size_t num_records)
+{
+    for (size_t k = 0; k < num_records; k++) {
+        const a_sentence_chunker_trace_record_t *r = records + k;
+        const char *name = a_sentence_chunker_trace_rule_name(r);
+        switch (r->event) {
+        case A_SENTENCE_CHUNKER_TRACE_DOCUMENT:
+            aml_buffer_appendf(bh, "document pass=%s length=%u\n", name, r->length);
+            continue;
+        case A_SENTENCE_CHUNKER_TRACE_PUNCT_RUN:
+            aml_buffer_appendf(bh, "punct    pos=%u run=%u %s %-20s walked=%u",
+                               r->pos, r->length,
+                               r->rule == A_SENTENCE_CHUNKER_RULE_BOUNDARY ? "accept" : "reject",
+                               name, r->walked);
+            if (r->rule == A_SENTENCE_CHUNKER_RULE_BOUNDARY) {
+                aml_buffer_appendf(bh, " end=%u", r->result);
+            } else if (r->rule == A_SENTENCE_CHUNKER_RULE_ABBREV_LIST) {
+                const char *abbrev = a_sentence_chunker_counters_abbreviation(r->result);
+                aml_buffer_appendf(bh, " abbrev=%s", abbrev ? abbrev : "?");
+            }
+            break;
+        case A_SENTENCE_CHUNKER_TRACE_SPLIT:
+            aml_buffer_appendf(bh, "split    pos=%u length=%u at=+%u %-20s adjust=%d walked=%u",
+                               r->pos, r->length, r->result, name, r->adjust, r->walked);
+            break;
+        default:
+            aml_buffer_appendf(bh, "unknown event %u\n", r->event);
+            continue;
+        }
+        if (text && r->pos < len) {
+            size_t at = r->event == A_SENTENCE_CHUNKER_TRACE_SPLIT ? r->pos + r->result : r->pos;
+            append_excerpt(bh, text, len, at);
+        }
+        aml_buffer_appendc(bh, '\n');
+    }
+}
@@ -8,19 +8,25 @@ COV="off"
 for arg in "$@"; do
   case "$arg" in
     variant=coverage) VRAW="debug"; COV="on";;
-    variant=debug|variant=memory|variant=static|variant=shared) VRAW="${arg#variant=}";;
+    variant=debug|variant=memory|variant=static|variant=shared|variant=fast|variant=counters|variant=pgo) VRAW="${arg#variant=}";;
     coverage=on) COV="on";;
     coverage=off) COV="off";;
   esac
 done
 
 case "$VRAW" in
-  debug|memory|static|shared) ;;
+  debug|static|shared|fast) ;;
+  memory) set -- "$@" -DA_BUILD_ENABLE_MEMORY_PROFILE=ON;;
+  counters) set -- "$@" -DA_BUILD_ENABLE_COUNTERS=ON;;
+  pgo) set -- "$@" -DA_BUILD_ENABLE_PGO=ON;;
   help|-h|--help)
     cat <<EOF
-Usage: ./build.sh [variant=debug|memory|static|shared|coverage] [coverage=on|off] [extra CMake args]
+Usage: ./build.sh [variant=debug|memory|static|shared|fast|counters|pgo|coverage] [coverage=on|off] [extra CMake args]
 Notes:
   - 'variant=coverage' => shorthand for debug + -DA_ENABLE_COVERAGE=ON
+  - 'variant=counters' => also sets -DA_BUILD_ENABLE_COUNTERS=ON
+  - 'variant=pgo'      => also sets -DA_BUILD_ENABLE_PGO=ON (trains, then rebuilds)
+  - 'variant=memory'   => also sets -DA_BUILD_ENABLE_MEMORY_PROFILE=ON (_AML_DEBUG_)
   - Prefer a unified build so the library is instrumented too.
 EOF
     exit 0;;
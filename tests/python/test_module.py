@@ -0,0 +1,138 @@
+# SPDX-FileCopyrightText: 2025 Andy Curtis <contactandyc@gmail.com>
+# SPDX-FileCopyrightText: 2024–2025 Knode.ai — technical questions: contact Andy (above)
+# SPDX-License-Identifier: Apache-2.0
+
+"""
+CPython extension test: every bytes-like input must give the same spans
+without copying, the (n, 2) int64 buffer must describe the chunks, the
+rechunk paths must agree, and chunk_batch must match chunk() per document
+whatever the thread count.
+"""
+
+import mmap
+import sys
+import tempfile
+import threading
+
+import a_sentence_chunker as sc
+
+SAMPLE = (b"Dr. Smith paid $3.14 for it. Then he left!\n\n"
+          b"1. First item\n2. Second item\nIs that all? Yes.")
+
+
+def rows(spans):
+    return memoryview(spans).tolist()
+
+
+def check(name, ok):
+    print("%s: %s" % ("PASS" if ok else "FAIL", name))
+    return ok
+
+
+def check_inputs(text):
+    ref = rows(sc.chunk(text))
+    ok = len(ref) > 0
+    ok &= rows(sc.chunk(bytearray(text))) == ref
+    ok &= rows(sc.chunk(memoryview(text))) == ref
+    with tempfile.TemporaryFile() as fp:
+        fp.write(text)
+        fp.flush()
+        with mmap.mmap(fp.fileno(), 0, access=mmap.ACCESS_READ) as mm:
+            spans = sc.chunk(mm)
+            ok &= rows(spans) == ref
+            ok &= bytes(spans.text(0)) == text[ref[0][0]:ref[0][0] + ref[0][1]]
+            del spans
+    return check("bytes/bytearray/memoryview/mmap", ok)
+
+
+def check_buffer(text):
+    spans = sc.chunk(text)
+    view = memoryview(spans)
+    ok = view.format == "q" and view.itemsize == 8 and view.readonly
+    ok &= view.shape == (len(spans), 2) and view.strides == (16, 8)
+    ok &= [tuple(r) for r in view.tolist()] == list(spans)
+    ok &= all(bytes(spans.text(k)) == text[s:s + n] for k, (s, n) in enumerate(spans))
+    ok &= spans.source is text
+    # The view keeps the spans alive
+    del spans
+    ok &= len(view.tolist()) == view.shape[0]
+    ok &= memoryview(sc.chunk(b"")).shape == (0, 2)
+    try:
+        import numpy
+        arr = numpy.asarray(sc.chunk(text))
+        ok &= arr.dtype == numpy.int64 and arr.shape == view.shape
+        ok &= arr.tolist() == view.tolist()
+    except ImportError:
+        pass
+    return check("int64 (n, 2) buffer", ok)
+
+
+def check_rechunk(text):
+    first = sc.chunk(text)
+    ok = rows(sc.rechunk(text, first, 40, 240)) == rows(sc.chunk(text, 40, 240))
+    ok &= rows(sc.chunk(text, max_length=240)) == rows(sc.rechunk(text, first, 0, 240))
+    return check("rechunk", ok)
+
+
+def check_batch(docs):
+    ref = [rows(sc.chunk(d, 40, 240)) for d in docs]
+    ok = True
+    for threads in (0, 1, 3, 64):
+        got = sc.chunk_batch(docs, 40, 240, threads=threads)
+        ok &= [rows(s) for s in got] == ref
+        ok &= all(s.source is d for s, d in zip(got, docs))
+    ok &= sc.chunk_batch([]) == []
+    return check("chunk_batch (%d docs)" % len(docs), ok)
+
+
+def check_threads(text):
+    ref = rows(sc.chunk(text))
+    results = []
+
+    def worker():
+        for _ in range(20):
+            results.append(rows(sc.chunk(text)) == ref)
+
+    pool = [threading.Thread(target=worker) for _ in range(4)]
+    for t in pool:
+        t.start()
+    for t in pool:
+        t.join()
+    return check("concurrent chunk()", all(results) and len(results) == 80)
+
+
+def check_errors():
+    def raises(exc, fn, *args, **kwargs):
+        try:
+            fn(*args, **kwargs)
+        except exc:
+            return True
+        return False
+
+    ok = raises(TypeError, sc.chunk, "not bytes")
+    ok &= raises(ValueError, sc.chunk, SAMPLE, -1, 10)
+    ok &= raises(ValueError, sc.chunk, SAMPLE, 50, 10)
+    ok &= raises(ValueError, sc.rechunk, b"short", sc.chunk(SAMPLE), 0, 10)
+    ok &= raises(TypeError, sc.chunk_batch, [SAMPLE, "str"])
+    ok &= raises(IndexError, sc.chunk(SAMPLE).text, 100)
+    ok &= isinstance(sc.kernel(), str)
+    return check("errors", ok)
+
+
+def main(argv):
+    text = SAMPLE
+    if len(argv) > 1:
+        with open(argv[1], "rb") as fp:
+            text = fp.read()
+    docs = [text[k:] for k in range(0, min(len(text), 4000), 37)] + [SAMPLE, b""]
+    ok = check_inputs(text)
+    ok &= check_buffer(text)
+    ok &= check_rechunk(text)
+    ok &= check_batch(docs)
+    ok &= check_threads(text)
+    ok &= check_errors()
+    return 0 if ok else 1
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
@@ -0,0 +1,85 @@
+// SPDX-FileCopyrightText: 2025 Andy Curtis <contactandyc@gmail.com>
+// SPDX-FileCopyrightText: 2024–2025 Knode.ai — technical questions: contact Andy (above)
+// SPDX-License-Identifier: Apache-2.0
+
+#include <stddef.h>
+#include <string.h>
+#include "alloc_counters.h"
+
+static alloc_counters_t counters;
+
+#ifdef ALLOC_COUNTERS_WRAP
+
+#include <malloc.h>
+
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t n, size_t size);
+void *__real_realloc(void *p, size_t size);
+void __real_free(void *p);
+
+static inline void track_alloc(void *p) {
+    if (!p) return;
+    size_t n = malloc_usable_size(p);
+    counters.bytes_allocated += n;
+    counters.live_bytes += (int64_t)n;
+    if (counters.live_bytes > counters.peak_live_bytes) {
+        counters.peak_live_bytes = counters.live_bytes;
+    }
+}
+
+void *__wrap_malloc(size_t size) {
+    counters.mallocs++;
+    void *p = __real_malloc(size);
+    track_alloc(p);
+    return p;
+}
+
+void *__wrap_calloc(size_t n, size_t size) {
+    counters.mallocs++;
+    void *p = __real_calloc(n, size);
+    track_alloc(p);
+    return p;
+}
+
+void *__wrap_realloc(void *p, size_t size) {
+    counters.reallocs++;
+    size_t old = p ? malloc_usable_size(p) : 0;
+    void *r = __real_realloc(p, size);
+    if (r || size == 0) {
+        counters.live_bytes -= (int64_t)old;
+        track_alloc(r);
+    }
+    return r;
+}
+
+void __wrap_free(void *p) {
+    if (p) {
+        counters.frees++;
+        counters.live_bytes -= (int64_t)malloc_usable_size(p);
+    }
+    __real_free(p);
+}
+
+bool alloc_counters_enabled(void) {
+    return true;
+}
+
+#else
+
+bool alloc_counters_enabled(void) {
+    return false;
+}
+
+#endif
+
+void alloc_counters_get(alloc_counters_t *out) {
+    *out = counters;
+}
+
+void alloc_counters_reset(void) {
+    memset(&counters, 0, sizeof(counters));
+}
+
+void alloc_counters_reset_peak(void) {
+    counters.peak_live_bytes = counters.live_bytes;
+}
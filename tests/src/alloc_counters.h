@@ -0,0 +1,38 @@
+// SPDX-FileCopyrightText: 2025 Andy Curtis <contactandyc@gmail.com>
+// SPDX-FileCopyrightText: 2024–2025 Knode.ai — technical questions: contact Andy (above)
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _alloc_counters_h
+#define _alloc_counters_h
+
+/*
+   Heap call accounting for benchmark binaries. When the binary is linked
+   with -Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc,--wrap=free and
+   compiled with ALLOC_COUNTERS_WRAP, every allocation made by the binary
+   and the static libraries it links (including a-memory-library) is
+   counted. Without wrapping, alloc_counters_enabled() returns false.
+
+   Byte figures use malloc_usable_size(), so they include allocator
+   rounding; live bytes only cover blocks allocated since the last reset.
+*/
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef struct {
+    uint64_t mallocs;   // malloc + calloc
+    uint64_t reallocs;
+    uint64_t frees;
+    uint64_t bytes_allocated; // usable bytes handed out; a realloc counts its new size
+    int64_t live_bytes;       // allocated minus freed since reset
+    int64_t peak_live_bytes;  // high-water mark of live_bytes
+} alloc_counters_t;
+
+bool alloc_counters_enabled(void);
+void alloc_counters_get(alloc_counters_t *out);
+void alloc_counters_reset(void);
+
+/* Restart the high-water mark from the current live bytes. */
+void alloc_counters_reset_peak(void);
+
+#endif
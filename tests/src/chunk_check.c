@@ -0,0 +1,45 @@
+// SPDX-FileCopyrightText: 2025 Andy Curtis <contactandyc@gmail.com>
+// SPDX-FileCopyrightText: 2024–2025 Knode.ai — technical questions: contact Andy (above)
+// SPDX-License-Identifier: Apache-2.0
+
+#include "chunk_check.h"
+
+#include <stdio.h>
+#include <string.h>
+
+a_sentence_chunker_options_t chunk_check_options(a_sentence_chunker_format_t format) {
+    a_sentence_chunker_options_t opts;
+    memset(&opts, 0, sizeof(opts));
+    opts.format = format;
+    return opts;
+}
+
+bool chunk_check_text(const char *text, const a_sentence_chunk_t *c, size_t num,
+                      const char *const *expected, const char *what)
+{
+    bool ok = true;
+    size_t k = 0;
+    for (; expected[k]; k++) {
+        ok &= k < num && c[k].length == strlen(expected[k]) &&
+              memcmp(text + c[k].start_offset, expected[k], c[k].length) == 0;
+    }
+    ok &= k == num;
+    if (!ok) {
+        printf("  %s gave", what);
+        for (size_t j = 0; j < num; j++) {
+            printf(" [%.*s]", (int)c[j].length, text + c[j].start_offset);
+        }
+        printf("\n");
+    }
+    return ok;
+}
+
+bool chunk_check_ordered(size_t len, const a_sentence_chunk_t *c, size_t num) {
+    size_t prev_end = 0;
+    for (size_t k = 0; k < num; k++) {
+        size_t end = c[k].start_offset + c[k].length;
+        if (!c[k].length || c[k].start_offset < prev_end || end > len) return false;
+        prev_end = end;
+    }
+    return true;
+}
@@ -0,0 +1,28 @@
+// SPDX-FileCopyrightText: 2025 Andy Curtis <contactandyc@gmail.com>
+// SPDX-FileCopyrightText: 2024–2025 Knode.ai — technical questions: contact Andy (above)
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _chunk_check_h
+#define _chunk_check_h
+
+/*
+   Shared assertions for the format tests. Each test layers its own
+   format-specific edge checks on top of these.
+*/
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "a-sentence-chunker-library/a_sentence_chunker.h"
+
+/* Default options with only the format set. */
+a_sentence_chunker_options_t chunk_check_options(a_sentence_chunker_format_t format);
+
+/* True when the chunks are exactly expected (NULL-terminated); otherwise
+   prints what and the chunks it gave. */
+bool chunk_check_text(const char *text, const a_sentence_chunk_t *c, size_t num,
+                      const char *const *expected, const char *what);
+
+/* True when the chunks are ordered, non-empty and inside [0, len). */
+bool chunk_check_ordered(size_t len, const a_sentence_chunk_t *c, size_t num);
+
+#endif
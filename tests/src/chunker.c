@@ -10,31 +10,13 @@
 #include "a-json-library/ajson.h"
 #include "a-memory-library/aml_pool.h"
 #include "a-sentence-chunker-library/a_sentence_chunker.h"
+#include "perf_events.h"
+#include "read_file.h"
 
 #define MAX_PATH_LEN 1024
 
-// Helper function: read entire file into memory.
-char *read_file(const char *filename, size_t *out_length) {
-    FILE *fp = fopen(filename, "rb");
-    if (!fp) {
-        perror("fopen");
-        return NULL;
-    }
-    fseek(fp, 0, SEEK_END);
-    long fsize = ftell(fp);
-    rewind(fp);
-    char *buffer = malloc(fsize + 1);
-    if (!buffer) {
-        fclose(fp);
-        return NULL;
-    }
-    fread(buffer, 1, fsize, fp);
-    fclose(fp);
-    buffer[fsize] = '\0';
-    if (out_length)
-        *out_length = fsize;
-    return buffer;
-}
+// --perf: bytes each pass should process per corpus unless --repeat is given
+#define PERF_TARGET_BYTES (64u * 1024u * 1024u)
 
 static void print_with_escaped_newlines(const char *str) {
     while (*str) {
@@ -275,6 +257,119 @@ static void process_json_file(const char *json_file) {
     aml_pool_destroy(pool);
 }
 
+// ------------------------------------------------------------------
+// --perf: hardware counters per corpus, first pass and rechunk measured
+// separately.
+// ------------------------------------------------------------------
+static void print_perf_value(const perf_events_t *p, perf_event_id_t ev,
+                             double value, const char *fmt)
+{
+    if (perf_events_available(p, ev)) {
+        printf(fmt, value);
+    } else {
+        printf("%12s", "n/a");
+    }
+}
+
+static void print_perf_row(const char *pass, const perf_events_t *p, double bytes) {
+    const uint64_t *v = p->value;
+    double mb = bytes / (1024.0 * 1024.0);
+    printf("%-8s", pass);
+    print_perf_value(p, PERF_EV_CYCLES, v[PERF_EV_CYCLES] / bytes, "%12.3f");
+    print_perf_value(p, PERF_EV_INSTRUCTIONS, v[PERF_EV_INSTRUCTIONS] / bytes, "%12.3f");
+    print_perf_value(p, PERF_EV_CYCLES,
+                     v[PERF_EV_CYCLES] ? (double)v[PERF_EV_INSTRUCTIONS] / v[PERF_EV_CYCLES] : 0.0,
+                     "%12.2f");
+    print_perf_value(p, PERF_EV_BRANCH_MISSES,
+                     v[PERF_EV_BRANCHES] ? 100.0 * v[PERF_EV_BRANCH_MISSES] / v[PERF_EV_BRANCHES] : 0.0,
+                     "%11.3f%%");
+    print_perf_value(p, PERF_EV_L1D_MISSES, v[PERF_EV_L1D_MISSES] / mb, "%12.1f");
+    print_perf_value(p, PERF_EV_LLC_MISSES, v[PERF_EV_LLC_MISSES] / mb, "%12.1f");
+    printf("\n");
+}
+
+static void perf_corpus(const char *name, size_t repeat) {
+    size_t length = 0;
+    char *content = read_file(name, &length);
+    if (!content || !length) {
+        fprintf(stderr, "Could not read corpus: %s\n", name);
+        free(content);
+        return;
+    }
+    if (!repeat) {
+        repeat = PERF_TARGET_BYTES / length;
+        if (repeat < 1) repeat = 1;
+    }
+
+    perf_events_t p;
+    if (!perf_events_open(&p)) {
+        fprintf(stderr, "perf_event_open unavailable (check kernel.perf_event_paranoid)\n");
+        free(content);
+        return;
+    }
+
+    aml_buffer_t *bh1 = aml_buffer_init(32);
+    aml_buffer_t *bh2 = aml_buffer_init(32);
+
+    // Warm up caches and grow both buffers to their steady-state size
+    size_t num_first = 0, num_final = 0;
+    a_sentence_chunk_t *first = a_sentence_chunker_len(&num_first, bh1, content, length);
+    a_rechunk_sentences(&num_final, bh2, content, first, num_first, 5, 250);
+
+    double bytes = (double)length * (double)repeat;
+    printf("\n=== %s (%zu bytes x %zu, %zu -> %zu chunks) ===\n",
+           name, length, repeat, num_first, num_final);
+    printf("%-8s%12s%12s%12s%12s%12s%12s\n", "pass",
+           "cycles/B", "instr/B", "IPC", "br-miss", "L1D-miss/MB", "LLC-miss/MB");
+
+    perf_events_start(&p);
+    for (size_t r = 0; r < repeat; r++) {
+        first = a_sentence_chunker_len(&num_first, bh1, content, length);
+    }
+    perf_events_stop(&p);
+    print_perf_row("first", &p, bytes);
+
+    perf_events_start(&p);
+    for (size_t r = 0; r < repeat; r++) {
+        a_rechunk_sentences(&num_final, bh2, content, first, num_first, 5, 250);
+    }
+    perf_events_stop(&p);
+    print_perf_row("rechunk", &p, bytes);
+
+    perf_events_close(&p);
+    aml_buffer_destroy(bh1);
+    aml_buffer_destroy(bh2);
+    free(content);
+}
+
+// Every regular, non-JSON file under a directory is its own corpus.
+static void perf_path(const char *path, size_t repeat) {
+    struct stat path_stat;
+    if (stat(path, &path_stat) != 0) {
+        perror("stat");
+        return;
+    }
+    if (!S_ISDIR(path_stat.st_mode)) {
+        perf_corpus(path, repeat);
+        return;
+    }
+    DIR *dir = opendir(path);
+    if (!dir) {
+        perror("opendir");
+        return;
+    }
+    struct dirent *entry;
+    char child[MAX_PATH_LEN];
+    while ((entry = readdir(dir)) != NULL) {
+        if (entry->d_name[0] == '.' || strstr(entry->d_name, ".json")) {
+            continue;
+        }
+        snprintf(child, sizeof(child), "%s/%s", path, entry->d_name);
+        perf_path(child, repeat);
+    }
+    closedir(dir);
+}
+
 // Recursively process all JSON files in a directory.
 static void process_directory(const char *dir_path) {
     DIR *dir = opendir(dir_path);
@@ -313,9 +408,23 @@ static void process_directory(const char *dir_path) {
 int main(int argc, char *argv[]) {
     if (argc < 2) {
         fprintf(stderr, "Usage: %s <test.json | directory>\n", argv[0]);
+        fprintf(stderr, "       %s --perf [--repeat N] <corpus | directory> ...\n", argv[0]);
         return 1;
     }
 
+    if (strcmp(argv[1], "--perf") == 0) {
+        size_t repeat = 0; // 0 => enough repetitions for PERF_TARGET_BYTES
+        int a = 2;
+        if (a + 1 < argc && strcmp(argv[a], "--repeat") == 0) {
+            repeat = (size_t)strtoull(argv[a + 1], NULL, 10);
+            a += 2;
+        }
+        for (; a < argc; a++) {
+            perf_path(argv[a], repeat);
+        }
+        return 0;
+    }
+
     struct stat path_stat;
     if (stat(argv[1], &path_stat) != 0) {
         perror("stat");
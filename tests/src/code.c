@@ -0,0 +1,200 @@
+// SPDX-FileCopyrightText: 2025 Andy Curtis <contactandyc@gmail.com>
+// SPDX-FileCopyrightText: 2024–2025 Knode.ai — technical questions: contact Andy (above)
+// SPDX-License-Identifier: Apache-2.0
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "a-sentence-chunker-library/a_sentence_chunker.h"
+#include "chunk_check.h"
+
+/*
+   Source-code test: the C, Python, Go and Rust formats chunk comments and
+   docstrings only, in place. Checks a sample file per language chunk by
+   chunk (strings, raw strings, char literals and lifetimes that hide
+   comment markers; paragraphs of line comments), that rechunking stays
+   inside a paragraph and keeps markers out of chunk edges, and that
+   chunks over random code are ordered, non-empty and inside the text.
+*/
+
+static bool expect(a_sentence_chunker_format_t format, const char *text,
+                   const char *const *expected)
+{
+    aml_buffer_t *bh = aml_buffer_init(256);
+    a_sentence_chunker_options_t opts = chunk_check_options(format);
+    size_t num = 0;
+    a_sentence_chunk_t *c = a_sentence_chunker_opts(&num, bh, text, strlen(text), &opts);
+    char what[32];
+    snprintf(what, sizeof(what), "format %d", (int)format);
+    bool ok = chunk_check_text(text, c, num, expected, what);
+    aml_buffer_destroy(bh);
+    return ok;
+}
+
+static bool is_marker(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '/' || c == '*' || c == '#';
+}
+
+// Ordered, non-empty, in bounds, and (edges) no markers at either end
+static bool well_formed(const char *text, size_t len, const a_sentence_chunk_t *c, size_t num,
+                        bool edges)
+{
+    if (!chunk_check_ordered(len, c, num)) return false;
+    for (size_t k = 0; k < num && edges; k++) {
+        size_t end = c[k].start_offset + c[k].length;
+        // A split between words may leave the tail's space, as in plain text
+        size_t at = c[k].start_offset;
+        while (at < end - 1 && text[at] == ' ') at++;
+        if (is_marker(text[at]) || is_marker(text[end - 1])) return false;
+    }
+    return true;
+}
+
+static const char C_FILE[] =
+    "/*\n"
+    " * Parse a file. Returns 0 on success,\n"
+    " * e.g. when the file exists.\n"
+    " */\n"
+    "int parse(const char *s) {\n"
+    "    const char *u = \"http://x.com/a. B\"; // Trailing note. Two.\n"
+    "    char c = '/'; char d = '\"'; char e = '\\'';\n"
+    "    // First line of a\n"
+    "    // paragraph. Second one.\n"
+    "    //\n"
+    "    // New paragraph.\n"
+    "    x = 1'000; /* inline. Block */\n"
+    "    auto r = R\"x(// not. A comment)x\";\n"
+    "    return `tpl // no. X`;\n"
+    "}\n"
+    "/** Doc. */ /*! Inner. */\n";
+
+static const char PY_FILE[] =
+    "#!/usr/bin/env python\n"
+    "\"\"\"Module doc. Second sentence\n"
+    "continues here.\"\"\"\n"
+    "import os  # Import. Note\n"
+    "\n"
+    "def f(x):\n"
+    "    r'''Return x. Use it.'''\n"
+    "    s = \"\"\"not a doc. Really\"\"\"\n"
+    "    t = \"# not. A comment\" + '# nor. This'\n"
+    "    # Real comment. Done.\n"
+    "    return x\n";
+
+static const char GO_FILE[] =
+    "// Package x does things. It is small.\n"
+    "package x\n"
+    "\n"
+    "var s = `raw // not.\n"
+    "A comment`\n"
+    "var r = '\"'\n"
+    "/* Block. Two */\n";
+
+static const char RUST_FILE[] =
+    "//! Crate docs. More.\n"
+    "/// Adds one. Returns\n"
+    "/// the sum.\n"
+    "fn add<'a>(x: &'a str) -> char {\n"
+    "    let r = r#\"raw // \"still. raw\"#;\n"
+    "    /* outer /* inner */ still outer. */\n"
+    "    let y = \"// no. X\"; let q = '\"';\n"
+    "    'x'\n"
+    "}\n"
+    "// Tail.\n";
+
+int main(void) {
+    bool ok = true;
+    ok &= expect(A_SENTENCE_CHUNKER_FORMAT_C, C_FILE, (const char *const[]){
+        "Parse a file.", "Returns 0 on success,\n * e.g. when the file exists.", "Trailing note.",
+        "Two.", "First line of a\n    // paragraph.", "Second one.", "New paragraph.", "inline.",
+        "Block", "Doc.", "Inner.", NULL });
+    ok &= expect(A_SENTENCE_CHUNKER_FORMAT_PYTHON, PY_FILE, (const char *const[]){
+        "Module doc.", "Second sentence\ncontinues here.", "Import.", "Note", "Return x.",
+        "Use it.", "Real comment.", "Done.", NULL });
+    ok &= expect(A_SENTENCE_CHUNKER_FORMAT_GO, GO_FILE, (const char *const[]){
+        "Package x does things.", "It is small.", "Block.", "Two", NULL });
+    ok &= expect(A_SENTENCE_CHUNKER_FORMAT_RUST, RUST_FILE, (const char *const[]){
+        "Crate docs.", "More.", "Adds one.", "Returns\n/// the sum.",
+        "outer /* inner */ still outer.", "Tail.", NULL });
+    printf("%s: files\n", ok ? "PASS" : "FAIL");
+
+    a_sentence_chunker_options_t opts = chunk_check_options(A_SENTENCE_CHUNKER_FORMAT_C);
+    aml_buffer_t *first = aml_buffer_init(1024);
+    aml_buffer_t *second = aml_buffer_init(1024);
+    size_t num = 0, num2 = 0;
+    size_t len = strlen(C_FILE);
+    a_sentence_chunk_t *c = a_sentence_chunker_opts(&num, first, C_FILE, len, &opts);
+    a_sentence_chunk_t *r = a_rechunk_sentences_opts(&num2, second, C_FILE, c, num, 30, 80, &opts);
+    // Short chunks merge inside a paragraph, never across code or a blank comment line
+    static const char *const MERGED[] = {
+        "Parse a file. Returns 0 on success,\n * e.g. when the file exists.", "Trailing note. Two.",
+        "First line of a\n    // paragraph. Second one.", "New paragraph.", "inline. Block",
+        "Doc.", "Inner.", NULL
+    };
+    bool pass = true;
+    size_t k = 0;
+    for (; MERGED[k]; k++) {
+        pass &= k < num2 && r[k].length == strlen(MERGED[k]) &&
+                memcmp(C_FILE + r[k].start_offset, MERGED[k], r[k].length) == 0;
+    }
+    pass &= k == num2;
+    // A long paragraph splits between words, markers left out
+    aml_buffer_t *doc = aml_buffer_init(4096);
+    for (int line = 0; line < 40; line++) {
+        const char *text = line % 3 ? "    // words that wrap across lines and keep going\n"
+                                    : "    /// a much longer line of comment words, still one sentence\n";
+        aml_buffer_append(doc, text, strlen(text));
+    }
+    const char *text = aml_buffer_data(doc);
+    len = aml_buffer_length(doc);
+    for (size_t max = 20; max < 120 && pass; max += 7) {
+        c = a_sentence_chunker_opts(&num, first, text, len, &opts);
+        r = a_rechunk_sentences_opts(&num2, second, text, c, num, 10, max, &opts);
+        pass = num == 1 && num2 > 1 && well_formed(text, len, r, num2, true);
+    }
+    aml_buffer_destroy(doc);
+    printf("%s: rechunk\n", pass ? "PASS" : "FAIL");
+    ok &= pass;
+
+    // Random code over the bytes that matter
+    static const char *PIECES[] = {
+        "//", "/*", "*/", "///", "#", "\"", "'", "`", "\"\"\"", "'''", "r#\"", "\"#", "R\"(", ")\"",
+        "\\", "\n", "\n", " ", "  ", "x", "Word", "end. ", "Next", "e.g. ", "1'0", "'a", "!", "*"
+    };
+    static const a_sentence_chunker_format_t FORMATS[] = {
+        A_SENTENCE_CHUNKER_FORMAT_C, A_SENTENCE_CHUNKER_FORMAT_PYTHON,
+        A_SENTENCE_CHUNKER_FORMAT_GO, A_SENTENCE_CHUNKER_FORMAT_RUST
+    };
+    uint64_t x = 0x9E3779B97F4A7C15ull;
+    char buf[256];
+    pass = true;
+    for (int it = 0; it < 200000 && pass; it++) {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        size_t n = 0, pieces = x % 40;
+        opts.format = FORMATS[(x >> 32) % 4];
+        for (size_t p = 0; p < pieces; p++) {
+            x ^= x << 13;
+            x ^= x >> 7;
+            x ^= x << 17;
+            const char *piece = PIECES[(x >> 20) % (sizeof(PIECES) / sizeof(PIECES[0]))];
+            size_t pn = strlen(piece);
+            memcpy(buf + n, piece, pn);
+            n += pn;
+        }
+        c = a_sentence_chunker_opts(&num, first, buf, n, &opts);
+        pass = well_formed(buf, n, c, num, false);
+        r = a_rechunk_sentences_opts(&num2, second, buf, c, num, 5, 20, &opts);
+        pass = pass && well_formed(buf, n, r, num2, false);
+        if (!pass) printf("  random code %d: %.*s\n", it, (int)n, buf);
+    }
+    printf("%s: well-formed chunks\n", pass ? "PASS" : "FAIL");
+    ok &= pass;
+
+    aml_buffer_destroy(first);
+    aml_buffer_destroy(second);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,269 @@
+// SPDX-FileCopyrightText: 2025 Andy Curtis <contactandyc@gmail.com>
+// SPDX-FileCopyrightText: 2024–2025 Knode.ai — technical questions: contact Andy (above)
+// SPDX-License-Identifier: Apache-2.0
+
+#include <stdlib.h>
+#include <string.h>
+#include "corpus_gen.h"
+
+const char *corpus_profile_names[] = {
+    "prose", "abbrev", "numeric", "lists", "nospace", "cjk",
+    "crlf", "dotted", "longtail", "mixed", NULL
+};
+
+static const char *SYLLABLES[] = {
+    "ka", "lo", "mi", "ren", "sa", "tor", "ve", "dan", "el", "is",
+    "on", "ut", "pra", "qui", "ber", "cho", "ga", "hin", "jo", "ny"
+};
+#define NUM_SYLLABLES (sizeof(SYLLABLES) / sizeof(SYLLABLES[0]))
+
+static const char *ABBREVIATIONS[] = {
+    "Mr.", "Mrs.", "Dr.", "St.", "etc.", "i.e.", "e.g.", "vs.", "Inc.",
+    "Corp.", "Ltd.", "Co.", "Jr.", "Sr.", "Ph.D.", "Fig.", "No.", "A."
+};
+#define NUM_ABBREVIATIONS (sizeof(ABBREVIATIONS) / sizeof(ABBREVIATIONS[0]))
+
+static const char *CLOSERS[] = { "\"", "')", "]", ")", "\")" };
+#define NUM_CLOSERS (sizeof(CLOSERS) / sizeof(CLOSERS[0]))
+
+static const char NOSPACE_CHARS[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/=-_";
+
+struct corpus_gen_s {
+    corpus_profile_t p;
+    uint64_t state;
+};
+
+// ----------------------------------------------------------------------------
+//                          HELPER FUNCTIONS
+// ----------------------------------------------------------------------------
+
+/* splitmix64: tiny, fast, identical output on every platform. */
+static inline uint64_t next_u64(corpus_gen_t *g) {
+    uint64_t z = (g->state += 0x9e3779b97f4a7c15ull);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+static inline uint64_t below(corpus_gen_t *g, uint64_t n) {
+    return n ? next_u64(g) % n : 0;
+}
+
+static inline bool chance(corpus_gen_t *g, unsigned per_mille) {
+    return below(g, 1000) < per_mille;
+}
+
+static void append_newline(corpus_gen_t *g, aml_buffer_t *bh) {
+    if (g->p.crlf) aml_buffer_appendc(bh, '\r');
+    aml_buffer_appendc(bh, '\n');
+}
+
+static void append_word(corpus_gen_t *g, aml_buffer_t *bh, bool capitalize) {
+    size_t start = aml_buffer_length(bh);
+    unsigned syllables = 1 + (unsigned)below(g, 3);
+    for (unsigned s = 0; s < syllables; s++) {
+        aml_buffer_appends(bh, SYLLABLES[below(g, NUM_SYLLABLES)]);
+    }
+    if (capitalize) {
+        char *w = aml_buffer_data(bh) + start;
+        w[0] = (char)(w[0] - 'a' + 'A');
+    }
+}
+
+static void append_number(corpus_gen_t *g, aml_buffer_t *bh) {
+    aml_buffer_appendf(bh, "%llu.%llu",
+                       (unsigned long long)below(g, 10000),
+                       (unsigned long long)below(g, 1000));
+}
+
+static void append_nospace(corpus_gen_t *g, aml_buffer_t *bh) {
+    if (chance(g, 500)) {
+        aml_buffer_appends(bh, "https://example.com/");
+    }
+    for (unsigned i = 0; i < g->p.nospace_length; i++) {
+        aml_buffer_appendc(bh, NOSPACE_CHARS[below(g, sizeof(NOSPACE_CHARS) - 1)]);
+    }
+}
+
+/* Tokens that stress the backward walks and punctuation runs. */
+static void append_dotted(corpus_gen_t *g, aml_buffer_t *bh) {
+    switch (below(g, 4)) {
+    case 0: { // a.b.c.d.e...
+        unsigned parts = 3 + (unsigned)below(g, 12);
+        for (unsigned i = 0; i < parts; i++) {
+            if (i) aml_buffer_appendc(bh, '.');
+            aml_buffer_appendc(bh, (char)('a' + below(g, 26)));
+        }
+        break;
+    }
+    case 1: // version strings
+        aml_buffer_appendf(bh, "v%llu.%llu.%llu.%llu",
+                           (unsigned long long)below(g, 10), (unsigned long long)below(g, 100),
+                           (unsigned long long)below(g, 100), (unsigned long long)below(g, 1000));
+        break;
+    case 2: // long punctuation runs
+        aml_buffer_appendn(bh, '.', 4 + (size_t)below(g, 60));
+        break;
+    default: // U.S.A. style initialisms
+        for (unsigned i = 0, n = 2 + (unsigned)below(g, 4); i < n; i++) {
+            aml_buffer_appendc(bh, (char)('A' + below(g, 26)));
+            aml_buffer_appendc(bh, '.');
+        }
+        break;
+    }
+}
+
+static unsigned sentence_words(corpus_gen_t *g) {
+    unsigned mean = g->p.mean_sentence_words ? g->p.mean_sentence_words : 1;
+    switch (g->p.length_dist) {
+    case CORPUS_LEN_UNIFORM:
+        return 1 + (unsigned)below(g, 2 * mean);
+    case CORPUS_LEN_GEOMETRIC: {
+        unsigned n = 1;
+        while (n < 20 * mean && below(g, mean) != 0) n++;
+        return n;
+    }
+    case CORPUS_LEN_BIMODAL:
+        return chance(g, 700) ? 3 : 4 * mean;
+    default:
+        return mean;
+    }
+}
+
+static void append_cjk_sentence(corpus_gen_t *g, aml_buffer_t *bh) {
+    unsigned chars = 4 + (unsigned)below(g, 4 * (g->p.mean_sentence_words + 1));
+    for (unsigned i = 0; i < chars; i++) {
+        unsigned cp = 0x4E00 + (unsigned)below(g, 0x9FFF - 0x4E00);
+        aml_buffer_appendc(bh, (char)(0xE0 | (cp >> 12)));
+        aml_buffer_appendc(bh, (char)(0x80 | ((cp >> 6) & 0x3F)));
+        aml_buffer_appendc(bh, (char)(0x80 | (cp & 0x3F)));
+    }
+    aml_buffer_appends(bh, "\xE3\x80\x82"); // U+3002 ideographic full stop
+}
+
+static void append_sentence(corpus_gen_t *g, aml_buffer_t *bh) {
+    if (chance(g, g->p.cjk_rate)) {
+        append_cjk_sentence(g, bh);
+        return;
+    }
+    unsigned words = sentence_words(g);
+    for (unsigned w = 0; w < words; w++) {
+        if (w) aml_buffer_appendc(bh, ' ');
+        if (chance(g, g->p.abbrev_rate)) {
+            aml_buffer_appends(bh, ABBREVIATIONS[below(g, NUM_ABBREVIATIONS)]);
+        } else if (chance(g, g->p.decimal_rate)) {
+            append_number(g, bh);
+        } else if (chance(g, g->p.nospace_rate)) {
+            append_nospace(g, bh);
+        } else if (chance(g, g->p.dotted_rate)) {
+            append_dotted(g, bh);
+        } else {
+            append_word(g, bh, w == 0);
+        }
+    }
+    uint64_t end = below(g, 20);
+    aml_buffer_appends(bh, end < 15 ? "." : end < 17 ? "?" : end < 19 ? "!" : "...");
+    if (chance(g, g->p.closer_rate)) {
+        aml_buffer_appends(bh, CLOSERS[below(g, NUM_CLOSERS)]);
+    }
+}
+
+// ----------------------------------------------------------------------------
+//                                 PUBLIC API
+// ----------------------------------------------------------------------------
+
+bool corpus_profile_preset(corpus_profile_t *p, const char *name, uint64_t seed) {
+    memset(p, 0, sizeof(*p));
+    p->seed = seed;
+    p->mean_sentence_words = 14;
+    p->length_dist = CORPUS_LEN_UNIFORM;
+    p->sentences_per_paragraph = 5;
+    p->abbrev_rate = 5;
+    p->decimal_rate = 5;
+    p->nospace_length = 48;
+    p->closer_rate = 30;
+
+    if (!strcmp(name, "prose")) {
+        // defaults
+    } else if (!strcmp(name, "abbrev")) {
+        p->abbrev_rate = 200;
+    } else if (!strcmp(name, "numeric")) {
+        p->decimal_rate = 250;
+    } else if (!strcmp(name, "lists")) {
+        p->ordinal_list_rate = 600;
+    } else if (!strcmp(name, "nospace")) {
+        p->nospace_rate = 80;
+        p->nospace_length = 2048;
+    } else if (!strcmp(name, "cjk")) {
+        p->cjk_rate = 800;
+    } else if (!strcmp(name, "crlf")) {
+        p->crlf = true;
+        p->sentences_per_paragraph = 2;
+    } else if (!strcmp(name, "dotted")) {
+        p->dotted_rate = 150;
+    } else if (!strcmp(name, "longtail")) {
+        p->length_dist = CORPUS_LEN_GEOMETRIC;
+        p->mean_sentence_words = 30;
+    } else if (!strcmp(name, "mixed")) {
+        p->length_dist = CORPUS_LEN_BIMODAL;
+        p->abbrev_rate = 40;
+        p->decimal_rate = 40;
+        p->ordinal_list_rate = 100;
+        p->nospace_rate = 5;
+        p->nospace_length = 256;
+        p->cjk_rate = 50;
+        p->dotted_rate = 20;
+        p->crlf = (seed & 1) != 0;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+corpus_gen_t *corpus_gen_init(const corpus_profile_t *p) {
+    corpus_gen_t *g = (corpus_gen_t *)calloc(1, sizeof(*g));
+    g->p = *p;
+    g->state = p->seed;
+    return g;
+}
+
+void corpus_gen_destroy(corpus_gen_t *g) {
+    free(g);
+}
+
+void corpus_gen_paragraph(corpus_gen_t *g, aml_buffer_t *bh) {
+    unsigned n = 1 + (unsigned)below(g, 2 * g->p.sentences_per_paragraph);
+    if (chance(g, g->p.ordinal_list_rate)) {
+        for (unsigned i = 1; i <= n; i++) {
+            aml_buffer_appendf(bh, "%u. ", i);
+            // list items frequently start in lowercase
+            size_t start = aml_buffer_length(bh);
+            append_sentence(g, bh);
+            char *c = aml_buffer_data(bh) + start;
+            if (*c >= 'A' && *c <= 'Z' && chance(g, 500)) *c = (char)(*c - 'A' + 'a');
+            append_newline(g, bh);
+        }
+    } else {
+        for (unsigned i = 0; i < n; i++) {
+            if (i) aml_buffer_appendc(bh, ' ');
+            append_sentence(g, bh);
+        }
+        append_newline(g, bh);
+    }
+    append_newline(g, bh);
+}
+
+char *corpus_generate(const corpus_profile_t *p, size_t bytes) {
+    corpus_gen_t *g = corpus_gen_init(p);
+    aml_buffer_t *bh = aml_buffer_init(bytes + 4096);
+    while (aml_buffer_length(bh) < bytes) {
+        corpus_gen_paragraph(g, bh);
+    }
+    char *out = (char *)malloc(bytes + 1);
+    memcpy(out, aml_buffer_data(bh), bytes);
+    out[bytes] = '\0';
+    aml_buffer_destroy(bh);
+    corpus_gen_destroy(g);
+    return out;
+}
@@ -0,0 +1,65 @@
+// SPDX-FileCopyrightText: 2025 Andy Curtis <contactandyc@gmail.com>
+// SPDX-FileCopyrightText: 2024–2025 Knode.ai — technical questions: contact Andy (above)
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _corpus_gen_h
+#define _corpus_gen_h
+
+/*
+   Deterministic synthetic corpus generator for benchmarks and stress tests.
+
+   The same profile and seed always produce the same bytes on every
+   platform (the generator only uses its own 64-bit PRNG and integer math
+   for every decision), so performance numbers taken on generated corpora
+   are reproducible offline at any size.
+*/
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "a-memory-library/aml_buffer.h"
+
+typedef enum {
+    CORPUS_LEN_FIXED = 0,  // every sentence has mean_sentence_words words
+    CORPUS_LEN_UNIFORM,    // uniform in [1, 2 * mean]
+    CORPUS_LEN_GEOMETRIC,  // long tail, capped at 20 * mean
+    CORPUS_LEN_BIMODAL     // mix of 3-word and 4 * mean word sentences
+} corpus_length_dist_t;
+
+/* Rates are per mille (0..1000) so decisions stay in integer math. */
+typedef struct {
+    uint64_t seed;
+    unsigned mean_sentence_words;
+    corpus_length_dist_t length_dist;
+    unsigned sentences_per_paragraph;
+    unsigned abbrev_rate;       // word is an abbreviation ("Dr.", "e.g.")
+    unsigned decimal_rate;      // word is a decimal number ("3.14")
+    unsigned ordinal_list_rate; // paragraph is an ordinal list ("1. item")
+    unsigned nospace_rate;      // word is a whitespace-free run (URL/base64)
+    unsigned nospace_length;    // bytes per whitespace-free run
+    unsigned cjk_rate;          // sentence is CJK text ending in U+3002
+    unsigned dotted_rate;       // word is a pathological dotted token
+    unsigned closer_rate;       // sentence ends with a quote/bracket closer
+    bool crlf;                  // CRLF line endings
+} corpus_profile_t;
+
+/* Fill p with a named preset: prose, abbrev, numeric, lists, nospace, cjk,
+   crlf, dotted, longtail, mixed. Returns false for an unknown name. */
+bool corpus_profile_preset(corpus_profile_t *p, const char *name, uint64_t seed);
+
+/* NULL-terminated list of preset names. */
+extern const char *corpus_profile_names[];
+
+typedef struct corpus_gen_s corpus_gen_t;
+
+corpus_gen_t *corpus_gen_init(const corpus_profile_t *p);
+void corpus_gen_destroy(corpus_gen_t *g);
+
+/* Append the next paragraph (including its trailing blank line). */
+void corpus_gen_paragraph(corpus_gen_t *g, aml_buffer_t *bh);
+
+/* Generate exactly `bytes` bytes (the last paragraph is cut) into a
+   malloc'd NUL-terminated string. */
+char *corpus_generate(const corpus_profile_t *p, size_t bytes);
+
+#endif
@@ -0,0 +1,164 @@
+// SPDX-FileCopyrightText: 2025 Andy Curtis <contactandyc@gmail.com>
+// SPDX-FileCopyrightText: 2024–2025 Knode.ai — technical questions: contact Andy (above)
+// SPDX-License-Identifier: Apache-2.0
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "a-sentence-chunker-library/a_sentence_chunker.h"
+#include "a-sentence-chunker-library/a_sentence_chunker_counters.h"
+#include "read_file.h"
+
+static const char *split_names[A_SPLIT_HEURISTIC_COUNT] = {
+    "1  (double newline)",
+    "1b (3 whitespace)",
+    "2  (newline)",
+    "3  (punct + upper)",
+    "4  (whitespace)",
+    "fallback",
+    "none"
+};
+
+static void print_counters(const char *name, size_t bytes,
+                           const a_sentence_chunker_counters_t *c)
+{
+    printf("\n=== %s (%zu bytes) ===\n", name, bytes);
+    printf("punctuation runs      %llu\n", (unsigned long long)c->punct_runs);
+    printf("  boundaries          %llu\n", (unsigned long long)c->boundaries);
+    printf("  decimal skips       %llu\n", (unsigned long long)c->decimal_skips);
+    printf("  ordinal skips       %llu\n", (unsigned long long)c->ordinal_skips);
+    printf("  abbrev: next alpha  %llu\n", (unsigned long long)c->abbrev_next_alpha);
+    printf("  abbrev: single upper %llu\n", (unsigned long long)c->abbrev_single_upper);
+    printf("  abbrev: single letter %llu\n", (unsigned long long)c->abbrev_single_letter);
+    for (size_t i = 0; a_sentence_chunker_counters_abbreviation(i); i++) {
+        if (c->abbrev_hits[i]) {
+            printf("  abbrev: %-11s %llu\n", a_sentence_chunker_counters_abbreviation(i),
+                   (unsigned long long)c->abbrev_hits[i]);
+        }
+    }
+    printf("split calls           %llu\n", (unsigned long long)c->split_calls);
+    for (int h = 0; h < A_SPLIT_HEURISTIC_COUNT; h++) {
+        printf("  heuristic %-20s %llu\n", split_names[h],
+               (unsigned long long)c->split_heuristic[h]);
+    }
+    printf("backward walk bytes   %llu (%.3f per input byte)\n",
+           (unsigned long long)c->backward_walk_bytes,
+           bytes ? (double)c->backward_walk_bytes / (double)bytes : 0.0);
+}
+
+/* Internal consistency of the counters for one corpus. */
+static int check(const a_sentence_chunker_counters_t *c) {
+    uint64_t splits = 0;
+    for (int h = 0; h < A_SPLIT_HEURISTIC_COUNT; h++) {
+        splits += c->split_heuristic[h];
+    }
+    uint64_t skips = c->decimal_skips + c->ordinal_skips + c->abbrev_next_alpha +
+                     c->abbrev_single_upper + c->abbrev_single_letter;
+    for (size_t i = 0; i < A_SENTENCE_CHUNKER_COUNTERS_MAX_ABBREVS; i++) {
+        skips += c->abbrev_hits[i];
+    }
+    return splits == c->split_calls && c->boundaries + skips == c->punct_runs;
+}
+
+#define RESET_THREADS 4
+#define RESET_RUNS    200
+
+typedef struct {
+    const char *text;
+    size_t length;
+} job_t;
+
+static void *chunk_runs(void *arg) {
+    const job_t *job = (const job_t *)arg;
+    aml_buffer_t *bh = aml_buffer_init(32);
+    for (int r = 0; r < RESET_RUNS; r++) {
+        size_t n = 0;
+        a_sentence_chunker_len(&n, bh, job->text, job->length);
+    }
+    aml_buffer_destroy(bh);
+    return NULL;
+}
+
+/*
+   Resetting while other threads chunk: snapshots never exceed the work
+   done, a reset once they are idle reads zero, and one more run counts
+   exactly one run.
+*/
+static int check_concurrent_reset(const char *text, size_t length) {
+    aml_buffer_t *bh = aml_buffer_init(32);
+    size_t n = 0;
+    a_sentence_chunker_counters_reset();
+    a_sentence_chunker_len(&n, bh, text, length);
+    a_sentence_chunker_counters_t one;
+    a_sentence_chunker_counters_snapshot(&one);
+
+    job_t job = { text, length };
+    pthread_t threads[RESET_THREADS];
+    for (int t = 0; t < RESET_THREADS; t++) {
+        pthread_create(&threads[t], NULL, chunk_runs, &job);
+    }
+    a_sentence_chunker_counters_t c;
+    int ok = 1;
+    for (int r = 0; r < 100; r++) {
+        a_sentence_chunker_counters_reset();
+        a_sentence_chunker_counters_snapshot(&c);
+        ok &= c.punct_runs <= one.punct_runs * RESET_THREADS * RESET_RUNS;
+    }
+    for (int t = 0; t < RESET_THREADS; t++) {
+        pthread_join(threads[t], NULL);
+    }
+
+    a_sentence_chunker_counters_reset();
+    a_sentence_chunker_counters_snapshot(&c);
+    ok &= c.punct_runs == 0 && c.split_calls == 0;
+    a_sentence_chunker_len(&n, bh, text, length);
+    a_sentence_chunker_counters_snapshot(&c);
+    ok &= memcmp(&c, &one, sizeof(c)) == 0;
+    aml_buffer_destroy(bh);
+    printf("%s: reset while other threads chunk\n", ok ? "PASS" : "FAIL");
+    return ok;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s <text file> [text file ...]\n", argv[0]);
+        return 1;
+    }
+    if (!a_sentence_chunker_counters_enabled()) {
+        printf("Library built without counters (A_BUILD_ENABLE_COUNTERS=OFF).\n");
+        return 0;
+    }
+
+    int ok = 1;
+    aml_buffer_t *bh1 = aml_buffer_init(32);
+    aml_buffer_t *bh2 = aml_buffer_init(32);
+    for (int a = 1; a < argc; a++) {
+        size_t length = 0;
+        char *content = read_file(argv[a], &length);
+        if (!content) {
+            ok = 0;
+            continue;
+        }
+        a_sentence_chunker_counters_reset();
+
+        size_t n1 = 0, n2 = 0;
+        a_sentence_chunk_t *first = a_sentence_chunker_len(&n1, bh1, content, length);
+        a_rechunk_sentences(&n2, bh2, content, first, n1, 20, 80);
+
+        a_sentence_chunker_counters_t c;
+        a_sentence_chunker_counters_snapshot(&c);
+        print_counters(argv[a], length, &c);
+        if (!check(&c)) {
+            printf("FAIL: counters are inconsistent\n");
+            ok = 0;
+        }
+        if (a == 1) {
+            ok &= check_concurrent_reset(content, length);
+        }
+        free(content);
+    }
+    aml_buffer_destroy(bh1);
+    aml_buffer_destroy(bh2);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,141 @@
+// SPDX-FileCopyrightText: 2025 Andy Curtis <contactandyc@gmail.com>
+// SPDX-FileCopyrightText: 2024–2025 Knode.ai — technical questions: contact Andy (above)
+// SPDX-License-Identifier: Apache-2.0
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "a-sentence-chunker-library/a_sentence_chunker.hpp"
+
+extern "C" {
+#include "read_file.h"
+#include "corpus_gen.h"
+}
+
+/*
+   C++ API test: the default-policy lazy range must reproduce the C first
+   pass exactly; contexts must match the C calls and survive moves; the
+   custom policies must change exactly what they claim to.
+*/
+
+static_assert(std::ranges::forward_range<a_sc::basic_sentence_range<>>);
+static_assert(std::ranges::view<a_sc::basic_sentence_range<>>);
+static_assert(std::ranges::random_access_range<a_sc::sentence_view>);
+static_assert(!std::is_copy_constructible_v<a_sc::context>);
+static_assert(std::is_nothrow_move_constructible_v<a_sc::context>);
+static_assert(std::is_nothrow_move_assignable_v<a_sc::context>);
+
+// The scanner is constexpr: sentences can be counted at compile time
+static constexpr std::size_t count_sentences(std::string_view text) {
+    std::size_t n = 0;
+    for (std::string_view s : a_sc::sentences(text)) n += !s.empty();
+    return n;
+}
+static_assert(count_sentences("Dr. Smith paid $3.14. Then:\n1. item\nDone!") == 2);
+
+static const char *PROFILES[] = { "prose", "abbrev", "numeric", "lists", "nospace",
+                                  "cjk", "crlf", "dotted", "mixed" };
+
+static bool same(std::span<const a_sentence_chunk_t> a, const a_sentence_chunk_t *b, size_t nb) {
+    if (a.size() != nb) return false;
+    for (size_t k = 0; k < nb; k++) {
+        if (a[k].start_offset != b[k].start_offset || a[k].length != b[k].length) return false;
+    }
+    return true;
+}
+
+static bool check_text(const char *name, std::string_view text) {
+    aml_buffer_t *bh1 = aml_buffer_init(1024);
+    aml_buffer_t *bh2 = aml_buffer_init(1024);
+    size_t n1 = 0, n2 = 0;
+    a_sentence_chunk_t *ref = a_sentence_chunker_len(&n1, bh1, text.data(), text.size());
+    a_sentence_chunk_t *ref2 = a_rechunk_sentences(&n2, bh2, text.data(), ref, n1, 40, 240);
+
+    std::vector<a_sentence_chunk_t> lazy;
+    auto range = a_sc::sentences(text);
+    for (auto it = range.begin(); it != range.end(); ++it) lazy.push_back(it.chunk());
+    bool ok = same(lazy, ref, n1);
+
+    // A non-default policy with the same settings takes the C++ scan path
+    using same_as_default = a_sc::policy<a_sc::english_abbreviations,
+                                         a_sc::terminators<'!', '?', '.'>>;
+    a_sc::basic_context<same_as_default> cpp_ctx;
+    ok &= same(cpp_ctx.chunk(text).chunks(), ref, n1);
+
+    a_sc::context ctx;
+    a_sc::context moved(std::move(ctx));
+    a_sc::sentence_view first = moved.chunk(text);
+    ok &= same(first.chunks(), ref, n1);
+    for (size_t k = 0; ok && k < first.size(); k++) {
+        ok = first[k].data() == text.data() + ref[k].start_offset && first[k].size() == ref[k].length;
+    }
+    ctx = std::move(moved);
+    ok &= same(ctx.rechunk(text, 40, 240).chunks(), ref2, n2);
+
+    std::printf("%s: %s (%zu sentences)\n", ok ? "PASS" : "FAIL", name, n1);
+    aml_buffer_destroy(bh1);
+    aml_buffer_destroy(bh2);
+    return ok;
+}
+
+struct legal_abbreviations {
+    static constexpr std::array<std::string_view, 2> words = { "Sec", "Art" };
+};
+
+template <class Policy>
+static std::vector<std::string> split(std::string_view text) {
+    std::vector<std::string> out;
+    for (std::string_view s : a_sc::sentences<Policy>(text)) out.emplace_back(s);
+    return out;
+}
+
+static bool check_policies() {
+    bool ok = true;
+    using none = a_sc::policy<a_sc::no_abbreviations>;
+    ok &= split<a_sc::default_policy>("Mr. Smith left. Bye.").size() == 2;
+    ok &= split<none>("Mr. Smith left. Bye.").size() == 3;
+
+    using semicolon = a_sc::policy<a_sc::english_abbreviations, a_sc::terminators<'.', '?', '!', ';'>>;
+    ok &= split<a_sc::default_policy>("one; two; three.").size() == 1;
+    ok &= split<semicolon>("one; two; three.").size() == 3;
+
+    using legal = a_sc::policy<legal_abbreviations>;
+    ok &= split<legal>("See Sec. 4 of the act. Done.").size() == 2;
+    ok &= split<a_sc::default_policy>("See Sec. 4 of the act. Done.").size() == 3;
+
+    using unicode = a_sc::policy<a_sc::english_abbreviations, a_sc::default_terminators, a_sc::utf8>;
+    std::string_view cjk = "\xE4\xBD\xA0\xE5\xA5\xBD\xE3\x80\x82\xE4\xB8\x96\xE7\x95\x8C\xEF\xBC\x81";
+    ok &= split<a_sc::default_policy>(cjk).size() == 1;
+    auto parts = split<unicode>(cjk);
+    ok &= parts.size() == 2 && parts[0] == "\xE4\xBD\xA0\xE5\xA5\xBD\xE3\x80\x82";
+    // A UTF-8 letter right after '.' marks an abbreviation, like "e.g"
+    ok &= split<a_sc::default_policy>("ab.\xC3\xA9t\xC3\xA9 ok. Fin.").size() == 3;
+    ok &= split<unicode>("ab.\xC3\xA9t\xC3\xA9 ok. Fin.").size() == 2;
+
+    std::printf("%s: policies\n", ok ? "PASS" : "FAIL");
+    return ok;
+}
+
+int main(int argc, char *argv[]) {
+    bool ok = check_policies();
+    ok &= check_text("empty", std::string_view());
+    for (const char *name : PROFILES) {
+        corpus_profile_t profile;
+        corpus_profile_preset(&profile, name, 64);
+        size_t len = 1u << 20;
+        char *text = corpus_generate(&profile, len);
+        ok &= check_text(name, std::string_view(text, len));
+        std::free(text);
+    }
+    for (int a = 1; a < argc; a++) {
+        size_t len = 0;
+        char *text = read_file(argv[a], &len);
+        if (!text) return 1;
+        ok &= check_text(argv[a], std::string_view(text, len));
+        std::free(text);
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,158 @@
+// SPDX-FileCopyrightText: 2025 Andy Curtis <contactandyc@gmail.com>
+// SPDX-FileCopyrightText: 2024–2025 Knode.ai — technical questions: contact Andy (above)
+// SPDX-License-Identifier: Apache-2.0
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <string>
+#include <vector>
+#include "a-sentence-chunker-library/a_sentence_chunker_coro.hpp"
+
+extern "C" {
+#include "corpus_gen.h"
+}
+
+/*
+   Coroutine test: the blocking generator and the async generator must
+   yield exactly the one-shot sentences. The async source completes every
+   read later from a manual event loop, so the producer is suspended (not
+   blocked) across each read.
+*/
+
+static std::vector<std::string> one_shot(std::string_view text) {
+    aml_buffer_t *bh = aml_buffer_init(1024);
+    size_t n = 0;
+    a_sentence_chunk_t *c = a_sentence_chunker_len(&n, bh, text.data(), text.size());
+    std::vector<std::string> out;
+    for (size_t k = 0; k < n; k++) out.emplace_back(text.substr(c[k].start_offset, c[k].length));
+    aml_buffer_destroy(bh);
+    return out;
+}
+
+/* Hands out text in pieces of varying size. */
+struct piece_reader {
+    std::string_view text;
+    size_t pos = 0;
+    size_t turn = 0;
+    size_t read(std::span<char> buf) {
+        static const size_t SIZES[] = { 1, 13, 700, 4096, 9 };
+        size_t n = std::min({ buf.size(), text.size() - pos, SIZES[turn++ % 5] });
+        std::copy_n(text.data() + pos, n, buf.data());
+        pos += n;
+        return n;
+    }
+};
+
+// ---- a toy event loop and async source ----
+
+static std::deque<std::coroutine_handle<>> ready;
+
+struct async_source {
+    piece_reader reader;
+    size_t suspensions = 0;
+
+    struct read_op {
+        async_source *src;
+        std::span<char> buf;
+        size_t n = 0;
+        bool await_ready() noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> h) {
+            src->suspensions++;
+            n = src->reader.read(buf); // "completes" on a later loop turn
+            ready.push_back(h);
+        }
+        size_t await_resume() noexcept { return n; }
+    };
+    read_op read(std::span<char> buf) { return read_op{ this, buf }; }
+};
+
+/* Fire-and-forget consumer coroutine */
+struct task {
+    struct promise_type {
+        task get_return_object() noexcept { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() { std::terminate(); }
+    };
+};
+
+static task consume(async_source &src, std::vector<std::string> &out, bool &done) {
+    auto gen = a_sc::async_sentences(src, 0, 512);
+    while (const std::string_view *s = co_await gen.next()) out.emplace_back(*s);
+    done = true;
+}
+
+static bool check(const char *name, std::string_view text) {
+    std::vector<std::string> ref = one_shot(text);
+
+    std::vector<std::string> sync;
+    auto read = [r = piece_reader{ text }](std::span<char> buf) mutable { return r.read(buf); };
+    for (std::string_view s : a_sc::read_sentences(read, 0, 512)) sync.emplace_back(s);
+
+    async_source src{ piece_reader{ text } };
+    std::vector<std::string> async;
+    bool done = false;
+    consume(src, async, done);
+    size_t turns = 0;
+    while (!ready.empty()) {
+        std::coroutine_handle<> h = ready.front();
+        ready.pop_front();
+        h.resume();
+        turns++;
+    }
+
+    bool ok = sync == ref && async == ref && done && src.suspensions == turns && turns > 0;
+    std::printf("%s: %s (%zu sentences, %zu suspended reads)\n", ok ? "PASS" : "FAIL", name,
+                ref.size(), turns);
+    return ok;
+}
+
+static bool check_stream() {
+    a_sc::stream s(64);
+    a_sc::stream moved(std::move(s));
+    std::vector<std::string> got;
+    for (std::string_view v : moved.feed("One. Two")) got.emplace_back(v);
+    bool ok = got.size() == 1 && got[0] == "One.";
+    for (std::string_view v : moved.feed("! Three")) got.emplace_back(v);
+    ok &= got.size() == 2;
+    for (std::string_view v : moved.finish()) got.emplace_back(v);
+    ok &= got.size() == 3 && got[1] == "Two!" && got[2] == "Three";
+    ok &= moved.feed("ignored. after finish").empty();
+    std::printf("%s: stream\n", ok ? "PASS" : "FAIL");
+    return ok;
+}
+
+/* Default arguments bound memory (max_pending plus one read) on input that
+   never ends a sentence. */
+static bool check_default_bound() {
+    std::string text;
+    while (text.size() < 4 * a_sc::default_max_pending) text += "word ";
+    auto read = [r = piece_reader{ text }](std::span<char> buf) mutable { return r.read(buf); };
+    size_t sentences = 0, longest = 0;
+    for (std::string_view s : a_sc::read_sentences(read)) {
+        sentences++;
+        longest = std::max(longest, s.size());
+    }
+    bool ok = sentences > 1 && longest <= a_sc::default_max_pending + a_sc::default_read_size;
+    std::printf("%s: default bound (%zu sentences, longest %zu)\n", ok ? "PASS" : "FAIL",
+                sentences, longest);
+    return ok;
+}
+
+int main() {
+    bool ok = check_stream();
+    ok &= check_default_bound();
+    static const char *PROFILES[] = { "prose", "abbrev", "lists", "nospace", "cjk", "mixed" };
+    for (const char *name : PROFILES) {
+        corpus_profile_t profile;
+        corpus_profile_preset(&profile, name, 65);
+        size_t len = 256u << 10;
+        char *text = corpus_generate(&profile, len);
+        ok &= check(name, std::string_view(text, len));
+        std::free(text);
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,127 @@
+// SPDX-FileCopyrightText: 2025 Andy Curtis <contactandyc@gmail.com>
+// SPDX-FileCopyrightText: 2024–2025 Knode.ai — technical questions: contact Andy (above)
+// SPDX-License-Identifier: Apache-2.0
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "a-sentence-chunker-library/a_sentence_chunker.h"
+#include "corpus_gen.h"
+#include "read_file.h"
+
+/*
+   DFA engine test: A_SENTENCE_CHUNKER_ENGINE_DFA must give exactly the
+   rule engine's chunks, on every corpus profile, on the sample text, on
+   hand-picked edges (abbreviations with embedded NULs, 31/32-byte words,
+   ordinals waiting on the next word) and on random strings over the
+   bytes the rules care about.
+*/
+
+static const char *PROFILES[] = {
+    "prose", "abbrev", "numeric", "lists", "nospace", "cjk", "crlf", "dotted", "longtail", "mixed"
+};
+#define NUM_PROFILES (sizeof(PROFILES) / sizeof(PROFILES[0]))
+
+static aml_buffer_t *ref, *got;
+
+static int same(const char *text, size_t len) {
+    a_sentence_chunker_options_t opts;
+    memset(&opts, 0, sizeof(opts));
+    opts.engine = A_SENTENCE_CHUNKER_ENGINE_DFA;
+    size_t nr = 0, ng = 0;
+    a_sentence_chunk_t *r = a_sentence_chunker_len(&nr, ref, text, len);
+    a_sentence_chunk_t *g = a_sentence_chunker_opts(&ng, got, text, len, &opts);
+    if (nr != ng) return 0;
+    for (size_t k = 0; k < nr; k++) {
+        if (r[k].start_offset != g[k].start_offset || r[k].length != g[k].length) return 0;
+    }
+    return 1;
+}
+
+static void report(int *ok, int pass, const char *what) {
+    printf("%s: %s\n", pass ? "PASS" : "FAIL", what);
+    *ok &= pass;
+}
+
+int main(int argc, char *argv[]) {
+    ref = aml_buffer_init(1024);
+    got = aml_buffer_init(1024);
+    int ok = 1;
+
+    int pass = 1;
+    for (size_t p = 0; p < NUM_PROFILES && pass; p++) {
+        for (uint64_t seed = 1; seed <= 3 && pass; seed++) {
+            corpus_profile_t profile;
+            corpus_profile_preset(&profile, PROFILES[p], seed);
+            size_t len = 1u << 18;
+            char *corpus = corpus_generate(&profile, len);
+            pass = same(corpus, len);
+            if (!pass) printf("  profile %s seed %u differs\n", PROFILES[p], (unsigned)seed);
+            free(corpus);
+        }
+    }
+    report(&ok, pass, "corpus profiles");
+
+    if (argc > 1) {
+        size_t len = 0;
+        char *text = read_file(argv[1], &len);
+        pass = text != NULL;
+        // Every prefix length exercises each end-of-text lookahead
+        for (size_t n = 0; pass && n <= len && n < 4096; n++) pass = same(text, n);
+        pass = pass && same(text, len);
+        report(&ok, pass, argv[1]);
+        free(text);
+    }
+
+    static const char EDGES[][48] = {
+        "Mr. Smith. Dr.X", "mr. smith", "MRS. Jones went.", "e.g. this. i.e. that.",
+        "Ph.D. holder. PH.D. too", "Mr\0x. Next", "Mrs\0. Next", "\0. Next", "M\0. Next",
+        "1. next", "1. Next", "12.  \n 3", "1.2. Next", "a1. Next", "1.", "1.   ",
+        "3.14 is pi. ok", "x1.5 y", "A. B. c. d.e", "a. b", "a.b", "Hi!abc. Next",
+        "He said \"stop.\" Then", "Wait?!) ok", "(anyone?). Yes", "End.)]} \t\r\nNext",
+        "Hi.. There... ok?!? yes", "..  . ? !", "1.. next", "etc.)  next", "  lead. x"
+    };
+    pass = 1;
+    for (size_t e = 0; e < sizeof(EDGES) / sizeof(EDGES[0]) && pass; e++) {
+        // Edges may hold NULs, so try every length up to the buffer size
+        for (size_t n = 0; n <= sizeof(EDGES[e]) && pass; n++) pass = same(EDGES[e], n);
+        if (!pass) printf("  edge %zu differs\n", e);
+    }
+    // Words around the 32-byte abbreviation buffer
+    char word[80];
+    for (size_t w = 28; w < 36 && pass; w++) {
+        memset(word, 'M', w);
+        memcpy(word + w, ". next. A. b", 12);
+        pass = same(word, w + 12);
+        word[0] = 'm';
+        word[1] = 'r';
+        word[2] = '\0';
+        pass = pass && same(word, w + 12);
+    }
+    report(&ok, pass, "edges");
+
+    static const char ALPHABET[] = "  \t\n\r..!?\"')]}0129aAbemMrRsSdDtTcCeEgGiIpPhHx\0\xC3";
+    uint64_t x = 0x9E3779B97F4A7C15ull;
+    char text[96];
+    pass = 1;
+    for (int it = 0; it < 300000 && pass; it++) {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        size_t n = x % sizeof(text);
+        for (size_t k = 0; k < n; k++) {
+            x ^= x << 13;
+            x ^= x >> 7;
+            x ^= x << 17;
+            text[k] = ALPHABET[(x >> 20) % sizeof(ALPHABET)];
+        }
+        pass = same(text, n);
+        if (!pass) printf("  random string %d differs\n", it);
+    }
+    report(&ok, pass, "random strings");
+
+    aml_buffer_destroy(ref);
+    aml_buffer_destroy(got);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,91 @@
+// SPDX-FileCopyrightText: 2025 Andy Curtis <contactandyc@gmail.com>
+// SPDX-FileCopyrightText: 2024–2025 Knode.ai — technical questions: contact Andy (above)
+// SPDX-License-Identifier: Apache-2.0
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "corpus_gen.h"
+
+/*
+   gen_corpus: stream a deterministic synthetic corpus to stdout or a file.
+
+     gen_corpus --profile mixed --seed 42 --size 1G -o mixed.txt
+*/
+
+static size_t parse_size(const char *s) {
+    char *end = NULL;
+    double v = strtod(s, &end);
+    switch (end && *end ? *end : ' ') {
+    case 'k': case 'K': v *= 1024.0; break;
+    case 'm': case 'M': v *= 1024.0 * 1024.0; break;
+    case 'g': case 'G': v *= 1024.0 * 1024.0 * 1024.0; break;
+    default: break;
+    }
+    return (size_t)v;
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr, "Usage: %s [--profile NAME] [--seed N] [--size N[K|M|G]] [-o FILE]\n", prog);
+    fprintf(stderr, "Profiles:");
+    for (int i = 0; corpus_profile_names[i]; i++) {
+        fprintf(stderr, " %s", corpus_profile_names[i]);
+    }
+    fprintf(stderr, "\n");
+}
+
+int main(int argc, char *argv[]) {
+    const char *profile_name = "mixed";
+    const char *out_name = NULL;
+    uint64_t seed = 1;
+    size_t size = 1024 * 1024;
+
+    for (int a = 1; a < argc; a++) {
+        if (!strcmp(argv[a], "--profile") && a + 1 < argc) {
+            profile_name = argv[++a];
+        } else if (!strcmp(argv[a], "--seed") && a + 1 < argc) {
+            seed = strtoull(argv[++a], NULL, 10);
+        } else if (!strcmp(argv[a], "--size") && a + 1 < argc) {
+            size = parse_size(argv[++a]);
+        } else if (!strcmp(argv[a], "-o") && a + 1 < argc) {
+            out_name = argv[++a];
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    corpus_profile_t profile;
+    if (!corpus_profile_preset(&profile, profile_name, seed)) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    FILE *out = out_name ? fopen(out_name, "wb") : stdout;
+    if (!out) {
+        perror("fopen");
+        return 1;
+    }
+
+    // Stream paragraph batches so GB-scale corpora use constant memory
+    corpus_gen_t *g = corpus_gen_init(&profile);
+    aml_buffer_t *bh = aml_buffer_init(1 << 20);
+    size_t written = 0;
+    while (written < size) {
+        aml_buffer_clear(bh);
+        while (aml_buffer_length(bh) < (1 << 20)) {
+            corpus_gen_paragraph(g, bh);
+        }
+        size_t n = aml_buffer_length(bh);
+        if (n > size - written) n = size - written;
+        if (fwrite(aml_buffer_data(bh), 1, n, out) != n) {
+            perror("fwrite");
+            break;
+        }
+        written += n;
+    }
+    aml_buffer_destroy(bh);
+    corpus_gen_destroy(g);
+    if (out != stdout) fclose(out);
+    return written == size ? 0 : 1;
+}
@@ -0,0 +1,189 @@
+// SPDX-FileCopyrightText: 2025 Andy Curtis <contactandyc@gmail.com>
+// SPDX-FileCopyrightText: 2024–2025 Knode.ai — technical questions: contact Andy (above)
+// SPDX-License-Identifier: Apache-2.0
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "a_sentence_chunker_internal.h"
+
+/*
+   heuristics_bench: isolated microbenchmarks for the chunker's internal
+   heuristics over controlled inputs, so an optimization can be attributed
+   to the function it touched instead of guessed from end-to-end timings.
+
+     heuristics_bench [--filter SUBSTRING] [--min-ms N]
+
+   Built from src/a_sentence_chunker.c with
+   A_SENTENCE_CHUNKER_EXPOSE_INTERNALS (see a_sentence_chunker_internal.h).
+   Each case reports the best ns/call over several timed batches.
+*/
+
+#define BATCHES 5
+
+typedef struct {
+    const char *text;
+    size_t len;
+    size_t pos;     // position argument (the '.', candidate, ...)
+    size_t start;   // chunk start for the split helpers
+    size_t end;     // chunk end (exclusive) for the split helpers
+} bench_input_t;
+
+typedef size_t (*bench_fn_t)(const bench_input_t *in);
+
+typedef struct {
+    const char *name;
+    bench_fn_t fn;
+    bench_input_t in;
+} bench_case_t;
+
+static volatile size_t sink;
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+// ----------------------------------------------------------------------------
+//                               ADAPTERS
+// ----------------------------------------------------------------------------
+
+static size_t run_abbreviation(const bench_input_t *in) {
+    return matches_abbreviation(in->text, in->pos, in->len);
+}
+
+static size_t run_end_of_sentence(const bench_input_t *in) {
+    return is_end_of_sentence_heuristic(in->text, in->pos, in->len);
+}
+
+static size_t run_trailing_closers(const bench_input_t *in) {
+    return consume_trailing_closers(in->text, in->pos, in->len);
+}
+
+static size_t run_token_boundary(const bench_input_t *in) {
+    return adjust_for_token_boundary(in->text, in->start, in->end, in->pos);
+}
+
+static size_t run_split_point(const bench_input_t *in) {
+    // pos carries max_length; min_length is a quarter of it
+    return find_split_point(in->text, in->start, in->end - in->start, in->pos / 4, in->pos);
+}
+
+// ----------------------------------------------------------------------------
+//                                INPUTS
+// ----------------------------------------------------------------------------
+
+/* Input at the position of the last '.' in s. */
+static bench_input_t at_last_dot(const char *s) {
+    bench_input_t in = { s, strlen(s), 0, 0, 0 };
+    in.pos = (size_t)(strrchr(s, '.') - s);
+    return in;
+}
+
+static bench_input_t at_char(const char *s, char c) {
+    bench_input_t in = { s, strlen(s), 0, 0, 0 };
+    in.pos = (size_t)(strchr(s, c) - s);
+    in.end = in.len;
+    return in;
+}
+
+/* A token of token_len non-space bytes surrounded by words, candidate in
+   its middle. */
+static bench_input_t token_input(size_t token_len, bool spaces) {
+    size_t len = token_len + 64;
+    char *s = (char *)malloc(len + 1);
+    for (size_t i = 0; i < len; i++) {
+        s[i] = (spaces && (i < 32 || i >= 32 + token_len) && i % 6 == 5) ? ' ' : 'x';
+    }
+    s[len] = '\0';
+    bench_input_t in = { s, len, 32 + token_len / 2, 0, len };
+    return in;
+}
+
+/* Prose without sentence breaks (forces the deeper split heuristics) or
+   one whitespace-free run (the fallback). */
+static bench_input_t split_input(size_t len, size_t max_length, bool prose) {
+    static const char *words[] = { "lorem", "ipsum", "dolor", "sit", "amet", "consectetur" };
+    char *s = (char *)malloc(len + 1);
+    size_t n = 0, w = 0;
+    while (n < len) {
+        const char *word = prose ? words[w++ % 6] : "x";
+        for (const char *p = word; *p && n < len; p++) s[n++] = *p;
+        if (prose && n < len) s[n++] = ' ';
+    }
+    s[len] = '\0';
+    bench_input_t in = { s, len, max_length, 0, len };
+    return in;
+}
+
+// ----------------------------------------------------------------------------
+//                                 DRIVER
+// ----------------------------------------------------------------------------
+
+static double bench_ns_per_call(const bench_case_t *c, double min_ns) {
+    // Grow the batch until it runs for at least min_ns
+    size_t iters = 64;
+    for (;;) {
+        double t0 = now_ns();
+        for (size_t k = 0; k < iters; k++) sink += c->fn(&c->in);
+        if (now_ns() - t0 >= min_ns || iters >= ((size_t)1 << 30)) break;
+        iters *= 2;
+    }
+    double best = 0.0;
+    for (int b = 0; b < BATCHES; b++) {
+        double t0 = now_ns();
+        for (size_t k = 0; k < iters; k++) sink += c->fn(&c->in);
+        double ns = (now_ns() - t0) / (double)iters;
+        if (b == 0 || ns < best) best = ns;
+    }
+    return best;
+}
+
+int main(int argc, char *argv[]) {
+    const char *filter = NULL;
+    double min_ms = 20.0;
+    for (int a = 1; a < argc; a++) {
+        if (!strcmp(argv[a], "--filter") && a + 1 < argc) {
+            filter = argv[++a];
+        } else if (!strcmp(argv[a], "--min-ms") && a + 1 < argc) {
+            min_ms = strtod(argv[++a], NULL);
+        } else {
+            fprintf(stderr, "Usage: %s [--filter SUBSTRING] [--min-ms N]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    bench_case_t cases[] = {
+        { "abbreviation/known_short",    run_abbreviation, at_last_dot("See Dr. Smith") },
+        { "abbreviation/known_dotted",   run_abbreviation, at_last_dot("as in e.g. this") },
+        { "abbreviation/plain_word",     run_abbreviation, at_last_dot("the committee. Then") },
+        { "abbreviation/single_upper",   run_abbreviation, at_last_dot("John F. Kennedy") },
+        { "abbreviation/long_dotted",    run_abbreviation, at_last_dot("x a.b.c.d.e.f.g.h.i.j.k.l.m.n. Y") },
+        { "end_of_sentence/plain",       run_end_of_sentence, at_last_dot("It ended. Then") },
+        { "end_of_sentence/decimal",     run_end_of_sentence, at_last_dot("It was 3.14 then") },
+        { "end_of_sentence/ordinal",     run_end_of_sentence, at_last_dot("1. item") },
+        { "end_of_sentence/abbrev",      run_end_of_sentence, at_last_dot("Ask Mr. Brown") },
+        { "end_of_sentence/question",    run_end_of_sentence, at_char("Why? Because", '?') },
+        { "trailing_closers/none",       run_trailing_closers, at_char("end. Next", '.') },
+        { "trailing_closers/quote",      run_trailing_closers, at_char("end.\" Next", '.') },
+        { "trailing_closers/nested",     run_trailing_closers, at_char("end?!\")]} Next", '?') },
+        { "token_boundary/short_token",  run_token_boundary, token_input(8, true) },
+        { "token_boundary/long_token",   run_token_boundary, token_input(512, true) },
+        { "token_boundary/no_space",     run_token_boundary, token_input(4096, false) },
+        { "split_point/prose_1k",        run_split_point, split_input(1024, 256, true) },
+        { "split_point/prose_16k",       run_split_point, split_input(16384, 4096, true) },
+        { "split_point/nospace_1k",      run_split_point, split_input(1024, 256, false) },
+        { "split_point/nospace_16k",     run_split_point, split_input(16384, 4096, false) },
+    };
+    size_t num_cases = sizeof(cases) / sizeof(cases[0]);
+
+    printf("%-32s %12s\n", "case", "ns/call");
+    for (size_t i = 0; i < num_cases; i++) {
+        if (filter && !strstr(cases[i].name, filter)) continue;
+        printf("%-32s %12.2f\n", cases[i].name, bench_ns_per_call(&cases[i], min_ms * 1e6));
+    }
+    // token and split inputs are heap-allocated; freed at exit
+    return 0;
+}
@@ -0,0 +1,161 @@
+// SPDX-FileCopyrightText: 2025 Andy Curtis <contactandyc@gmail.com>
+// SPDX-FileCopyrightText: 2024–2025 Knode.ai — technical questions: contact Andy (above)
+// SPDX-License-Identifier: Apache-2.0
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "a-sentence-chunker-library/a_sentence_chunker.h"
+#include "chunk_check.h"
+#include "corpus_gen.h"
+
+/*
+   HTML test: A_SENTENCE_CHUNKER_FORMAT_HTML chunks raw markup in place.
+   Checks a sample page chunk by chunk (tags, comments, script and style
+   bodies, entities, block tags), that rechunking keeps blocks apart and
+   never splits inside a tag, that markup-free text chunks as plain text
+   does, and that chunks over random markup are ordered, non-empty,
+   inside the text and trimmed.
+*/
+
+static bool is_space(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+// Ordered, non-empty, in bounds, with no whitespace at either end
+static bool well_formed(const char *text, size_t len, const a_sentence_chunk_t *c, size_t num,
+                        bool trimmed)
+{
+    if (!chunk_check_ordered(len, c, num)) return false;
+    for (size_t k = 0; k < num && trimmed; k++) {
+        size_t end = c[k].start_offset + c[k].length;
+        if (is_space(text[c[k].start_offset]) || is_space(text[end - 1])) return false;
+    }
+    return true;
+}
+
+// True when pos falls strictly inside a "<tag ...>" of the sample ("a < b" is text)
+static bool inside_tag(const char *text, size_t pos) {
+    for (size_t k = pos; k > 0; k--) {
+        if (text[k - 1] == '>') return false;
+        if (text[k - 1] == '<' && text[k] != ' ') return k - 1 < pos;
+    }
+    return false;
+}
+
+static const char PAGE[] =
+    "<!DOCTYPE html>\n"
+    "<html><head><title>Page. Title</title>\n"
+    "<style>p { margin: 1.5em; } a.b > c { x: 0 }</style>\n"
+    "<script type=\"text/javascript\">if (a. b) { x(\"</p>. Y\"); }</SCRIPT>\n"
+    "</head><body>\n"
+    "<p>Hello <b>world</b>. This is&nbsp;Mr.&nbsp;Smith's page.</p>\n"
+    "<!-- hidden. Comment. -->\n"
+    "<ul><li>One. Two<li>Three</ul>\n"
+    "Line one<br>Line two.<img alt=\"Hi. There\" src=\"a.png\"> After image.\n"
+    "<table><tr><td>Cell. Next<td>B</table>\n"
+    "<p>Say <a href='x.html' title='Go. Now'>this</a>. Then &amp; more &nbsp;</p>\n"
+    "&nbsp; Tail a < b. End\n"
+    "</body></html>\n";
+
+int main(void) {
+    bool ok = true;
+    a_sentence_chunker_options_t opts = chunk_check_options(A_SENTENCE_CHUNKER_FORMAT_HTML);
+    aml_buffer_t *first = aml_buffer_init(1024);
+    aml_buffer_t *second = aml_buffer_init(1024);
+
+    size_t len = strlen(PAGE), num = 0, num2 = 0;
+    a_sentence_chunk_t *c = a_sentence_chunker_opts(&num, first, PAGE, len, &opts);
+    ok &= chunk_check_text(PAGE, c, num, (const char *const[]){
+        "Page.", "Title", "Hello <b>world</b>.", "This is&nbsp;Mr.&nbsp;Smith's page.",
+        "One.", "Two", "Three", "Line one", "Line two.", "After image.", "Cell.", "Next", "B",
+        "Say <a href='x.html' title='Go. Now'>this</a>.", "Then &amp; more", "Tail a < b.",
+        "End", NULL
+    }, "first pass");
+    // Short chunks merge only inside a block
+    a_sentence_chunk_t *r = a_rechunk_sentences_opts(&num2, second, PAGE, c, num, 30, 60, &opts);
+    ok &= chunk_check_text(PAGE, r, num2, (const char *const[]){
+        "Page. Title", "Hello <b>world</b>. This is&nbsp;Mr.&nbsp;Smith's page.", "One. Two",
+        "Three", "Line one", "Line two.<img alt=\"Hi. There\" src=\"a.png\"> After image.",
+        "Cell. Next", "B", "Say <a href='x.html' title='Go. Now'>this</a>.",
+        "Then &amp; more", "Tail a < b. End", NULL
+    }, "rechunk");
+    // Splits move off tags
+    bool clean = true;
+    for (size_t max = 8; max < 40 && clean; max++) {
+        r = a_rechunk_sentences_opts(&num2, second, PAGE, c, num, 1, max, &opts);
+        clean = well_formed(PAGE, len, r, num2, false);
+        for (size_t k = 0; k < num2 && clean; k++) {
+            clean = !inside_tag(PAGE, r[k].start_offset + r[k].length);
+        }
+    }
+    if (!clean) printf("  rechunk split inside a tag\n");
+    ok &= clean;
+    printf("%s: page\n", ok ? "PASS" : "FAIL");
+
+    // Text with no markup chunks as plain text, give or take edge whitespace
+    aml_buffer_t *plain = aml_buffer_init(1024);
+    bool pass = true;
+    for (uint64_t seed = 1; seed <= 10 && pass; seed++) {
+        corpus_profile_t profile;
+        corpus_profile_preset(&profile, seed % 2 ? "mixed" : "abbrev", seed);
+        size_t n = 1u << 16;
+        char *corpus = corpus_generate(&profile, n);
+        for (size_t k = 0; k < n; k++) {
+            if (corpus[k] == '<' || corpus[k] == '&') corpus[k] = ' ';
+        }
+        size_t np = 0;
+        a_sentence_chunk_t *p = a_sentence_chunker_len(&np, plain, corpus, n);
+        c = a_sentence_chunker_opts(&num, first, corpus, n, &opts);
+        pass = np == num;
+        for (size_t k = 0; k < num && pass; k++) {
+            size_t s = p[k].start_offset, e = s + p[k].length;
+            while (s < e && is_space(corpus[s])) s++;
+            while (e > s && is_space(corpus[e - 1])) e--;
+            pass = c[k].start_offset == s && c[k].start_offset + c[k].length == e;
+        }
+        if (!pass) printf("  profile seed %u differs from plain text\n", (unsigned)seed);
+        free(corpus);
+    }
+    aml_buffer_destroy(plain);
+    printf("%s: plain text\n", pass ? "PASS" : "FAIL");
+    ok &= pass;
+
+    // Random markup over the bytes that matter
+    static const char *PIECES[] = {
+        "<p>", "</p>", "<b>", "</b>", "<br/>", "<!-- a. B -->", "<script>x. Y</script>",
+        "<a href=\"a. b\">", "&nbsp;", "&amp;", " ", " ", "\n", ". ", "?", "Mr.", "word", "Next",
+        "1.", "<", ">", "\"", "'", "=", "<!", "<style", "</li", "-->"
+    };
+    uint64_t x = 0x9E3779B97F4A7C15ull;
+    char text[256];
+    pass = true;
+    for (int it = 0; it < 100000 && pass; it++) {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        size_t n = 0, pieces = x % 24;
+        for (size_t k = 0; k < pieces; k++) {
+            x ^= x << 13;
+            x ^= x >> 7;
+            x ^= x << 17;
+            const char *piece = PIECES[(x >> 20) % (sizeof(PIECES) / sizeof(PIECES[0]))];
+            size_t pn = strlen(piece);
+            memcpy(text + n, piece, pn);
+            n += pn;
+        }
+        c = a_sentence_chunker_opts(&num, first, text, n, &opts);
+        pass = well_formed(text, n, c, num, true);
+        r = a_rechunk_sentences_opts(&num2, second, text, c, num, 5, 20, &opts);
+        pass = pass && well_formed(text, n, r, num2, false);
+        if (!pass) printf("  random markup %d: %.*s\n", it, (int)n, text);
+    }
+    printf("%s: well-formed chunks\n", pass ? "PASS" : "FAIL");
+    ok &= pass;
+
+    aml_buffer_destroy(first);
+    aml_buffer_destroy(second);
+    return ok ? 0 : 1;
+}
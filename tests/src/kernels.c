@@ -0,0 +1,84 @@
+// SPDX-FileCopyrightText: 2025 Andy Curtis <contactandyc@gmail.com>
+// SPDX-FileCopyrightText: 2024–2025 Knode.ai — technical questions: contact Andy (above)
+// SPDX-License-Identifier: Apache-2.0
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "a-sentence-chunker-library/a_sentence_chunker.h"
+#include "corpus_gen.h"
+
+/*
+   Scan kernel test: every kernel this CPU supports must produce exactly
+   the scalar kernel's chunks, including around block edges and at the
+   tail of non-NUL-terminated input. Variants without dispatch only have
+   "scalar", which trivially passes.
+*/
+
+static const char *KERNELS[] = { "scalar", "sse2", "avx2", "avx512bw" };
+#define NUM_KERNELS (sizeof(KERNELS) / sizeof(KERNELS[0]))
+
+static int same_chunks(const a_sentence_chunk_t *a, size_t na,
+                       const a_sentence_chunk_t *b, size_t nb)
+{
+    if (na != nb) return 0;
+    for (size_t k = 0; k < na; k++) {
+        if (a[k].start_offset != b[k].start_offset || a[k].length != b[k].length) return 0;
+    }
+    return 1;
+}
+
+int main(void) {
+    const char *best = a_sentence_chunker_kernel();
+    printf("default kernel: %s\n", best);
+
+    corpus_profile_t profile;
+    corpus_profile_preset(&profile, "mixed", 61);
+    size_t corpus_len = 1u << 20;
+    char *corpus = corpus_generate(&profile, corpus_len);
+
+    // Sparse punctuation at every offset around 64-byte blocks
+    char edge[512];
+    memset(edge, 'x', sizeof(edge));
+
+    aml_buffer_t *ref = aml_buffer_init(1024);
+    aml_buffer_t *got = aml_buffer_init(1024);
+    int ok = 1;
+    for (size_t k = 0; k < NUM_KERNELS; k++) {
+        if (!a_sentence_chunker_kernel_select(KERNELS[k])) {
+            printf("SKIP: %s\n", KERNELS[k]);
+            continue;
+        }
+        int pass = 1;
+        for (size_t len = corpus_len - 200; len <= corpus_len && pass; len += 7) {
+            size_t nr = 0, ng = 0;
+            a_sentence_chunker_kernel_select("scalar");
+            a_sentence_chunk_t *r = a_sentence_chunker_len(&nr, ref, corpus, len);
+            a_sentence_chunker_kernel_select(KERNELS[k]);
+            a_sentence_chunk_t *g = a_sentence_chunker_len(&ng, got, corpus, len);
+            pass = same_chunks(r, nr, g, ng);
+        }
+        for (size_t pos = 0; pos < 200 && pass; pos++) {
+            edge[pos] = '.';
+            edge[pos + 1] = ' ';
+            edge[pos + 2] = 'X';
+            for (size_t len = pos; len < pos + 140 && pass; len++) {
+                size_t nr = 0, ng = 0;
+                a_sentence_chunker_kernel_select("scalar");
+                a_sentence_chunk_t *r = a_sentence_chunker_len(&nr, ref, edge, len);
+                a_sentence_chunker_kernel_select(KERNELS[k]);
+                a_sentence_chunk_t *g = a_sentence_chunker_len(&ng, got, edge, len);
+                pass = same_chunks(r, nr, g, ng);
+            }
+            edge[pos] = edge[pos + 1] = edge[pos + 2] = 'x';
+        }
+        printf("%s: %s\n", pass ? "PASS" : "FAIL", KERNELS[k]);
+        ok &= pass;
+    }
+    a_sentence_chunker_kernel_select(best);
+
+    aml_buffer_destroy(ref);
+    aml_buffer_destroy(got);
+    free(corpus);
+    return ok ? 0 : 1;
+}
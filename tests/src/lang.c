@@ -0,0 +1,258 @@
+// SPDX-FileCopyrightText: 2025 Andy Curtis <contactandyc@gmail.com>
+// SPDX-FileCopyrightText: 2024–2025 Knode.ai — technical questions: contact Andy (above)
+// SPDX-License-Identifier: Apache-2.0
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "a-sentence-chunker-library/a_sentence_chunker.h"
+#include "a-sentence-chunker-library/a_sentence_chunker_lang.h"
+#include "corpus_gen.h"
+#include "read_file.h"
+
+/*
+   Language pack test: compiles lang/<name>.txt, maps the result like a
+   shipped pack, and checks that the English pack reproduces the built-in
+   rules exactly, that de/fr/es fix what the built-in rules get wrong, and
+   that malformed sources and corrupt blobs are rejected.
+
+     test_lang <lang dir>
+*/
+
+static const char *PROFILES[] = { "prose", "abbrev", "numeric", "lists", "nospace",
+                                  "cjk", "crlf", "dotted", "mixed" };
+#define NUM_PROFILES (sizeof(PROFILES) / sizeof(PROFILES[0]))
+
+// Compile <dir>/<name>.txt, write it out and map it back
+static a_sentence_chunker_lang_t *load_pack(const char *dir, const char *name, aml_buffer_t *blob) {
+    char path[1024];
+    snprintf(path, sizeof(path), "%s/%s.txt", dir, name);
+    size_t len = 0, error_line = 0;
+    char *source = read_file(path, &len);
+    if (!source) return NULL;
+    bool ok = a_sentence_chunker_lang_compile(blob, source, len, &error_line);
+    free(source);
+    if (!ok) {
+        printf("FAIL: %s:%zu does not compile\n", path, error_line);
+        return NULL;
+    }
+    char packed[] = "/tmp/test_lang_XXXXXX";
+    int fd = mkstemp(packed);
+    if (fd < 0) return NULL;
+    ok = write(fd, aml_buffer_data(blob), aml_buffer_length(blob)) == (ssize_t)aml_buffer_length(blob);
+    close(fd);
+    a_sentence_chunker_lang_t *lang = ok ? a_sentence_chunker_lang_load(packed) : NULL;
+    unlink(packed);
+    return lang;
+}
+
+static bool same_chunks(const a_sentence_chunk_t *a, size_t na,
+                        const a_sentence_chunk_t *b, size_t nb)
+{
+    if (na != nb) return false;
+    for (size_t k = 0; k < na; k++) {
+        if (a[k].start_offset != b[k].start_offset || a[k].length != b[k].length) return false;
+    }
+    return true;
+}
+
+// The pack must split text into exactly the expected sentences
+static bool expect(const a_sentence_chunker_lang_t *lang, const char *text,
+                   const char *const *expected)
+{
+    aml_buffer_t *bh = aml_buffer_init(256);
+    a_sentence_chunker_options_t opts = { .lang = lang };
+    size_t num = 0;
+    a_sentence_chunk_t *c = a_sentence_chunker_opts(&num, bh, text, strlen(text), &opts);
+    bool ok = true;
+    size_t k = 0;
+    for (; expected[k]; k++) {
+        ok &= k < num && c[k].length == strlen(expected[k]) &&
+              memcmp(text + c[k].start_offset, expected[k], c[k].length) == 0;
+    }
+    ok &= k == num;
+    if (!ok) {
+        printf("  %s: \"%s\" gave", lang ? a_sentence_chunker_lang_name(lang) : "built-in", text);
+        for (size_t j = 0; j < num; j++) {
+            printf(" [%.*s]", (int)c[j].length, text + c[j].start_offset);
+        }
+        printf("\n");
+    }
+    aml_buffer_destroy(bh);
+    return ok;
+}
+
+static bool check_english(const a_sentence_chunker_lang_t *en) {
+    aml_buffer_t *ref = aml_buffer_init(1024);
+    aml_buffer_t *got = aml_buffer_init(1024);
+    a_sentence_chunker_options_t opts = { .lang = en };
+    bool ok = true;
+    for (size_t p = 0; p < NUM_PROFILES && ok; p++) {
+        corpus_profile_t profile;
+        corpus_profile_preset(&profile, PROFILES[p], 67);
+        size_t len = 1u << 20;
+        char *text = corpus_generate(&profile, len);
+        size_t nr = 0, ng = 0;
+        a_sentence_chunk_t *r = a_sentence_chunker_len(&nr, ref, text, len);
+        a_sentence_chunk_t *g = a_sentence_chunker_opts(&ng, got, text, len, &opts);
+        ok = same_chunks(r, nr, g, ng);
+        if (!ok) printf("  en pack differs on %s\n", PROFILES[p]);
+        free(text);
+    }
+    aml_buffer_destroy(ref);
+    aml_buffer_destroy(got);
+    printf("%s: en pack matches the built-in rules\n", ok ? "PASS" : "FAIL");
+    return ok;
+}
+
+static bool check_german(const a_sentence_chunker_lang_t *de) {
+    bool ok = true;
+    const char *meet = "Wir treffen uns z.B. am 3. Oktober bei Dr. Weber. Das ist gut.";
+    ok &= expect(de, meet, (const char *const[]){
+        "Wir treffen uns z.B. am 3. Oktober bei Dr. Weber.", "Das ist gut.", NULL });
+    ok &= expect(NULL, meet, (const char *const[]){
+        "Wir treffen uns z.B.", "am 3.", "Oktober bei Dr. Weber.", "Das ist gut.", NULL });
+    // usw* ends a sentence only before a capital
+    ok &= expect(de, "Äpfel, Birnen usw. Danach gehen wir.", (const char *const[]){
+        "Äpfel, Birnen usw.", "Danach gehen wir.", NULL });
+    ok &= expect(de, "Äpfel, Birnen usw. und mehr.", (const char *const[]){
+        "Äpfel, Birnen usw. und mehr.", NULL });
+    // "So." (Sonntag) is case-sensitive, "so." is a word
+    ok &= expect(de, "Am So. kommen wir. Das ist so. Gut.", (const char *const[]){
+        "Am So. kommen wir.", "Das ist so.", "Gut.", NULL });
+    // Years are not ordinals
+    ok &= expect(de, "Das war 2024. Dann kam mehr.", (const char *const[]){
+        "Das war 2024.", "Dann kam mehr.", NULL });
+    ok &= expect(de, "Er sagte: \xE2\x80\x9EKomm.\xE2\x80\x9C Dann ging er.", (const char *const[]){
+        "Er sagte: \xE2\x80\x9EKomm.\xE2\x80\x9C", "Dann ging er.", NULL });
+    printf("%s: de pack\n", ok ? "PASS" : "FAIL");
+    return ok;
+}
+
+static bool check_french(const a_sentence_chunker_lang_t *fr) {
+    bool ok = true;
+    ok &= expect(fr, "\xC2\xAB Bonjour. \xC2\xBB Il est parti avec Mme. Dupont. Fin.",
+                 (const char *const[]){
+        "\xC2\xAB Bonjour. \xC2\xBB", "Il est parti avec Mme. Dupont.", "Fin.", NULL });
+    ok &= expect(NULL, "\xC2\xAB Bonjour. \xC2\xBB Il est parti avec Mme. Dupont. Fin.",
+                 (const char *const[]){
+        "\xC2\xAB Bonjour.", "\xC2\xBB Il est parti avec Mme.", "Dupont.", "Fin.", NULL });
+    // Narrow no-break space before the guillemet
+    ok &= expect(fr, "\xC2\xAB Oui ?\xE2\x80\xAF\xC2\xBB Voir p. 4.", (const char *const[]){
+        "\xC2\xAB Oui ?\xE2\x80\xAF\xC2\xBB", "Voir p. 4.", NULL });
+    printf("%s: fr pack\n", ok ? "PASS" : "FAIL");
+    return ok;
+}
+
+static bool check_spanish(const a_sentence_chunker_lang_t *es) {
+    bool ok = true;
+    ok &= expect(es, "Lleg\xC3\xB3 el 12.\xC2\xBA d\xC3\xAD" "a con la Sra. Garc\xC3\xAD" "a. Fin.",
+                 (const char *const[]){
+        "Lleg\xC3\xB3 el 12.\xC2\xBA d\xC3\xAD" "a con la Sra. Garc\xC3\xAD" "a.", "Fin.", NULL });
+    ok &= expect(NULL, "Lleg\xC3\xB3 el 12.\xC2\xBA d\xC3\xAD" "a con la Sra. Garc\xC3\xAD" "a. Fin.",
+                 (const char *const[]){
+        "Lleg\xC3\xB3 el 12.", "\xC2\xBA d\xC3\xAD" "a con la Sra.", "Garc\xC3\xAD" "a.", "Fin.", NULL });
+    printf("%s: es pack\n", ok ? "PASS" : "FAIL");
+    return ok;
+}
+
+static bool check_custom(void) {
+    const char *src = "name semi\nterminators .?! ;\nabbrev approx\n";
+    aml_buffer_t *blob = aml_buffer_init(1024);
+    size_t error_line = 0;
+    bool ok = a_sentence_chunker_lang_compile(blob, src, strlen(src), &error_line);
+    a_sentence_chunker_lang_t *semi = ok ? a_sentence_chunker_lang_from_memory(
+        aml_buffer_data(blob), aml_buffer_length(blob)) : NULL;
+    ok &= semi && !strcmp(a_sentence_chunker_lang_name(semi), "semi");
+    if (semi) {
+        ok &= expect(semi, "one; two; approx. three.", (const char *const[]){
+            "one;", "two;", "approx. three.", NULL });
+    }
+    a_sentence_chunker_lang_destroy(semi);
+    aml_buffer_destroy(blob);
+    printf("%s: custom terminators\n", ok ? "PASS" : "FAIL");
+    return ok;
+}
+
+static bool check_rejects(const char *dir) {
+    aml_buffer_t *blob = aml_buffer_init(1024);
+    size_t error_line = 0;
+    const char *bad = "name x\n# fine\nbogus 1\n";
+    bool ok = !a_sentence_chunker_lang_compile(blob, bad, strlen(bad), &error_line) &&
+              error_line == 3;
+    const char *long_name = "name abcdefghijklmnopq\n";
+    ok &= !a_sentence_chunker_lang_compile(blob, long_name, strlen(long_name), &error_line) &&
+          error_line == 1;
+
+    a_sentence_chunker_lang_t *de = load_pack(dir, "de", blob);
+    a_sentence_chunker_lang_destroy(de);
+    size_t len = aml_buffer_length(blob);
+    char *copy = malloc(len + 4);
+    memcpy(copy, aml_buffer_data(blob), len);
+    uint32_t *words = (uint32_t *)copy;
+
+    ok &= de != NULL;
+    ok &= a_sentence_chunker_lang_from_memory(copy, len - 4) == NULL;     // truncated
+    ok &= a_sentence_chunker_lang_from_memory(copy + 1, len) == NULL;     // misaligned
+    copy[0] ^= 1;
+    ok &= a_sentence_chunker_lang_from_memory(copy, len) == NULL;         // magic
+    copy[0] ^= 1;
+    a_sentence_chunker_lang_t *fine = a_sentence_chunker_lang_from_memory(copy, len);
+    ok &= fine != NULL;
+    a_sentence_chunker_lang_destroy(fine);
+
+    // Corrupting any one word must be rejected or still safe to use
+    char *saved = malloc(len);
+    memcpy(saved, copy, len);
+    aml_buffer_t *bh = aml_buffer_init(256);
+    const char *sample = "Ein Test z.B. am 3. Mai. Noch einer.";
+    for (size_t off = 0; off + 4 <= len; off += 4) {
+        uint32_t keep = words[off / 4];
+        words[off / 4] = 0xFFFFFFF0u;
+        a_sentence_chunker_lang_t *l = a_sentence_chunker_lang_from_memory(copy, len);
+        if (l) {
+            size_t num = 0;
+            a_sentence_chunker_options_t opts = { .lang = l };
+            a_sentence_chunker_opts(&num, bh, sample, strlen(sample), &opts);
+        }
+        a_sentence_chunker_lang_destroy(l);
+        words[off / 4] = keep;
+    }
+    aml_buffer_destroy(bh);
+    ok &= memcmp(saved, copy, len) == 0;
+    free(saved);
+    free(copy);
+    ok &= a_sentence_chunker_lang_load("/nonexistent/xx.pack") == NULL;
+    aml_buffer_destroy(blob);
+    printf("%s: malformed sources and blobs\n", ok ? "PASS" : "FAIL");
+    return ok;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s <lang dir>\n", argv[0]);
+        return 1;
+    }
+    aml_buffer_t *blob = aml_buffer_init(4096);
+    a_sentence_chunker_lang_t *en = load_pack(argv[1], "en", blob);
+    a_sentence_chunker_lang_t *de = load_pack(argv[1], "de", blob);
+    a_sentence_chunker_lang_t *fr = load_pack(argv[1], "fr", blob);
+    a_sentence_chunker_lang_t *es = load_pack(argv[1], "es", blob);
+    bool ok = en && de && fr && es;
+    if (ok) {
+        ok &= check_english(en);
+        ok &= check_german(de);
+        ok &= check_french(fr);
+        ok &= check_spanish(es);
+    }
+    ok &= check_custom();
+    ok &= check_rejects(argv[1]);
+    a_sentence_chunker_lang_destroy(en);
+    a_sentence_chunker_lang_destroy(de);
+    a_sentence_chunker_lang_destroy(fr);
+    a_sentence_chunker_lang_destroy(es);
+    aml_buffer_destroy(blob);
+    return ok ? 0 : 1;
+}
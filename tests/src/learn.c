@@ -0,0 +1,285 @@
+// SPDX-FileCopyrightText: 2025 Andy Curtis <contactandyc@gmail.com>
+// SPDX-FileCopyrightText: 2024–2025 Knode.ai — technical questions: contact Andy (above)
+// SPDX-License-Identifier: Apache-2.0
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "a-sentence-chunker-library/a_sentence_chunker.h"
+#include "a-sentence-chunker-library/a_sentence_chunker_lang.h"
+#include "read_file.h"
+
+/*
+   Abbreviation learner test: writes a synthetic corpus whose abbreviations
+   and ordinal conventions are known ("F. Supp. 2d", "approx. 12", "etc."
+   ending sentences, "am 3. Oktober", "page 512." ending sentences), runs
+   a_sentence_chunker_learn over it and checks the learned pack source and
+   the chunks the compiled pack produces. The corpus spans more than one
+   read block.
+
+     test_learn <a_sentence_chunker_learn> <lang dir>
+*/
+
+static const char *SYLLABLES[] = {
+    "ka", "lo", "mi", "ren", "sa", "tor", "ve", "dan", "el", "is",
+    "on", "ut", "pra", "qui", "ber", "cho", "ga", "hin", "jo", "ny"
+};
+#define NUM_SYLLABLES (sizeof(SYLLABLES) / sizeof(SYLLABLES[0]))
+
+static const char *NAMES[] = { "Weber", "Okafor", "Lindqvist", "Tanaka", "Moreau" };
+#define NUM_NAMES (sizeof(NAMES) / sizeof(NAMES[0]))
+
+static const char *MONTHS[] = { "Januar", "Oktober", "Juni", "Mai" };
+#define NUM_MONTHS (sizeof(MONTHS) / sizeof(MONTHS[0]))
+
+static const char *LEARNED[] = { "supp", "approx", "etc", "dr", "f", NULL };
+
+static uint64_t state = 68;
+
+static uint64_t below(uint64_t n) {
+    uint64_t z = (state += 0x9e3779b97f4a7c15ull);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return (z ^ (z >> 31)) % n;
+}
+
+static void word(FILE *fp, bool capitalize) {
+    char w[32];
+    size_t n = 0;
+    for (unsigned s = 0, syllables = 1 + (unsigned)below(3); s < syllables; s++) {
+        n += (size_t)snprintf(w + n, sizeof(w) - n, "%s", SYLLABLES[below(NUM_SYLLABLES)]);
+    }
+    if (capitalize) w[0] = (char)(w[0] - 'a' + 'A');
+    fputs(w, fp);
+}
+
+static void filler(FILE *fp, unsigned words) {
+    for (unsigned k = 0; k < words; k++) {
+        fputc(' ', fp);
+        word(fp, false);
+    }
+}
+
+// One sentence; every one starts with a capitalized (normally lowercase) word
+static void sentence(FILE *fp) {
+    word(fp, true);
+    filler(fp, 1 + (unsigned)below(4));
+    switch (below(9)) {
+    case 0: // legal citation: "Supp." before a digit
+        fprintf(fp, " F. Supp. %llud %llu,", 2 + (unsigned long long)below(2),
+                1 + (unsigned long long)below(999));
+        filler(fp, 2);
+        break;
+    case 1:
+        fprintf(fp, " approx. %llu", 1 + (unsigned long long)below(99));
+        filler(fp, 2);
+        break;
+    case 2: // "etc." mid-sentence, or ending it (the next sentence follows)
+        fputs(",", fp);
+        filler(fp, 1);
+        if (below(2)) {
+            fputs(" etc. ", fp);
+            return;
+        } else {
+            fputs(" etc. and", fp);
+            filler(fp, 1);
+        }
+        break;
+    case 3: // names stay capitalized mid-sentence
+        fprintf(fp, " Dr. %s", NAMES[below(NUM_NAMES)]);
+        filler(fp, 2);
+        break;
+    case 4: // German ordinals: a day before a month name
+        fprintf(fp, " am %llu. %s", 1 + (unsigned long long)below(31), MONTHS[below(NUM_MONTHS)]);
+        filler(fp, 1);
+        break;
+    case 5: // page numbers and years end sentences
+        fprintf(fp, " page %llu", 100 + (unsigned long long)below(900));
+        break;
+    case 6:
+        fprintf(fp, " in %llu", 1900 + (unsigned long long)below(125));
+        break;
+    case 7:
+        fprintf(fp, " %s", NAMES[below(NUM_NAMES)]);
+        filler(fp, 1);
+        break;
+    default:
+        filler(fp, 2);
+        break;
+    }
+    uint64_t end = below(10);
+    fputs(end < 8 ? ". " : end < 9 ? "? " : "! ", fp);
+}
+
+static bool write_corpus(const char *path, size_t bytes) {
+    FILE *fp = fopen(path, "wb");
+    if (!fp) {
+        perror("fopen");
+        return false;
+    }
+    while ((size_t)ftell(fp) < bytes) {
+        for (unsigned s = 0, n = 3 + (unsigned)below(5); s < n; s++) sentence(fp);
+        fputs("\n\n", fp);
+    }
+    return fclose(fp) == 0;
+}
+
+// Run the learner; returns the generated source, or NULL
+static char *learn(const char *tool, const char *args, const char *dir, const char *tag) {
+    char cmd[4096];
+    snprintf(cmd, sizeof(cmd), "\"%s\" %s --source \"%s/%s.txt\" -o \"%s/%s.pack\" \"%s/corpus\"",
+             tool, args, dir, tag, dir, tag, dir);
+    if (system(cmd) != 0) {
+        printf("FAIL: %s\n", cmd);
+        return NULL;
+    }
+    char path[1024];
+    snprintf(path, sizeof(path), "%s/%s.txt", dir, tag);
+    size_t len = 0;
+    return read_file(path, &len);
+}
+
+static bool has_line(const char *source, const char *prefix) {
+    size_t n = strlen(prefix);
+    for (const char *p = source; p; p = strchr(p, '\n')) {
+        if (*p == '\n') p++;
+        if (strncmp(p, prefix, n) == 0) return true;
+    }
+    return false;
+}
+
+// Every learned abbreviation is one the corpus really uses
+static bool only_expected(const char *source) {
+    bool ok = true;
+    for (const char *p = strstr(source, "\nabbrev "); p; p = strstr(p + 1, "\nabbrev ")) {
+        const char *w = p + 8;
+        size_t n = strcspn(w, " *");
+        bool known = false;
+        for (size_t k = 0; LEARNED[k] && !known; k++) {
+            known = strlen(LEARNED[k]) == n && strncmp(LEARNED[k], w, n) == 0;
+        }
+        if (!known) {
+            printf("  unexpected: %.*s\n", (int)n, w);
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+static bool expect(const a_sentence_chunker_lang_t *lang, const char *text,
+                   const char *const *expected)
+{
+    aml_buffer_t *bh = aml_buffer_init(256);
+    a_sentence_chunker_options_t opts = { .lang = lang };
+    size_t num = 0;
+    a_sentence_chunk_t *c = a_sentence_chunker_opts(&num, bh, text, strlen(text), &opts);
+    bool ok = true;
+    size_t k = 0;
+    for (; expected[k]; k++) {
+        ok &= k < num && c[k].length == strlen(expected[k]) &&
+              memcmp(text + c[k].start_offset, expected[k], c[k].length) == 0;
+    }
+    ok &= k == num;
+    if (!ok) {
+        printf("  \"%s\" gave", text);
+        for (size_t j = 0; j < num; j++) {
+            printf(" [%.*s]", (int)c[j].length, text + c[j].start_offset);
+        }
+        printf("\n");
+    }
+    aml_buffer_destroy(bh);
+    return ok;
+}
+
+static bool check_learned(const char *source, const char *dir) {
+    bool ok = true;
+    ok &= has_line(source, "abbrev supp ");
+    ok &= has_line(source, "abbrev approx ");
+    ok &= has_line(source, "abbrev etc*");
+    ok &= has_line(source, "abbrev dr ");
+    ok &= has_line(source, "ordinal_next digit lower upper");
+    ok &= has_line(source, "ordinal_max_digits 2");
+    ok &= only_expected(source);
+    printf("%s: learned abbreviations and ordinals\n", ok ? "PASS" : "FAIL");
+
+    char path[1024];
+    snprintf(path, sizeof(path), "%s/one.pack", dir);
+    a_sentence_chunker_lang_t *lang = a_sentence_chunker_lang_load(path);
+    bool chunks = lang != NULL;
+    if (lang) {
+        chunks &= expect(lang, "See F. Supp. 2d 88 on approx. 12 cases. Done.",
+                         (const char *const[]){ "See F. Supp. 2d 88 on approx. 12 cases.",
+                                                "Done.", NULL });
+        chunks &= expect(lang, "Wir kamen am 3. Oktober zu Dr. Weber. Gut.",
+                         (const char *const[]){ "Wir kamen am 3. Oktober zu Dr. Weber.",
+                                                "Gut.", NULL });
+        chunks &= expect(lang, "Apples, pears etc. Then we left. It was page 512. Next.",
+                         (const char *const[]){ "Apples, pears etc.", "Then we left.",
+                                                "It was page 512.", "Next.", NULL });
+        chunks &= expect(lang, "Apples etc. and pears.",
+                         (const char *const[]){ "Apples etc. and pears.", NULL });
+        a_sentence_chunker_lang_destroy(lang);
+    }
+    printf("%s: learned pack chunks\n", chunks ? "PASS" : "FAIL");
+    return ok && chunks;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 3) {
+        fprintf(stderr, "Usage: %s <a_sentence_chunker_learn> <lang dir>\n", argv[0]);
+        return 1;
+    }
+    char dir[] = "/tmp/test_learn_XXXXXX";
+    if (!mkdtemp(dir)) {
+        perror("mkdtemp");
+        return 1;
+    }
+    char path[1024], cmd[2048];
+    snprintf(path, sizeof(path), "%s/corpus", dir);
+    snprintf(cmd, sizeof(cmd), "mkdir -p \"%s\"", path);
+    bool ok = system(cmd) == 0;
+    snprintf(path, sizeof(path), "%s/corpus/big.txt", dir);
+    ok = ok && write_corpus(path, 10u << 20);
+    snprintf(path, sizeof(path), "%s/corpus/small.txt", dir);
+    ok = ok && write_corpus(path, 64u << 10);
+
+    char *one = ok ? learn(argv[1], "--threads 1", dir, "one") : NULL;
+    char *four = ok ? learn(argv[1], "--threads 4", dir, "four") : NULL;
+    ok = one && four;
+    if (ok) {
+        ok &= check_learned(one, dir);
+        bool same = strcmp(one, four) == 0;
+        printf("%s: same output on 1 and 4 threads\n", same ? "PASS" : "FAIL");
+        ok &= same;
+    }
+
+    // A tiny type table prunes rare types but keeps the frequent abbreviations
+    char *pruned = ok ? learn(argv[1], "--threads 2 --max-types 1024", dir, "pruned") : NULL;
+    if (ok) {
+        bool kept = pruned && has_line(pruned, "abbrev supp ") && has_line(pruned, "abbrev etc*");
+        printf("%s: pruned type table\n", kept ? "PASS" : "FAIL");
+        ok &= kept;
+    }
+
+    // --base keeps the hand-written pack and does not repeat its words
+    char args[2048];
+    snprintf(args, sizeof(args), "--base \"%s/en.txt\" --name en-legal", argv[2]);
+    char *based = ok ? learn(argv[1], args, dir, "based") : NULL;
+    if (ok) {
+        bool merged = based && has_line(based, "abbrev supp ") && has_line(based, "name en-legal") &&
+                      has_line(based, "abbrev Mr") && !has_line(based, "abbrev dr ") &&
+                      !has_line(based, "abbrev etc");
+        printf("%s: learned on top of a base pack\n", merged ? "PASS" : "FAIL");
+        ok &= merged;
+    }
+
+    free(one);
+    free(four);
+    free(pruned);
+    free(based);
+    snprintf(cmd, sizeof(cmd), "rm -rf \"%s\"", dir);
+    if (system(cmd) != 0) ok = false;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,168 @@
+// SPDX-FileCopyrightText: 2025 Andy Curtis <contactandyc@gmail.com>
+// SPDX-FileCopyrightText: 2024–2025 Knode.ai — technical questions: contact Andy (above)
+// SPDX-License-Identifier: Apache-2.0
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "a-sentence-chunker-library/a_sentence_chunker.h"
+#include "chunk_check.h"
+#include "corpus_gen.h"
+
+/*
+   Markdown test: A_SENTENCE_CHUNKER_FORMAT_MARKDOWN makes headings, list
+   items and table rows hard boundaries and code blocks opaque, in both
+   passes. Checks a sample document chunk by chunk, then on generated and
+   random Markdown that chunks are ordered, non-empty, inside the text and
+   never cut a code block.
+*/
+
+// Ordered, non-empty, in bounds, and no chunk ends inside a fenced block
+static bool well_formed(const char *text, size_t len, const a_sentence_chunk_t *c, size_t num) {
+    if (!chunk_check_ordered(len, c, num)) return false;
+    for (size_t k = 0; k < num; k++) {
+        size_t end = c[k].start_offset + c[k].length;
+        size_t at = c[k].start_offset;
+        bool fenced = c[k].length >= 3 && !memcmp(text + at, "```", 3) &&
+                      (at == 0 || text[at - 1] == '\n');
+        size_t rest = end;
+        while (rest < len && (text[rest] == ' ' || text[rest] == '\t' || text[rest] == '\n')) {
+            rest++;
+        }
+        // A closed fence ends with its closing fence, an unclosed one at the end
+        if (fenced && rest < len && memcmp(text + end - 3, "```", 3) != 0) return false;
+    }
+    return true;
+}
+
+static const char DOC[] =
+    "# Intro. Part 1\n"
+    "This is text. It has e.g. things.\n"
+    "More text here.\n"
+    "\n"
+    "- First item. Two.\n"
+    "- Second item\n"
+    "  continues here.\n"
+    "1. Numbered one.\n"
+    "\n"
+    "| a. b | c. d |\n"
+    "|---|---|\n"
+    "| e | f |\n"
+    "\n"
+    "```c\n"
+    "int x = a.b; y.z();\n"
+    "\n"
+    "return 0.\n"
+    "```\n"
+    "After code. Short.\n"
+    "\n"
+    "    indented.code();\n"
+    "    more. stuff\n"
+    "\n"
+    "Final para.\n"
+    "---\n"
+    "Title\n"
+    "===\n"
+    "End";
+
+int main(void) {
+    bool ok = true;
+    a_sentence_chunker_options_t opts = chunk_check_options(A_SENTENCE_CHUNKER_FORMAT_MARKDOWN);
+    aml_buffer_t *first = aml_buffer_init(1024);
+    aml_buffer_t *second = aml_buffer_init(1024);
+
+    size_t len = strlen(DOC), num = 0, num2 = 0;
+    a_sentence_chunk_t *c = a_sentence_chunker_opts(&num, first, DOC, len, &opts);
+    ok &= chunk_check_text(DOC, c, num, (const char *const[]){
+        "# Intro. Part 1", "This is text.", "It has e.g. things.", "More text here.",
+        "- First item.", "Two.", "- Second item\n  continues here.", "1. Numbered one.",
+        "| a. b | c. d |", "| e | f |",
+        "```c\nint x = a.b; y.z();\n\nreturn 0.\n```", "After code.", "Short.",
+        "    indented.code();\n    more. stuff", "Final para.", "Title", "End", NULL
+    }, "first pass");
+    a_sentence_chunk_t *r = a_rechunk_sentences_opts(&num2, second, DOC, c, num, 40, 60, &opts);
+    ok &= chunk_check_text(DOC, r, num2, (const char *const[]){
+        "# Intro. Part 1", "This is text. It has e.g. things.\nMore text here.",
+        "- First item. Two.", "- Second item\n  continues here.", "1. Numbered one.",
+        "| a. b | c. d |", "| e | f |",
+        "```c\nint x = a.b; y.z();\n\nreturn 0.\n```", "After code. Short.",
+        "    indented.code();\n    more. stuff", "Final para.", "Title", "End", NULL
+    }, "rechunk");
+    // Code blocks are never split, however long
+    r = a_rechunk_sentences_opts(&num2, second, DOC, c, num, 2, 12, &opts);
+    bool whole = false;
+    for (size_t k = 0; k < num2; k++) {
+        whole |= r[k].length == 39 && !memcmp(DOC + r[k].start_offset, "```c", 4);
+    }
+    if (!whole) printf("  code block was split\n");
+    ok &= whole;
+    // An unclosed fence runs to the end
+    const char *open = "Text. More.\n```\ncode. here.\n\nstill. code";
+    c = a_sentence_chunker_opts(&num, first, open, strlen(open), &opts);
+    ok &= chunk_check_text(open, c, num, (const char *const[]){
+        "Text.", "More.", "```\ncode. here.\n\nstill. code", NULL }, "unclosed fence");
+    printf("%s: documents\n", ok ? "PASS" : "FAIL");
+
+    // Generated prose with Markdown lines mixed in
+    static const char *LINES[] = {
+        "# Heading. With dots\n", "- item. one\n", "12) item\n", "| a. | b |\n", "|--|--|\n",
+        "```\n", "~~~~\n", "    code.x()\n", "\n", "***\n", "* star. item\n", "###### h6\n"
+    };
+    bool pass = true;
+    uint64_t x = 0x9E3779B97F4A7C15ull;
+    for (uint64_t seed = 1; seed <= 20 && pass; seed++) {
+        corpus_profile_t profile;
+        corpus_profile_preset(&profile, seed % 2 ? "mixed" : "lists", seed);
+        char *corpus = corpus_generate(&profile, 1u << 16);
+        aml_buffer_t *doc = aml_buffer_init(1u << 17);
+        for (char *p = corpus; *p;) {
+            char *nl = strchr(p, '\n');
+            size_t n = nl ? (size_t)(nl - p) + 1 : strlen(p);
+            aml_buffer_append(doc, p, n);
+            p += n;
+            x ^= x << 13;
+            x ^= x >> 7;
+            x ^= x << 17;
+            if (x % 3 == 0) {
+                const char *line = LINES[(x >> 8) % (sizeof(LINES) / sizeof(LINES[0]))];
+                aml_buffer_append(doc, line, strlen(line));
+            }
+        }
+        const char *text = aml_buffer_data(doc);
+        size_t n = aml_buffer_length(doc);
+        c = a_sentence_chunker_opts(&num, first, text, n, &opts);
+        pass = well_formed(text, n, c, num);
+        r = a_rechunk_sentences_opts(&num2, second, text, c, num, 40, 200, &opts);
+        pass = pass && well_formed(text, n, r, num2);
+        aml_buffer_destroy(doc);
+        free(corpus);
+    }
+    // Random strings over the bytes that matter
+    static const char ALPHABET[] = "\n\n   \t#-*+|`~>=_.1a A.!?)\"";
+    char text[128];
+    for (int it = 0; it < 200000 && pass; it++) {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        size_t n = x % sizeof(text);
+        for (size_t k = 0; k < n; k++) {
+            x ^= x << 13;
+            x ^= x >> 7;
+            x ^= x << 17;
+            text[k] = ALPHABET[(x >> 20) % (sizeof(ALPHABET) - 1)];
+        }
+        c = a_sentence_chunker_opts(&num, first, text, n, &opts);
+        pass = well_formed(text, n, c, num);
+        r = a_rechunk_sentences_opts(&num2, second, text, c, num, 5, 20, &opts);
+        pass = pass && well_formed(text, n, r, num2);
+        if (!pass) printf("  random string %d\n", it);
+    }
+    printf("%s: well-formed chunks\n", pass ? "PASS" : "FAIL");
+    ok &= pass;
+
+    aml_buffer_destroy(first);
+    aml_buffer_destroy(second);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,123 @@
+// SPDX-FileCopyrightText: 2025 Andy Curtis <contactandyc@gmail.com>
+// SPDX-FileCopyrightText: 2024–2025 Knode.ai — technical questions: contact Andy (above)
+// SPDX-License-Identifier: Apache-2.0
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "a-sentence-chunker-library/a_sentence_chunker.h"
+#include "alloc_counters.h"
+#include "corpus_gen.h"
+#include "read_file.h"
+
+/*
+   memory_bench: per-pass allocation accounting, meant to run against the
+   `memory` library variant (build.sh variant=memory).
+
+     memory_bench [corpus...]
+
+   With no arguments a few generated 8MB corpora are measured. For each
+   pass the cold call (fresh buffers) reports heap calls, bytes allocated,
+   the peak of live heap bytes above the level at call start, the bytes
+   the output buffer holds and bytes allocated per MB of input; the warm
+   call reuses the grown buffers, which is how long-lived workers run.
+*/
+
+#define GENERATED_BYTES (8u * 1024u * 1024u)
+
+static const char *GENERATED[] = { "prose", "nospace", "mixed" };
+#define NUM_GENERATED (sizeof(GENERATED) / sizeof(GENERATED[0]))
+
+typedef struct {
+    alloc_counters_t heap;
+    size_t buffer_bytes;
+} pass_usage_t;
+
+static void print_usage_row(const char *pass, const char *mode,
+                            const pass_usage_t *u, size_t length)
+{
+    double mb = (double)length / (1024.0 * 1024.0);
+    printf("  %-8s %-5s %8llu %8llu %14llu %14lld %14zu %14.0f\n",
+           pass, mode,
+           (unsigned long long)u->heap.mallocs,
+           (unsigned long long)u->heap.reallocs,
+           (unsigned long long)u->heap.bytes_allocated,
+           (long long)u->heap.peak_live_bytes,
+           u->buffer_bytes,
+           mb > 0.0 ? (double)u->heap.bytes_allocated / mb : 0.0);
+}
+
+static void measure(const char *name, const char *text, size_t length) {
+    pass_usage_t first_cold, first_warm, second_cold, second_warm;
+    size_t num_first = 0, num_final = 0;
+
+    // Buffers start at the size callers typically pass; growth is measured
+    aml_buffer_t *bh1 = aml_buffer_init(1024);
+    aml_buffer_t *bh2 = aml_buffer_init(1024);
+
+    alloc_counters_reset();
+    a_sentence_chunk_t *first = a_sentence_chunker_len(&num_first, bh1, text, length);
+    alloc_counters_get(&first_cold.heap);
+    first_cold.buffer_bytes = aml_buffer_length(bh1);
+
+    alloc_counters_reset();
+    a_rechunk_sentences(&num_final, bh2, text, first, num_first, 5, 250);
+    alloc_counters_get(&second_cold.heap);
+    second_cold.buffer_bytes = aml_buffer_length(bh2);
+
+    alloc_counters_reset();
+    first = a_sentence_chunker_len(&num_first, bh1, text, length);
+    alloc_counters_get(&first_warm.heap);
+    first_warm.buffer_bytes = aml_buffer_length(bh1);
+
+    alloc_counters_reset();
+    a_rechunk_sentences(&num_final, bh2, text, first, num_first, 5, 250);
+    alloc_counters_get(&second_warm.heap);
+    second_warm.buffer_bytes = aml_buffer_length(bh2);
+
+    printf("\n=== %s (%zu bytes, %zu -> %zu chunks) ===\n", name, length, num_first, num_final);
+    printf("  %-8s %-5s %8s %8s %14s %14s %14s %14s\n",
+           "pass", "call", "allocs", "reallocs", "bytes_alloc", "peak_delta", "buffer_bytes", "bytes/MB");
+    print_usage_row("first", "cold", &first_cold, length);
+    print_usage_row("first", "warm", &first_warm, length);
+    print_usage_row("rechunk", "cold", &second_cold, length);
+    print_usage_row("rechunk", "warm", &second_warm, length);
+
+    aml_buffer_destroy(bh1);
+    aml_buffer_destroy(bh2);
+}
+
+int main(int argc, char *argv[]) {
+    if (!alloc_counters_enabled()) {
+        fprintf(stderr, "memory_bench must be linked with -Wl,--wrap=malloc (Linux only)\n");
+        return 1;
+    }
+#ifdef _AML_DEBUG_
+    printf("a-memory-library debug tracking: on\n");
+#else
+    printf("a-memory-library debug tracking: off\n");
+#endif
+
+    if (argc > 1) {
+        for (int a = 1; a < argc; a++) {
+            size_t length = 0;
+            char *text = read_file(argv[a], &length);
+            if (!text) {
+                fprintf(stderr, "Could not read corpus: %s\n", argv[a]);
+                return 1;
+            }
+            measure(argv[a], text, length);
+            free(text);
+        }
+        return 0;
+    }
+
+    for (size_t i = 0; i < NUM_GENERATED; i++) {
+        corpus_profile_t profile;
+        corpus_profile_preset(&profile, GENERATED[i], 59);
+        char *text = corpus_generate(&profile, GENERATED_BYTES);
+        measure(GENERATED[i], text, GENERATED_BYTES);
+        free(text);
+    }
+    return 0;
+}
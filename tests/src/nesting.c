@@ -0,0 +1,135 @@
+// SPDX-FileCopyrightText: 2025 Andy Curtis <contactandyc@gmail.com>
+// SPDX-FileCopyrightText: 2024–2025 Knode.ai — technical questions: contact Andy (above)
+// SPDX-License-Identifier: Apache-2.0
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "a-sentence-chunker-library/a_sentence_chunker.h"
+#include "corpus_gen.h"
+
+/*
+   Nesting test: options.nesting keeps sentence ends inside quotes and
+   brackets out of the first pass (SUPPRESS) or moves them to the close
+   of the span (DEFER). Checks the documented cases, the depth cap and
+   blank-line reset, and on every corpus profile that SUPPRESS only ever
+   removes rule-engine boundaries.
+*/
+
+static const char *MODE_NAMES[] = { "off", "suppress", "defer" };
+
+static bool expect(a_sentence_chunker_nesting_t mode, unsigned max_depth, const char *text,
+                   const char *const *expected)
+{
+    aml_buffer_t *bh = aml_buffer_init(256);
+    a_sentence_chunker_options_t opts;
+    memset(&opts, 0, sizeof(opts));
+    opts.nesting = mode;
+    opts.nesting_max_depth = max_depth;
+    size_t num = 0;
+    a_sentence_chunk_t *c = a_sentence_chunker_opts(&num, bh, text, strlen(text), &opts);
+    bool ok = true;
+    size_t k = 0;
+    for (; expected[k]; k++) {
+        ok &= k < num && c[k].length == strlen(expected[k]) &&
+              memcmp(text + c[k].start_offset, expected[k], c[k].length) == 0;
+    }
+    ok &= k == num;
+    if (!ok) {
+        printf("  %s: \"%s\" gave", MODE_NAMES[mode], text);
+        for (size_t j = 0; j < num; j++) {
+            printf(" [%.*s]", (int)c[j].length, text + c[j].start_offset);
+        }
+        printf("\n");
+    }
+    aml_buffer_destroy(bh);
+    return ok;
+}
+
+// Every chunk end under SUPPRESS must also be a chunk end under OFF
+static bool suppress_subset(const char *text, size_t len) {
+    aml_buffer_t *off_bh = aml_buffer_init(1024);
+    aml_buffer_t *sup_bh = aml_buffer_init(1024);
+    a_sentence_chunker_options_t opts;
+    memset(&opts, 0, sizeof(opts));
+    size_t no = 0, ns = 0;
+    a_sentence_chunk_t *off = a_sentence_chunker_opts(&no, off_bh, text, len, &opts);
+    opts.nesting = A_SENTENCE_CHUNKER_NESTING_SUPPRESS;
+    a_sentence_chunk_t *sup = a_sentence_chunker_opts(&ns, sup_bh, text, len, &opts);
+    bool ok = ns <= no;
+    size_t j = 0, prev_end = 0;
+    for (size_t k = 0; k < ns && ok; k++) {
+        size_t end = sup[k].start_offset + sup[k].length;
+        ok = sup[k].length > 0 && sup[k].start_offset >= prev_end && end <= len;
+        while (j < no && off[j].start_offset + off[j].length < end) j++;
+        ok = ok && (k + 1 == ns || (j < no && off[j].start_offset + off[j].length == end));
+        prev_end = end;
+    }
+    aml_buffer_destroy(off_bh);
+    aml_buffer_destroy(sup_bh);
+    return ok;
+}
+
+int main(void) {
+    bool ok = true;
+    const char *fig = "He said (see Fig. 3. It shows X.) and left. Then he came.";
+    ok &= expect(A_SENTENCE_CHUNKER_NESTING_OFF, 0, fig, (const char *const[]){
+        "He said (see Fig.", "3.", "It shows X.) and left.", "Then he came.", NULL });
+    for (int mode = 1; mode <= 2; mode++) {
+        ok &= expect(mode, 0, fig, (const char *const[]){
+            "He said (see Fig. 3. It shows X.) and left.", "Then he came.", NULL });
+        ok &= expect(mode, 0, "He said \"Stop. Go home.\" She left.", (const char *const[]){
+            "He said \"Stop. Go home.\"", "She left.", NULL });
+        ok &= expect(mode, 0, "\"Stop!\" he said. Then left.", (const char *const[]){
+            "\"Stop!\" he said.", "Then left.", NULL });
+        ok &= expect(mode, 0, "(See above.) Next one.", (const char *const[]){
+            "(See above.)", "Next one.", NULL });
+        // A stray closer neither opens a span nor goes negative
+        ok &= expect(mode, 0, "He left.\" Then \"it. Is.\" So.", (const char *const[]){
+            "He left.\"", "Then \"it. Is.\"", "So.", NULL });
+        // Unclosed spans end at their last boundary at a blank line or the end
+        ok &= expect(mode, 0, "He said \"Stop. Go home.\n\nNext para. Two.",
+                     (const char *const[]){ "He said \"Stop. Go home.", "Next para.", "Two.", NULL });
+        ok &= expect(mode, 0, "Unclosed (paren. Here. Now. End", (const char *const[]){
+            "Unclosed (paren. Here. Now.", "End", NULL });
+    }
+    ok &= expect(A_SENTENCE_CHUNKER_NESTING_SUPPRESS, 0, "(Yes. No) Then we went. Ok.",
+                 (const char *const[]){ "(Yes. No) Then we went.", "Ok.", NULL });
+    ok &= expect(A_SENTENCE_CHUNKER_NESTING_DEFER, 0, "(Yes. No) Then we went. Ok.",
+                 (const char *const[]){ "(Yes. No)", "Then we went.", "Ok.", NULL });
+    ok &= expect(A_SENTENCE_CHUNKER_NESTING_DEFER, 0, "He said (yes. no) and left.",
+                 (const char *const[]){ "He said (yes. no) and left.", NULL });
+    // Past the depth cap the text is treated as malformed and nesting resets
+    ok &= expect(A_SENTENCE_CHUNKER_NESTING_SUPPRESS, 2, "(((a. b. c. D.", (const char *const[]){
+        "(((a.", "b.", "c.", "D.", NULL });
+    ok &= expect(A_SENTENCE_CHUNKER_NESTING_SUPPRESS, 3, "(((a. b. c. D.", (const char *const[]){
+        "(((a. b. c.", "D.", NULL });
+    printf("%s: cases\n", ok ? "PASS" : "FAIL");
+
+    static const char *PROFILES[] = {
+        "prose", "abbrev", "numeric", "lists", "nospace", "cjk", "crlf", "dotted", "longtail", "mixed"
+    };
+    bool pass = true;
+    for (size_t p = 0; p < sizeof(PROFILES) / sizeof(PROFILES[0]) && pass; p++) {
+        corpus_profile_t profile;
+        corpus_profile_preset(&profile, PROFILES[p], 70);
+        size_t len = 1u << 18;
+        char *corpus = corpus_generate(&profile, len);
+        // Sprinkle unbalanced brackets and quotes over the corpus
+        uint64_t x = 0x2545F4914F6CDD1Dull;
+        for (size_t k = 0; k < len; k++) {
+            x ^= x << 13;
+            x ^= x >> 7;
+            x ^= x << 17;
+            if (x % 97 == 0) corpus[k] = "()[]{}\"\""[(x >> 8) % 8];
+        }
+        pass = suppress_subset(corpus, len);
+        if (!pass) printf("  profile %s\n", PROFILES[p]);
+        free(corpus);
+    }
+    printf("%s: suppress only removes boundaries\n", pass ? "PASS" : "FAIL");
+    ok &= pass;
+    return ok ? 0 : 1;
+}
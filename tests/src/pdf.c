@@ -0,0 +1,150 @@
+// SPDX-FileCopyrightText: 2025 Andy Curtis <contactandyc@gmail.com>
+// SPDX-FileCopyrightText: 2024–2025 Knode.ai — technical questions: contact Andy (above)
+// SPDX-License-Identifier: Apache-2.0
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "a-sentence-chunker-library/a_sentence_chunker.h"
+#include "a-sentence-chunker-library/a_sentence_chunker_counters.h"
+#include "a-sentence-chunker-library/a_sentence_chunker_trace.h"
+#include "chunk_check.h"
+
+/*
+   PDF test: A_SENTENCE_CHUNKER_FORMAT_PDF reads hard-wrapped, hyphenated
+   extracted text. Checks that blank lines end paragraphs in the first
+   pass, and on generated wrapped text that the second pass never
+   prefers a lone newline (heuristic 2, per the decision trace) and never
+   splits a word hyphenated across lines, where plain text does both.
+*/
+
+static uint64_t x = 0x9E3779B97F4A7C15ull;
+
+static uint64_t next_rand(void) {
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    return x;
+}
+
+/* Lowercase words wrapped at width columns; about one line in three ends
+   in a word hyphenated onto the next line. Sentences end every few lines. */
+static size_t wrapped_text(char *out, size_t words, size_t width) {
+    size_t n = 0, col = 0;
+    for (size_t w = 0; w < words; w++) {
+        char word[16];
+        size_t wl = 3 + next_rand() % 9;
+        for (size_t k = 0; k < wl; k++) {
+            word[k] = (char)('a' + next_rand() % 26);
+        }
+        if (col + wl > width) {
+            if (wl >= 6 && next_rand() % 3 == 0) {
+                size_t cut = 2 + next_rand() % (wl - 4);
+                memcpy(out + n, word, cut);
+                n += cut;
+                memcpy(out + n, "-\n", 2);
+                n += 2;
+                memcpy(out + n, word + cut, wl - cut);
+                n += wl - cut;
+                col = wl - cut;
+                out[n++] = next_rand() % 11 == 0 ? '.' : ' ';
+                if (out[n - 1] == '.') out[n++] = ' ';
+                col++;
+                continue;
+            }
+            out[n - 1] = '\n';
+            col = 0;
+        }
+        memcpy(out + n, word, wl);
+        n += wl;
+        out[n++] = next_rand() % 11 == 0 ? '.' : ' ';
+        if (out[n - 1] == '.') out[n++] = ' ';
+        col += wl + 1;
+    }
+    out[n - 1] = '.';
+    return n;
+}
+
+/* True when pos falls in a hyphen join: after "x-" and up to the
+   lowercase letter that continues the word on the next line. */
+static bool in_join(const char *text, size_t len, size_t pos) {
+    size_t a = pos;
+    while (a > 0 && (text[a - 1] == '\n' || text[a - 1] == ' ')) a--;
+    size_t b = pos;
+    while (b < len && (text[b] == '\n' || text[b] == ' ')) b++;
+    bool newline = memchr(text + a, '\n', b - a) != NULL;
+    return newline && a >= 2 && text[a - 1] == '-' && text[a - 2] >= 'a' && text[a - 2] <= 'z' &&
+           b < len && text[b] >= 'a' && text[b] <= 'z';
+}
+
+int main(void) {
+    bool ok = true;
+    a_sentence_chunker_options_t opts = chunk_check_options(A_SENTENCE_CHUNKER_FORMAT_PDF);
+    aml_buffer_t *first = aml_buffer_init(1024);
+    aml_buffer_t *second = aml_buffer_init(1024);
+    size_t num = 0, num2 = 0;
+
+    const char *page =
+        "  The infor-\nmation was\ncollected. Next sen-\ntence is\r\nhere.\n \n"
+        "INTRODUCTION\n\n"
+        "A new para\ngraph, e.g. this\none\n\n\n12\n";
+    a_sentence_chunk_t *c = a_sentence_chunker_opts(&num, first, page, strlen(page), &opts);
+    ok &= chunk_check_text(page, c, num, (const char *const[]){
+        "The infor-\nmation was\ncollected.", "Next sen-\ntence is\r\nhere.", "INTRODUCTION",
+        "A new para\ngraph, e.g. this\none", "12", NULL }, "first pass");
+    printf("%s: paragraphs\n", ok ? "PASS" : "FAIL");
+
+    // Generated wrapped text, split by both modes
+    char *text = malloc(1u << 16);
+    aml_buffer_t *plain = aml_buffer_init(1024);
+    a_sentence_chunker_trace_t *trace = a_sentence_chunker_trace_init(1 << 12);
+    a_sentence_chunker_trace_record_t *recs = malloc((1 << 12) * sizeof(*recs));
+    bool pass = true;
+    size_t newline[2] = { 0, 0 }, joins[2] = { 0, 0 }, splits = 0;
+    for (int doc = 0; doc < 200 && pass; doc++) {
+        size_t len = wrapped_text(text, 60 + next_rand() % 400, 30 + next_rand() % 50);
+        c = a_sentence_chunker_opts(&num, first, text, len, &opts);
+        size_t min = 10 + next_rand() % 40, max = min + 20 + next_rand() % 120;
+        for (int pdf = 0; pdf < 2; pdf++) {
+            a_sentence_chunker_trace_reset(trace);
+            a_sentence_chunker_trace_attach(trace);
+            a_sentence_chunk_t *r = pdf
+                ? a_rechunk_sentences_opts(&num2, second, text, c, num, min, max, &opts)
+                : a_rechunk_sentences(&num2, plain, text, c, num, min, max);
+            a_sentence_chunker_trace_attach(NULL);
+            size_t got = a_sentence_chunker_trace_read(trace, recs, 1 << 12);
+            for (size_t k = 0; k < got; k++) {
+                newline[pdf] += recs[k].event == A_SENTENCE_CHUNKER_TRACE_SPLIT &&
+                                recs[k].rule == A_SPLIT_NEWLINE;
+            }
+            size_t prev_end = 0;
+            for (size_t k = 0; k < num2 && pass; k++) {
+                size_t s = r[k].start_offset, e = s + r[k].length;
+                pass = r[k].length > 0 && s >= prev_end && e <= len;
+                if (k > 0 && s == prev_end) {
+                    joins[pdf] += in_join(text, len, s);
+                    splits += pdf;
+                }
+                prev_end = e;
+            }
+        }
+    }
+    pass = pass && splits > 100 && newline[1] == 0 && joins[1] == 0 && newline[0] > 0 &&
+           joins[0] > 0;
+    if (!pass) {
+        printf("  %zu splits: %zu by newline, %zu in words (plain text: %zu, %zu)\n", splits,
+               newline[1], joins[1], newline[0], joins[0]);
+    }
+    printf("%s: wrapped text\n", pass ? "PASS" : "FAIL");
+    ok &= pass;
+
+    a_sentence_chunker_trace_destroy(trace);
+    free(recs);
+    free(text);
+    aml_buffer_destroy(plain);
+    aml_buffer_destroy(first);
+    aml_buffer_destroy(second);
+    return ok ? 0 : 1;
+}
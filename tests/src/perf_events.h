@@ -0,0 +1,128 @@
+// SPDX-FileCopyrightText: 2025 Andy Curtis <contactandyc@gmail.com>
+// SPDX-FileCopyrightText: 2024–2025 Knode.ai — technical questions: contact Andy (above)
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _perf_events_h
+#define _perf_events_h
+
+/*
+   Minimal hardware counter helper for the test and benchmark binaries
+   (Linux perf_event_open). Events the kernel or PMU refuses -- common in
+   VMs and containers -- are marked unavailable instead of failing the run.
+   Counts are scaled for multiplexing.
+*/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+typedef enum {
+    PERF_EV_CYCLES = 0,
+    PERF_EV_INSTRUCTIONS,
+    PERF_EV_BRANCHES,
+    PERF_EV_BRANCH_MISSES,
+    PERF_EV_L1D_MISSES,
+    PERF_EV_LLC_MISSES,
+    PERF_EV_COUNT
+} perf_event_id_t;
+
+typedef struct {
+    int fd[PERF_EV_COUNT];
+    uint64_t value[PERF_EV_COUNT];
+} perf_events_t;
+
+static inline bool perf_events_available(const perf_events_t *p, perf_event_id_t ev) {
+    return p->fd[ev] >= 0;
+}
+
+#ifdef __linux__
+
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+static inline int perf_event_open_one(uint32_t type, uint64_t config) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+/* Returns false if no event at all could be opened. */
+static inline bool perf_events_open(perf_events_t *p) {
+    static const struct { uint32_t type; uint64_t config; } events[PERF_EV_COUNT] = {
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_INSTRUCTIONS },
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+        { PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D |
+                              (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                              (PERF_COUNT_HW_CACHE_RESULT_MISS << 16) },
+        { PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_LL |
+                              (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                              (PERF_COUNT_HW_CACHE_RESULT_MISS << 16) },
+    };
+    bool any = false;
+    for (int i = 0; i < PERF_EV_COUNT; i++) {
+        p->fd[i] = perf_event_open_one(events[i].type, events[i].config);
+        p->value[i] = 0;
+        any |= p->fd[i] >= 0;
+    }
+    return any;
+}
+
+static inline void perf_events_close(perf_events_t *p) {
+    for (int i = 0; i < PERF_EV_COUNT; i++) {
+        if (p->fd[i] >= 0) close(p->fd[i]);
+        p->fd[i] = -1;
+    }
+}
+
+static inline void perf_events_start(perf_events_t *p) {
+    for (int i = 0; i < PERF_EV_COUNT; i++) {
+        if (p->fd[i] < 0) continue;
+        ioctl(p->fd[i], PERF_EVENT_IOC_RESET, 0);
+        ioctl(p->fd[i], PERF_EVENT_IOC_ENABLE, 0);
+    }
+}
+
+/* Stop counting and store the (multiplex-scaled) totals in p->value. */
+static inline void perf_events_stop(perf_events_t *p) {
+    for (int i = 0; i < PERF_EV_COUNT; i++) {
+        if (p->fd[i] >= 0) ioctl(p->fd[i], PERF_EVENT_IOC_DISABLE, 0);
+    }
+    for (int i = 0; i < PERF_EV_COUNT; i++) {
+        p->value[i] = 0;
+        if (p->fd[i] < 0) continue;
+        uint64_t data[3]; // value, time_enabled, time_running
+        if (read(p->fd[i], data, sizeof(data)) != (ssize_t)sizeof(data)) continue;
+        if (data[2] && data[2] < data[1]) {
+            data[0] = (uint64_t)((double)data[0] * (double)data[1] / (double)data[2]);
+        }
+        p->value[i] = data[0];
+    }
+}
+
+#else
+
+static inline bool perf_events_open(perf_events_t *p) {
+    for (int i = 0; i < PERF_EV_COUNT; i++) {
+        p->fd[i] = -1;
+        p->value[i] = 0;
+    }
+    return false;
+}
+static inline void perf_events_close(perf_events_t *p) { (void)p; }
+static inline void perf_events_start(perf_events_t *p) { (void)p; }
+static inline void perf_events_stop(perf_events_t *p) { (void)p; }
+
+#endif
+
+#endif
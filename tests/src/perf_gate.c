@@ -0,0 +1,297 @@
+// SPDX-FileCopyrightText: 2025 Andy Curtis <contactandyc@gmail.com>
+// SPDX-FileCopyrightText: 2024–2025 Knode.ai — technical questions: contact Andy (above)
+// SPDX-License-Identifier: Apache-2.0
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "a-json-library/ajson.h"
+#include "a-memory-library/aml_pool.h"
+#include "a-sentence-chunker-library/a_sentence_chunker.h"
+#include "alloc_counters.h"
+#include "corpus_gen.h"
+#include "perf_events.h"
+#include "read_file.h"
+
+/*
+   perf_gate: performance regression test.
+
+   Runs both passes over generated corpora and compares machine-independent
+   metrics against a checked-in baseline:
+
+     <profile>.<pass>.instructions_per_byte  (needs perf_event_open)
+     <profile>.<pass>.allocs_per_call        (needs --wrap malloc linking)
+     <profile>.<pass>.scaling_ratio          cost(8N) / (8 * cost(N))
+
+   cost is retired instructions when available, otherwise the best of
+   several wall-clock runs. A linear pass has a scaling ratio near 1.0; an
+   accidental quadratic walk shows up as a large ratio on every machine.
+
+     perf_gate <baseline.json> [--variant NAME] [--update]
+
+   --update prints a fresh baseline to stdout. A metric that cannot be
+   checked is reported as SKIP and the rest are still enforced: perf
+   counters are unavailable, the baseline lacks the metric, or (for
+   instructions_per_byte) it was recorded for another variant. Exits 1 on
+   a regression and SKIP_CODE only when no metric was checked at all, which
+   ctest reports as skipped.
+*/
+
+#define SMALL_BYTES  (256u * 1024u)
+#define SCALE        8u
+#define REPS         7
+#define ALLOC_CALLS  16
+#define MAX_METRICS  128
+#define SKIP_CODE    77
+
+static const char *PROFILES[] = { "prose", "abbrev", "dotted", "longtail", "nospace", "mixed" };
+#define NUM_PROFILES (sizeof(PROFILES) / sizeof(PROFILES[0]))
+
+typedef struct {
+    char key[96];
+    double value;
+    bool measured; // false: no counters on this host, reported as SKIP
+} metric_t;
+
+static metric_t metrics[MAX_METRICS];
+static size_t num_metrics = 0;
+
+typedef struct {
+    aml_buffer_t *first;
+    aml_buffer_t *second;
+    a_sentence_chunk_t *first_chunks;
+    size_t first_count;
+} bench_t;
+
+static void add_metric(const char *profile, const char *pass, const char *name, double value,
+                       bool measured)
+{
+    if (num_metrics == MAX_METRICS) return;
+    metric_t *m = &metrics[num_metrics++];
+    snprintf(m->key, sizeof(m->key), "%s.%s.%s", profile, pass, name);
+    m->value = value;
+    m->measured = measured;
+}
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static void run_pass(bench_t *b, int pass, const char *text, size_t len) {
+    size_t n = 0;
+    if (pass == 0) {
+        a_sentence_chunker_len(&n, b->first, text, len);
+    } else {
+        a_rechunk_sentences(&n, b->second, text, b->first_chunks, b->first_count, 40, 400);
+    }
+}
+
+/* Best-of-REPS cost of one call: instructions if counted, else ns. */
+static double measure_cost(bench_t *b, perf_events_t *p, bool use_perf,
+                           int pass, const char *text, size_t len)
+{
+    b->first_chunks = a_sentence_chunker_len(&b->first_count, b->first, text, len);
+    run_pass(b, pass, text, len); // warm up
+    double best = 0.0;
+    for (int r = 0; r < REPS; r++) {
+        double cost;
+        if (use_perf) {
+            perf_events_start(p);
+            run_pass(b, pass, text, len);
+            perf_events_stop(p);
+            cost = (double)p->value[PERF_EV_INSTRUCTIONS];
+        } else {
+            double t0 = now_ns();
+            run_pass(b, pass, text, len);
+            cost = now_ns() - t0;
+        }
+        if (r == 0 || cost < best) best = cost;
+    }
+    return best;
+}
+
+static double measure_allocs(bench_t *b, int pass, const char *text, size_t len) {
+    b->first_chunks = a_sentence_chunker_len(&b->first_count, b->first, text, len);
+    run_pass(b, pass, text, len); // buffers reach their steady-state size
+    alloc_counters_reset();
+    for (int r = 0; r < ALLOC_CALLS; r++) {
+        run_pass(b, pass, text, len);
+    }
+    alloc_counters_t c;
+    alloc_counters_get(&c);
+    return (double)(c.mallocs + c.reallocs) / ALLOC_CALLS;
+}
+
+// ----------------------------------------------------------------------------
+//                                 BASELINE
+// ----------------------------------------------------------------------------
+
+static double json_number(aml_pool_t *pool, ajson_t *obj, const char *key, double dflt) {
+    ajson_t *node = obj ? ajsono_get(obj, key) : NULL;
+    if (!node || ajson_is_error(node)) return dflt;
+    const char *s = ajson_to_strd(pool, node, NULL);
+    return s ? strtod(s, NULL) : dflt;
+}
+
+static const char *metric_kind(const char *key) {
+    const char *dot = strrchr(key, '.');
+    return dot ? dot + 1 : key;
+}
+
+static void print_baseline(const char *variant) {
+    printf("{\n");
+    printf("  \"variant\": \"%s\",\n", variant);
+    printf("  \"thresholds\": {\n");
+    printf("    \"instructions_per_byte\": 1.10,\n");
+    printf("    \"allocs_per_call\": 1.00,\n");
+    printf("    \"scaling_ratio\": 1.50\n");
+    printf("  },\n");
+    printf("  \"slack\": {\n");
+    printf("    \"instructions_per_byte\": 0.0,\n");
+    printf("    \"allocs_per_call\": 0.5,\n");
+    printf("    \"scaling_ratio\": 0.25\n");
+    printf("  },\n");
+    printf("  \"metrics\": {\n");
+    bool comma = false;
+    for (size_t i = 0; i < num_metrics; i++) {
+        if (!metrics[i].measured) continue;
+        printf("%s    \"%s\": %.3f", comma ? ",\n" : "", metrics[i].key, metrics[i].value);
+        comma = true;
+    }
+    printf("\n");
+    printf("  }\n}\n");
+}
+
+/* Returns the number of regressions; *checked counts metrics enforced. */
+static int compare(const char *baseline_file, const char *variant, size_t *checked) {
+    *checked = 0;
+    char *json = read_file(baseline_file, NULL);
+    if (!json) {
+        printf("No baseline at %s; nothing enforced.\n", baseline_file);
+        return 0;
+    }
+    aml_pool_t *pool = aml_pool_init(64 * 1024);
+    ajson_t *root = ajson_parse_string(pool, json);
+    if (ajson_is_error(root) || ajson_type(root) != object) {
+        printf("Invalid baseline JSON: %s\n", baseline_file);
+        aml_pool_destroy(pool);
+        free(json);
+        return 1;
+    }
+    ajson_t *values = ajsono_get(root, "metrics");
+    ajson_t *thresholds = ajsono_get(root, "thresholds");
+    ajson_t *slack = ajsono_get(root, "slack");
+    const char *base_variant = ajsono_scan_strd(pool, root, "variant", "");
+
+    int regressions = 0;
+    size_t skipped = 0;
+    printf("%-44s %12s %12s %12s  %s\n", "metric", "baseline", "limit", "measured", "result");
+    for (size_t i = 0; i < num_metrics; i++) {
+        const metric_t *m = &metrics[i];
+        const char *kind = metric_kind(m->key);
+        double base = json_number(pool, values, m->key, -1.0);
+        if (base < 0.0 || !m->measured) {
+            printf("%-44s %12s %12s %12s  SKIP (%s)\n", m->key, "-", "-", "-",
+                   base < 0.0 ? "not in baseline" : "no perf counters");
+            skipped++;
+            continue;
+        }
+        double limit = base * json_number(pool, thresholds, kind, 1.25) +
+                       json_number(pool, slack, kind, 0.0);
+        if (!strcmp(kind, "instructions_per_byte") && strcmp(base_variant, variant)) {
+            printf("%-44s %12.3f %12s %12.3f  SKIP (baseline is for another variant)\n",
+                   m->key, base, "-", m->value);
+            skipped++;
+            continue;
+        }
+        const char *result = "ok";
+        if (m->value > limit) {
+            result = "REGRESSION";
+            regressions++;
+        }
+        (*checked)++;
+        printf("%-44s %12.3f %12.3f %12.3f  %s\n", m->key, base, limit, m->value, result);
+    }
+    printf("%zu metrics checked, %zu skipped.\n", *checked, skipped);
+    aml_pool_destroy(pool);
+    free(json);
+    return regressions;
+}
+
+int main(int argc, char *argv[]) {
+    const char *baseline = NULL;
+    const char *variant = "unknown";
+    bool update = false;
+    for (int a = 1; a < argc; a++) {
+        if (!strcmp(argv[a], "--update")) {
+            update = true;
+        } else if (!strcmp(argv[a], "--variant") && a + 1 < argc) {
+            variant = argv[++a];
+        } else {
+            baseline = argv[a];
+        }
+    }
+    if (!baseline && !update) {
+        fprintf(stderr, "Usage: %s <baseline.json> [--variant NAME] [--update]\n", argv[0]);
+        return 1;
+    }
+
+    perf_events_t p;
+    bool use_perf = perf_events_open(&p) && perf_events_available(&p, PERF_EV_INSTRUCTIONS);
+    if (!use_perf) {
+        fprintf(stderr, "perf_event_open unavailable: instructions_per_byte skipped, "
+                        "scaling measured with wall-clock time\n");
+    }
+    if (!alloc_counters_enabled()) {
+        fprintf(stderr, "allocation wrapping unavailable: allocs_per_call skipped\n");
+    }
+
+    bench_t b;
+    b.first = aml_buffer_init(1024);
+    b.second = aml_buffer_init(1024);
+
+    static const char *pass_names[] = { "first", "rechunk" };
+    for (size_t i = 0; i < NUM_PROFILES; i++) {
+        corpus_profile_t profile;
+        corpus_profile_preset(&profile, PROFILES[i], 57);
+        // The small corpus is a prefix of the large one, so both share stats
+        char *text = corpus_generate(&profile, SMALL_BYTES * SCALE);
+
+        for (int pass = 0; pass < 2; pass++) {
+            double small = measure_cost(&b, &p, use_perf, pass, text, SMALL_BYTES);
+            double large = measure_cost(&b, &p, use_perf, pass, text, SMALL_BYTES * SCALE);
+            add_metric(PROFILES[i], pass_names[pass], "instructions_per_byte",
+                       use_perf ? large / (double)(SMALL_BYTES * SCALE) : 0.0, use_perf);
+            if (alloc_counters_enabled()) {
+                add_metric(PROFILES[i], pass_names[pass], "allocs_per_call",
+                           measure_allocs(&b, pass, text, SMALL_BYTES), true);
+            }
+            add_metric(PROFILES[i], pass_names[pass], "scaling_ratio",
+                       small > 0.0 ? large / (small * SCALE) : 0.0, true);
+        }
+        free(text);
+    }
+    aml_buffer_destroy(b.first);
+    aml_buffer_destroy(b.second);
+    perf_events_close(&p);
+
+    if (update) {
+        print_baseline(variant);
+        return 0;
+    }
+    size_t checked = 0;
+    int regressions = compare(baseline, variant, &checked);
+    if (regressions) {
+        printf("Performance regressions detected.\n");
+        return 1;
+    }
+    if (!checked) {
+        printf("SKIPPED: no metric could be checked.\n");
+        return SKIP_CODE;
+    }
+    printf("No performance regressions.\n");
+    return 0;
+}
@@ -0,0 +1,32 @@
+// SPDX-FileCopyrightText: 2025 Andy Curtis <contactandyc@gmail.com>
+// SPDX-FileCopyrightText: 2024–2025 Knode.ai — technical questions: contact Andy (above)
+// SPDX-License-Identifier: Apache-2.0
+
+#include "read_file.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+char *read_file(const char *filename, size_t *out_length) {
+    FILE *fp = fopen(filename, "rb");
+    if (!fp) {
+        perror(filename);
+        return NULL;
+    }
+    fseek(fp, 0, SEEK_END);
+    long fsize = ftell(fp);
+    rewind(fp);
+    char *buffer = fsize >= 0 ? (char *)malloc((size_t)fsize + 1) : NULL;
+    if (!buffer || fread(buffer, 1, (size_t)fsize, fp) != (size_t)fsize) {
+        fprintf(stderr, "%s: read failed\n", filename);
+        fclose(fp);
+        free(buffer);
+        return NULL;
+    }
+    fclose(fp);
+    buffer[fsize] = '\0';
+    if (out_length) {
+        *out_length = (size_t)fsize;
+    }
+    return buffer;
+}
@@ -0,0 +1,15 @@
+// SPDX-FileCopyrightText: 2025 Andy Curtis <contactandyc@gmail.com>
+// SPDX-FileCopyrightText: 2024–2025 Knode.ai — technical questions: contact Andy (above)
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _read_file_h
+#define _read_file_h
+
+#include <stddef.h>
+
+/* Read a whole file into a NUL-terminated buffer the caller frees.
+   *out_length (if not NULL) receives its size. Returns NULL, after
+   printing why, when the file cannot be read. */
+char *read_file(const char *filename, size_t *out_length);
+
+#endif
@@ -0,0 +1,256 @@
+// SPDX-FileCopyrightText: 2025 Andy Curtis <contactandyc@gmail.com>
+// SPDX-FileCopyrightText: 2024–2025 Knode.ai — technical questions: contact Andy (above)
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE // memfd_create, F_ADD_SEALS
+#endif
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include "a-sentence-chunker-library/a_sentence_chunker_shm.h"
+#include "read_file.h"
+
+/* Compare the spans the server wrote into the segment with a local run. */
+static int check(int sock, a_sentence_chunker_shm_t *shm,
+                 const char *content, size_t length,
+                 size_t min_length, size_t max_length)
+{
+    memcpy(a_sentence_chunker_shm_text(shm), content, length);
+
+    size_t num = 0;
+    a_sentence_chunk_t *remote = a_sentence_chunker_shm_request(
+        &num, shm, sock, length, min_length, max_length);
+
+    aml_buffer_t *bh1 = aml_buffer_init(32);
+    aml_buffer_t *bh2 = aml_buffer_init(32);
+    size_t expected = 0;
+    a_sentence_chunk_t *local = a_sentence_chunker_len(&expected, bh1, content, length);
+    if (max_length) {
+        local = a_rechunk_sentences(&expected, bh2, content, local, expected,
+                                    min_length, max_length);
+    }
+
+    int ok = (num == expected) &&
+             (num == 0 || memcmp(remote, local, num * sizeof(a_sentence_chunk_t)) == 0);
+    printf("%s: %zu spans (min=%zu, max=%zu)\n", ok ? "PASS" : "FAIL",
+           num, min_length, max_length);
+
+    aml_buffer_destroy(bh1);
+    aml_buffer_destroy(bh2);
+    return ok;
+}
+
+/* Send one request, handing over fd (-1: none) with SCM_RIGHTS. */
+static bool send_request(int sock, const a_sentence_chunker_shm_request_t *req, int fd) {
+    struct iovec iov = { (void *)req, sizeof(*req) };
+    union {
+        char buf[CMSG_SPACE(sizeof(int))];
+        struct cmsghdr align;
+    } control;
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    if (fd >= 0) {
+        msg.msg_control = control.buf;
+        msg.msg_controllen = sizeof(control.buf);
+        struct cmsghdr *c = CMSG_FIRSTHDR(&msg);
+        c->cmsg_level = SOL_SOCKET;
+        c->cmsg_type = SCM_RIGHTS;
+        c->cmsg_len = CMSG_LEN(sizeof(int));
+        memcpy(CMSG_DATA(c), &fd, sizeof(fd));
+    }
+    return sendmsg(sock, &msg, 0) == (ssize_t)sizeof(*req);
+}
+
+static bool read_reply(int sock, a_sentence_chunker_shm_reply_t *reply) {
+    return recv(sock, reply, sizeof(*reply), MSG_WAITALL) == (ssize_t)sizeof(*reply);
+}
+
+/*
+   lying_client: Hand the server a 4 KB segment whose request and header
+   claim 1 MB, sealed or not, and expect EINVAL rather than a SIGBUS.
+*/
+static int lying_client(int sock, bool seal) {
+    int fd = memfd_create("lying_client", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if (fd < 0 || ftruncate(fd, 4096) != 0 ||
+        (seal && fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK) != 0))
+    {
+        return 0;
+    }
+    a_sentence_chunker_shm_header_t hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    hdr.magic = A_SENTENCE_CHUNKER_SHM_MAGIC;
+    hdr.text_offset = 4096;
+    hdr.text_capacity = 1 << 20;
+    hdr.response_offset = (1 << 20) + 4096;
+    hdr.response_capacity = 16;
+    if (pwrite(fd, &hdr, sizeof(hdr), 0) != (ssize_t)sizeof(hdr)) {
+        close(fd);
+        return 0;
+    }
+    a_sentence_chunker_shm_request_t req;
+    memset(&req, 0, sizeof(req));
+    req.segment_size = (1 << 20) + 8192;
+    req.text_length = 1 << 19;
+
+    a_sentence_chunker_shm_reply_t reply;
+    int ok = send_request(sock, &req, fd) && read_reply(sock, &reply) &&
+             reply.status == A_SENTENCE_CHUNKER_SHM_EINVAL;
+    close(fd);
+    printf("%s: %s segment larger than claimed is refused\n", ok ? "PASS" : "FAIL",
+           seal ? "sealed" : "unsealed");
+    return ok;
+}
+
+typedef struct {
+    volatile uint64_t *response_offset;
+    uint64_t good;
+    volatile bool stop;
+} flipper_t;
+
+static void *flip_offset(void *arg) {
+    flipper_t *f = (flipper_t *)arg;
+    for (uint64_t k = 0; !f->stop; k++) {
+        *f->response_offset = (k & 1) ? (uint64_t)1 << 40 : f->good;
+    }
+    return NULL;
+}
+
+/*
+   racing_client: While requests run, a thread keeps flipping the header's
+   response_offset out of range. The server validates and uses one copy of
+   the header, so every reply is OK or EINVAL and it never writes outside
+   the segment.
+*/
+static int racing_client(int sock, const char *content, size_t length) {
+    size_t page = 4096;
+    size_t text_capacity = (length + page - 1) / page * page;
+    size_t chunk_capacity = length + 1;
+    size_t size = page + text_capacity + chunk_capacity * sizeof(a_sentence_chunk_t);
+    int fd = memfd_create("racing_client", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if (fd < 0 || ftruncate(fd, (off_t)size) != 0 ||
+        fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK) != 0)
+    {
+        return 0;
+    }
+    char *base = (char *)mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (base == MAP_FAILED) {
+        close(fd);
+        return 0;
+    }
+    a_sentence_chunker_shm_header_t *hdr = (a_sentence_chunker_shm_header_t *)base;
+    hdr->magic = A_SENTENCE_CHUNKER_SHM_MAGIC;
+    hdr->text_offset = page;
+    hdr->text_capacity = text_capacity;
+    hdr->response_offset = page + text_capacity;
+    hdr->response_capacity = chunk_capacity;
+    memcpy(base + page, content, length);
+
+    a_sentence_chunker_shm_request_t req;
+    memset(&req, 0, sizeof(req));
+    req.segment_size = size;
+    req.text_length = length;
+
+    flipper_t f = { &hdr->response_offset, page + text_capacity, false };
+    pthread_t thread;
+    int ok = pthread_create(&thread, NULL, flip_offset, &f) == 0;
+    size_t accepted = 0, refused = 0;
+    for (int r = 0; r < 200 && ok; r++) {
+        a_sentence_chunker_shm_reply_t reply;
+        ok = send_request(sock, &req, r == 0 ? fd : -1) && read_reply(sock, &reply);
+        if (ok && reply.status == A_SENTENCE_CHUNKER_SHM_OK) accepted++;
+        else if (ok && reply.status == A_SENTENCE_CHUNKER_SHM_EINVAL) refused++;
+        else ok = 0;
+    }
+    f.stop = true;
+    pthread_join(thread, NULL);
+    munmap(base, size);
+    close(fd);
+    printf("%s: header rewritten during requests (%zu ok, %zu refused)\n",
+           ok ? "PASS" : "FAIL", accepted, refused);
+    return ok;
+}
+
+static pid_t start_server(int *client) {
+    int fds[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) {
+        perror("socketpair");
+        return -1;
+    }
+    pid_t pid = fork();
+    if (pid == 0) {
+        close(fds[0]);
+        _exit(a_sentence_chunker_shm_serve(fds[1]) == 0 ? 0 : 1);
+    }
+    close(fds[1]);
+    *client = fds[0];
+    return pid;
+}
+
+static int stop_server(int client, pid_t pid) {
+    close(client);
+    int status = 0;
+    waitpid(pid, &status, 0);
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s <text file>\n", argv[0]);
+        return 1;
+    }
+    size_t length = 0;
+    char *content = read_file(argv[1], &length);
+    if (!content) {
+        return 1;
+    }
+
+    int sock = -1;
+    pid_t pid = start_server(&sock);
+    if (pid < 0) {
+        return 1;
+    }
+
+    // Deliberately tiny response region to exercise the grow-and-retry path
+    a_sentence_chunker_shm_t *shm = a_sentence_chunker_shm_init(length, 1);
+    int ok = shm != NULL;
+    if (ok) {
+        ok &= check(sock, shm, content, length, 0, 0);
+        ok &= check(sock, shm, content, length, 5, 250);
+        ok &= check(sock, shm, content, length, 40, 80);
+    }
+
+    // A new connection that reuses the old socket's fd number still gets the fd
+    ok &= stop_server(sock, pid);
+    int old = sock;
+    pid = start_server(&sock);
+    if (pid < 0 || (sock != old && (dup2(sock, old) < 0 || close(sock) != 0))) {
+        return 1;
+    }
+    sock = old;
+    ok &= shm && check(sock, shm, content, length, 5, 250);
+    a_sentence_chunker_shm_destroy(shm);
+
+    // The server survives clients that lie about sizes or race the header
+    ok &= lying_client(sock, true);
+    ok &= lying_client(sock, false);
+    ok &= racing_client(sock, content, length);
+    shm = a_sentence_chunker_shm_init(length, 1);
+    ok &= shm && check(sock, shm, content, length, 5, 250);
+    a_sentence_chunker_shm_destroy(shm);
+
+    ok &= stop_server(sock, pid);
+
+    free(content);
+    printf("%s\n", ok ? "All shm tests passed." : "shm tests FAILED.");
+    return ok ? 0 : 1;
+}
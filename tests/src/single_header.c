@@ -0,0 +1,66 @@
+// SPDX-FileCopyrightText: 2025 Andy Curtis <contactandyc@gmail.com>
+// SPDX-FileCopyrightText: 2024–2025 Knode.ai — technical questions: contact Andy (above)
+// SPDX-License-Identifier: Apache-2.0
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "a-sentence-chunker-library/a_sentence_chunker.h"
+#include "corpus_gen.h"
+#include "single_header_hot.h"
+#include "read_file.h"
+
+/*
+   Single-header test: the header-only copy compiled into
+   single_header_hot.c must produce exactly the linked library's chunks
+   on every corpus profile and on the files given on the command line.
+*/
+
+static const char *PROFILES[] = { "prose", "abbrev", "numeric", "lists", "nospace", "crlf", "mixed" };
+#define NUM_PROFILES (sizeof(PROFILES) / sizeof(PROFILES[0]))
+
+static aml_buffer_t *bh1, *bh2, *bh3, *bh4;
+
+static int compare(const char *name, const char *text, size_t len) {
+    size_t n1 = 0, n2 = 0, nh = 0;
+    a_sentence_chunk_t *first = a_sentence_chunker_len(&n1, bh1, text, len);
+    a_sentence_chunk_t *ref = a_rechunk_sentences(&n2, bh2, text, first, n1,
+                                                  HOT_MIN_LENGTH, HOT_MAX_LENGTH);
+    a_sentence_chunk_t *got = hot_chunk(&nh, bh3, bh4, text, len);
+    int ok = n2 == nh;
+    for (size_t k = 0; ok && k < n2; k++) {
+        ok = ref[k].start_offset == got[k].start_offset && ref[k].length == got[k].length;
+    }
+    printf("%s: %s (%zu chunks)\n", ok ? "PASS" : "FAIL", name, n2);
+    return ok;
+}
+
+int main(int argc, char *argv[]) {
+    bh1 = aml_buffer_init(1024);
+    bh2 = aml_buffer_init(1024);
+    bh3 = aml_buffer_init(1024);
+    bh4 = aml_buffer_init(1024);
+    int ok = !strcmp(hot_kernel(), "scalar");
+
+    for (size_t p = 0; p < NUM_PROFILES; p++) {
+        corpus_profile_t profile;
+        corpus_profile_preset(&profile, PROFILES[p], 63 + p);
+        size_t len = 1u << 20;
+        char *text = corpus_generate(&profile, len);
+        ok &= compare(PROFILES[p], text, len);
+        free(text);
+    }
+    for (int a = 1; a < argc; a++) {
+        size_t len = 0;
+        char *text = read_file(argv[a], &len);
+        if (!text) return 1;
+        ok &= compare(argv[a], text, len);
+        free(text);
+    }
+
+    aml_buffer_destroy(bh1);
+    aml_buffer_destroy(bh2);
+    aml_buffer_destroy(bh3);
+    aml_buffer_destroy(bh4);
+    return ok ? 0 : 1;
+}
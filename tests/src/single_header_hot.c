@@ -0,0 +1,27 @@
+// SPDX-FileCopyrightText: 2025 Andy Curtis <contactandyc@gmail.com>
+// SPDX-FileCopyrightText: 2024–2025 Knode.ai — technical questions: contact Andy (above)
+// SPDX-License-Identifier: Apache-2.0
+
+/*
+   The "hot" translation unit of test_single_header: the chunker is compiled
+   in here from the single header, and both passes run with constant
+   limits so the compiler can specialize them.
+*/
+
+#define A_SENTENCE_CHUNKER_HEADER_ONLY
+#include "a-sentence-chunker-library/a_sentence_chunker_single.h"
+
+#include "single_header_hot.h"
+
+a_sentence_chunk_t *hot_chunk(size_t *num, aml_buffer_t *bh1, aml_buffer_t *bh2,
+                              const char *text, size_t len)
+{
+    size_t n1 = 0;
+    a_sentence_chunk_t *first = a_sentence_chunker_len(&n1, bh1, text, len);
+    return a_rechunk_sentences(num, bh2, text, first, n1,
+                               HOT_MIN_LENGTH, HOT_MAX_LENGTH);
+}
+
+const char *hot_kernel(void) {
+    return a_sentence_chunker_kernel();
+}
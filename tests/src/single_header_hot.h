@@ -0,0 +1,20 @@
+// SPDX-FileCopyrightText: 2025 Andy Curtis <contactandyc@gmail.com>
+// SPDX-FileCopyrightText: 2024–2025 Knode.ai — technical questions: contact Andy (above)
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _single_header_hot_h
+#define _single_header_hot_h
+
+#include "a-sentence-chunker-library/a_sentence_chunker.h"
+
+#define HOT_MIN_LENGTH 40
+#define HOT_MAX_LENGTH 240
+
+/* Both passes through the header-only chunker with constant limits. */
+a_sentence_chunk_t *hot_chunk(size_t *num, aml_buffer_t *bh1, aml_buffer_t *bh2,
+                              const char *text, size_t len);
+
+/* Kernel name seen by the header-only copy (always "scalar"). */
+const char *hot_kernel(void);
+
+#endif
@@ -0,0 +1,107 @@
+// SPDX-FileCopyrightText: 2025 Andy Curtis <contactandyc@gmail.com>
+// SPDX-FileCopyrightText: 2024–2025 Knode.ai — technical questions: contact Andy (above)
+// SPDX-License-Identifier: Apache-2.0
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "a-sentence-chunker-library/a_sentence_chunker.h"
+#include "a-sentence-chunker-library/a_sentence_chunker_stats.h"
+#include "read_file.h"
+
+#define THREADS 2
+#define ROUNDS  50
+
+typedef struct {
+    const char *text;
+    size_t length;
+    a_sentence_chunker_stats_t *stats;
+    size_t first_chunks;
+    size_t final_chunks;
+} worker_t;
+
+static void *worker(void *arg) {
+    worker_t *w = (worker_t *)arg;
+    a_sentence_chunker_stats_attach(w->stats);
+
+    aml_buffer_t *bh1 = aml_buffer_init(32);
+    aml_buffer_t *bh2 = aml_buffer_init(32);
+    for (int r = 0; r < ROUNDS; r++) {
+        size_t n1 = 0, n2 = 0;
+        a_sentence_chunk_t *first = a_sentence_chunker_len(&n1, bh1, w->text, w->length);
+        // 4-byte maximum forces rechunk to give up on unsplittable words
+        a_rechunk_sentences(&n2, bh2, w->text, first, n1, 2, r % 2 ? 4 : 120);
+        w->first_chunks += n1;
+        w->final_chunks += n2;
+    }
+    aml_buffer_destroy(bh1);
+    aml_buffer_destroy(bh2);
+
+    a_sentence_chunker_stats_attach(NULL);
+    return NULL;
+}
+
+#define EXPECT(cond)                                              \
+    do {                                                          \
+        if (!(cond)) {                                            \
+            printf("FAIL: %s (line %d)\n", #cond, __LINE__);      \
+            ok = 0;                                               \
+        }                                                         \
+    } while (0)
+
+int main(int argc, char *argv[]) {
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s <text file>\n", argv[0]);
+        return 1;
+    }
+    size_t length = 0;
+    char *content = read_file(argv[1], &length);
+    if (!content) {
+        return 1;
+    }
+
+    worker_t workers[THREADS];
+    pthread_t tids[THREADS];
+    for (int t = 0; t < THREADS; t++) {
+        memset(&workers[t], 0, sizeof(workers[t]));
+        workers[t].text = content;
+        workers[t].length = length;
+        workers[t].stats = a_sentence_chunker_stats_init();
+        pthread_create(&tids[t], NULL, worker, &workers[t]);
+    }
+
+    a_sentence_chunker_stats_snapshot_t total;
+    memset(&total, 0, sizeof(total));
+    size_t first_chunks = 0, final_chunks = 0;
+    for (int t = 0; t < THREADS; t++) {
+        pthread_join(tids[t], NULL);
+        a_sentence_chunker_stats_snapshot_t s;
+        a_sentence_chunker_stats_snapshot(&s, workers[t].stats);
+        a_sentence_chunker_stats_merge(&total, &s);
+        first_chunks += workers[t].first_chunks;
+        final_chunks += workers[t].final_chunks;
+        a_sentence_chunker_stats_destroy(workers[t].stats);
+    }
+
+    int ok = 1;
+    const a_sentence_chunker_histogram_t *in = &total.input_bytes[A_SENTENCE_CHUNKER_PASS_FIRST];
+    EXPECT(total.latency_ns[A_SENTENCE_CHUNKER_PASS_FIRST].count == THREADS * ROUNDS);
+    EXPECT(total.latency_ns[A_SENTENCE_CHUNKER_PASS_RECHUNK].count == THREADS * ROUNDS);
+    EXPECT(in->min == length && in->max == length);
+    EXPECT(a_sentence_chunker_histogram_percentile(in, 50.0) == length);
+    EXPECT(total.output_chunks[A_SENTENCE_CHUNKER_PASS_FIRST].sum == first_chunks);
+    EXPECT(total.output_chunks[A_SENTENCE_CHUNKER_PASS_RECHUNK].sum == final_chunks);
+    EXPECT(total.chunk_length[A_SENTENCE_CHUNKER_PASS_FIRST].count == first_chunks);
+    EXPECT(total.split_gave_up > 0);
+
+    aml_buffer_t *bh = aml_buffer_init(256);
+    a_sentence_chunker_stats_to_json(bh, &total);
+    aml_buffer_appendc(bh, '\0');
+    printf("%s\n", aml_buffer_data(bh));
+    aml_buffer_destroy(bh);
+
+    free(content);
+    printf("%s\n", ok ? "All stats tests passed." : "stats tests FAILED.");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,126 @@
+// SPDX-FileCopyrightText: 2025 Andy Curtis <contactandyc@gmail.com>
+// SPDX-FileCopyrightText: 2024–2025 Knode.ai — technical questions: contact Andy (above)
+// SPDX-License-Identifier: Apache-2.0
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "a-sentence-chunker-library/a_sentence_chunker.h"
+#include "a-sentence-chunker-library/a_sentence_chunker_stream.h"
+#include "corpus_gen.h"
+#include "read_file.h"
+
+/*
+   Stream chunker test: feeding a document in pieces of any size must give
+   exactly the one-shot first pass, the bytes behind each returned chunk
+   must be the document's, and with max_pending the buffer stays bounded.
+*/
+
+static const char *PROFILES[] = { "prose", "abbrev", "numeric", "lists", "nospace",
+                                  "cjk", "crlf", "dotted", "longtail", "mixed" };
+#define NUM_PROFILES (sizeof(PROFILES) / sizeof(PROFILES[0]))
+
+static uint64_t rng = 65;
+static size_t next_piece(size_t max) {
+    rng ^= rng << 13;
+    rng ^= rng >> 7;
+    rng ^= rng << 17;
+    return 1 + (size_t)(rng % max);
+}
+
+/* Feed text in pieces of 1..max_piece bytes; collect all chunks in out. */
+static int stream_all(a_sentence_chunker_stream_t *s, aml_buffer_t *out,
+                      const char *text, size_t len, size_t max_piece, size_t *max_buffered)
+{
+    aml_buffer_t *bh = aml_buffer_init(256);
+    aml_buffer_clear(out);
+    a_sentence_chunker_stream_reset(s);
+    int ok = 1;
+    size_t pos = 0, n = 0;
+    *max_buffered = 0;
+    while (pos <= len) {
+        a_sentence_chunk_t *c;
+        if (pos == len) {
+            c = a_sentence_chunker_stream_finish(&n, bh, s);
+            pos++;
+        } else {
+            size_t piece = next_piece(max_piece);
+            if (piece > len - pos) piece = len - pos;
+            c = a_sentence_chunker_stream_feed(&n, bh, s, text + pos, piece);
+            pos += piece;
+        }
+        for (size_t k = 0; k < n; k++) {
+            const char *bytes = a_sentence_chunker_stream_text(s, c + k);
+            ok &= bytes && !memcmp(bytes, text + c[k].start_offset, c[k].length);
+        }
+        aml_buffer_append(out, c, n * sizeof(*c));
+        size_t buffered = a_sentence_chunker_stream_buffered(s);
+        if (buffered > *max_buffered) *max_buffered = buffered;
+    }
+    aml_buffer_destroy(bh);
+    return ok;
+}
+
+static int check(const char *name, const char *text, size_t len) {
+    aml_buffer_t *ref = aml_buffer_init(1024);
+    aml_buffer_t *got = aml_buffer_init(1024);
+    size_t n = 0;
+    a_sentence_chunker_len(&n, ref, text, len);
+    a_sentence_chunker_stream_t *s = a_sentence_chunker_stream_init(0);
+
+    static const size_t PIECES[] = { 1, 7, 64, 1500, 65536 };
+    int ok = 1;
+    size_t max_buffered = 0;
+    for (size_t p = 0; ok && p < sizeof(PIECES) / sizeof(PIECES[0]); p++) {
+        ok = stream_all(s, got, text, len, PIECES[p], &max_buffered) &&
+             aml_buffer_length(got) == aml_buffer_length(ref) &&
+             !memcmp(aml_buffer_data(got), aml_buffer_data(ref), aml_buffer_length(ref));
+    }
+    a_sentence_chunker_stream_destroy(s);
+
+    // Bounded: chunks cover the document in order and the buffer stays small
+    s = a_sentence_chunker_stream_init(4096);
+    ok &= stream_all(s, got, text, len, 1500, &max_buffered);
+    a_sentence_chunk_t *c = (a_sentence_chunk_t *)aml_buffer_data(got);
+    size_t nc = aml_buffer_length(got) / sizeof(*c);
+    for (size_t k = 1; ok && k < nc; k++) {
+        ok = c[k].start_offset >= c[k - 1].start_offset + c[k - 1].length;
+    }
+    ok &= max_buffered <= 4096 + 1500 + A_SENTENCE_CHUNKER_STREAM_LOOKBEHIND;
+    a_sentence_chunker_stream_destroy(s);
+
+    printf("%s: %s (%zu sentences, max %zu bytes buffered at 4096)\n",
+           ok ? "PASS" : "FAIL", name, n, max_buffered);
+    aml_buffer_destroy(ref);
+    aml_buffer_destroy(got);
+    return ok;
+}
+
+int main(int argc, char *argv[]) {
+    int ok = 1;
+    static const char *EDGES[] = {
+        "", "   ", "Hi.", "Hi. ", "Hi!abc. Next", "1. ", "1. next. Done", "e.g. this",
+        "He said \"stop.\" Then left.   \n\n", "3.14 is pi. ...", "Wait?!) ok"
+    };
+    for (size_t e = 0; e < sizeof(EDGES) / sizeof(EDGES[0]); e++) {
+        char name[32];
+        snprintf(name, sizeof(name), "edge %zu", e);
+        ok &= check(name, EDGES[e], strlen(EDGES[e]));
+    }
+    for (size_t p = 0; p < NUM_PROFILES; p++) {
+        corpus_profile_t profile;
+        corpus_profile_preset(&profile, PROFILES[p], 65 + p);
+        size_t len = 1u << 20;
+        char *text = corpus_generate(&profile, len);
+        ok &= check(PROFILES[p], text, len);
+        free(text);
+    }
+    for (int a = 1; a < argc; a++) {
+        size_t len = 0;
+        char *text = read_file(argv[a], &len);
+        if (!text) return 1;
+        ok &= check(argv[a], text, len);
+        free(text);
+    }
+    return ok ? 0 : 1;
+}
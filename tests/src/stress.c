@@ -0,0 +1,69 @@
+// SPDX-FileCopyrightText: 2025 Andy Curtis <contactandyc@gmail.com>
+// SPDX-FileCopyrightText: 2024–2025 Knode.ai — technical questions: contact Andy (above)
+// SPDX-License-Identifier: Apache-2.0
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "a-sentence-chunker-library/a_sentence_chunker.h"
+#include "corpus_gen.h"
+
+/*
+   Stress test: every generator profile must be deterministic and every
+   chunk the library produces on it must be a well-formed, ordered,
+   in-bounds span.
+*/
+
+#define CORPUS_BYTES (2u * 1024u * 1024u)
+
+static int check_spans(const char *what, const a_sentence_chunk_t *c, size_t n, size_t len) {
+    size_t prev_end = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (c[i].length == 0 || c[i].start_offset < prev_end ||
+            c[i].start_offset + c[i].length > len)
+        {
+            printf("  %s: bad span %zu [%zu, +%zu) after %zu\n",
+                   what, i, c[i].start_offset, c[i].length, prev_end);
+            return 0;
+        }
+        prev_end = c[i].start_offset + c[i].length;
+    }
+    return 1;
+}
+
+int main(void) {
+    static const size_t limits[][2] = { { 5, 250 }, { 40, 120 }, { 1, 16 } };
+    int ok = 1;
+    aml_buffer_t *bh1 = aml_buffer_init(1024);
+    aml_buffer_t *bh2 = aml_buffer_init(1024);
+
+    for (int p = 0; corpus_profile_names[p]; p++) {
+        corpus_profile_t profile;
+        corpus_profile_preset(&profile, corpus_profile_names[p], 1000 + (uint64_t)p);
+        char *text = corpus_generate(&profile, CORPUS_BYTES);
+        char *again = corpus_generate(&profile, CORPUS_BYTES);
+        int pass = memcmp(text, again, CORPUS_BYTES) == 0;
+        if (!pass) {
+            printf("  %s: generator is not deterministic\n", corpus_profile_names[p]);
+        }
+        free(again);
+
+        size_t n1 = 0;
+        a_sentence_chunk_t *first = a_sentence_chunker_len(&n1, bh1, text, CORPUS_BYTES);
+        pass &= check_spans("first pass", first, n1, CORPUS_BYTES);
+        size_t n2 = 0;
+        for (size_t l = 0; l < sizeof(limits) / sizeof(limits[0]); l++) {
+            a_sentence_chunk_t *final = a_rechunk_sentences(
+                &n2, bh2, text, first, n1, limits[l][0], limits[l][1]);
+            pass &= check_spans("rechunk", final, n2, CORPUS_BYTES);
+        }
+        printf("%s: %-9s %zu sentences, %zu chunks\n",
+               pass ? "PASS" : "FAIL", corpus_profile_names[p], n1, n2);
+        ok &= pass;
+        free(text);
+    }
+
+    aml_buffer_destroy(bh1);
+    aml_buffer_destroy(bh2);
+    return ok ? 0 : 1;
+}
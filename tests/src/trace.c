@@ -0,0 +1,158 @@
+// SPDX-FileCopyrightText: 2025 Andy Curtis <contactandyc@gmail.com>
+// SPDX-FileCopyrightText: 2024–2025 Knode.ai — technical questions: contact Andy (above)
+// SPDX-License-Identifier: Apache-2.0
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "a-sentence-chunker-library/a_sentence_chunker.h"
+#include "a-sentence-chunker-library/a_sentence_chunker_trace.h"
+#include "read_file.h"
+
+/*
+   Decision trace test: the accepted PUNCT_RUN records must reproduce the
+   first-pass boundaries, SPLIT records must describe real splits, and a
+   small ring must keep only the newest records. Prints the explain text
+   for a short sample.
+*/
+
+static const char *SAMPLE =
+    "Dr. Smith paid $3.14 for it. Then:\n1. first item\n2. second item\n"
+    "He said \"Really?!\" and left (quickly). See e.g. the U.S. report.";
+
+/* Returns 1 when the trace of one first pass matches its output. */
+static int check_first_pass(const char *text, size_t len) {
+    a_sentence_chunker_trace_t *trace = a_sentence_chunker_trace_init(1 << 16);
+    a_sentence_chunker_trace_attach(trace);
+    aml_buffer_t *bh = aml_buffer_init(256);
+    size_t n = 0;
+    a_sentence_chunk_t *chunks = a_sentence_chunker_len(&n, bh, text, len);
+    a_sentence_chunker_trace_attach(NULL);
+
+    size_t written = (size_t)a_sentence_chunker_trace_written(trace);
+    a_sentence_chunker_trace_record_t *r =
+        (a_sentence_chunker_trace_record_t *)malloc(written * sizeof(*r));
+    size_t got = a_sentence_chunker_trace_read(trace, r, written);
+
+    int ok = got == written && got > 0 && r[0].event == A_SENTENCE_CHUNKER_TRACE_DOCUMENT &&
+             r[0].length == len;
+    // Every accepted run ends exactly one chunk (the leftover tail has no run)
+    size_t c = 0;
+    for (size_t k = 1; ok && k < got; k++) {
+        if (r[k].event != A_SENTENCE_CHUNKER_TRACE_PUNCT_RUN) {
+            ok = 0;
+        } else if (r[k].rule == A_SENTENCE_CHUNKER_RULE_BOUNDARY) {
+            ok = c < n && chunks[c].start_offset + chunks[c].length == r[k].result;
+            c++;
+        }
+    }
+    ok &= c == n || (c + 1 == n && chunks[c].start_offset + chunks[c].length == len);
+    printf("%s: first pass, %zu records, %zu chunks\n", ok ? "PASS" : "FAIL", got, n);
+
+    free(r);
+    aml_buffer_destroy(bh);
+    a_sentence_chunker_trace_destroy(trace);
+    return ok;
+}
+
+static int check_splits(const char *text, size_t len) {
+    aml_buffer_t *bh1 = aml_buffer_init(256);
+    aml_buffer_t *bh2 = aml_buffer_init(256);
+    size_t n1 = 0, n2 = 0;
+    a_sentence_chunk_t *first = a_sentence_chunker_len(&n1, bh1, text, len);
+
+    a_sentence_chunker_trace_t *trace = a_sentence_chunker_trace_init(1 << 16);
+    a_sentence_chunker_trace_attach(trace);
+    a_rechunk_sentences(&n2, bh2, text, first, n1, 5, 40);
+    a_sentence_chunker_trace_attach(NULL);
+
+    a_sentence_chunker_trace_record_t r[1 << 12];
+    size_t got = a_sentence_chunker_trace_read(trace, r, sizeof(r) / sizeof(r[0]));
+    int ok = got > 0 && r[0].event == A_SENTENCE_CHUNKER_TRACE_DOCUMENT;
+    size_t splits = 0;
+    for (size_t k = 1; ok && k < got; k++) {
+        ok = r[k].event == A_SENTENCE_CHUNKER_TRACE_SPLIT && r[k].result <= r[k].length &&
+             r[k].pos + r[k].length <= len;
+        if (r[k].rule != A_SPLIT_NONE) {
+            ok &= r[k].result < r[k].length;
+            splits++;
+        }
+    }
+    printf("%s: rechunk, %zu split searches, %zu splits\n", ok ? "PASS" : "FAIL", got - 1, splits);
+
+    aml_buffer_t *out = aml_buffer_init(1024);
+    a_sentence_chunker_trace_to_text(out, text, len, r, got < 8 ? got : 8);
+    printf("%s", aml_buffer_data(out));
+    aml_buffer_destroy(out);
+
+    a_sentence_chunker_trace_destroy(trace);
+    aml_buffer_destroy(bh1);
+    aml_buffer_destroy(bh2);
+    return ok;
+}
+
+/* A 64-record ring keeps only the newest records, oldest first. */
+static int check_ring(const char *text, size_t len) {
+    a_sentence_chunker_trace_t *trace = a_sentence_chunker_trace_init(1);
+    a_sentence_chunker_trace_attach(trace);
+    aml_buffer_t *bh = aml_buffer_init(256);
+    size_t n = 0;
+    for (int k = 0; k < 20; k++) {
+        a_sentence_chunker_len(&n, bh, text, len);
+    }
+    a_sentence_chunker_trace_attach(NULL);
+
+    a_sentence_chunker_trace_record_t r[256];
+    size_t got = a_sentence_chunker_trace_read(trace, r, 256);
+    uint64_t written = a_sentence_chunker_trace_written(trace);
+    int ok = got == 64 && written > 64;
+    // Consecutive records of one document move forward through the text
+    for (size_t k = 1; ok && k < got; k++) {
+        if (r[k].event == A_SENTENCE_CHUNKER_TRACE_PUNCT_RUN &&
+            r[k - 1].event == A_SENTENCE_CHUNKER_TRACE_PUNCT_RUN)
+        {
+            ok = r[k].pos > r[k - 1].pos;
+        }
+    }
+    a_sentence_chunker_trace_reset(trace);
+    ok &= a_sentence_chunker_trace_written(trace) == 0 &&
+          a_sentence_chunker_trace_read(trace, r, 256) == 0;
+    printf("%s: ring, %llu written, %zu retained\n", ok ? "PASS" : "FAIL",
+           (unsigned long long)written, got);
+
+    aml_buffer_destroy(bh);
+    a_sentence_chunker_trace_destroy(trace);
+    return ok;
+}
+
+int main(int argc, char *argv[]) {
+    int ok = 1;
+    size_t sample_len = strlen(SAMPLE);
+
+    aml_buffer_t *out = aml_buffer_init(1024);
+    a_sentence_chunker_trace_t *trace = a_sentence_chunker_trace_init(256);
+    a_sentence_chunker_trace_attach(trace);
+    size_t n = 0;
+    aml_buffer_t *bh = aml_buffer_init(256);
+    a_sentence_chunker_len(&n, bh, SAMPLE, sample_len);
+    a_sentence_chunker_trace_attach(NULL);
+    a_sentence_chunker_trace_record_t r[256];
+    size_t got = a_sentence_chunker_trace_read(trace, r, 256);
+    a_sentence_chunker_trace_to_text(out, SAMPLE, sample_len, r, got);
+    printf("%s", aml_buffer_data(out));
+    aml_buffer_destroy(bh);
+    aml_buffer_destroy(out);
+    a_sentence_chunker_trace_destroy(trace);
+
+    ok &= check_first_pass(SAMPLE, sample_len);
+    ok &= check_ring(SAMPLE, sample_len);
+    for (int a = 1; a < argc; a++) {
+        size_t len = 0;
+        char *text = read_file(argv[a], &len);
+        if (!text) return 1;
+        ok &= check_first_pass(text, len);
+        ok &= check_splits(text, len);
+        free(text);
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,282 @@
+// SPDX-FileCopyrightText: 2025 Andy Curtis <contactandyc@gmail.com>
+// SPDX-FileCopyrightText: 2024–2025 Knode.ai — technical questions: contact Andy (above)
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE // memmem
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "a-sentence-chunker-library/a_sentence_chunker.h"
+#include "chunk_check.h"
+
+/*
+   Transcript test: the SRT, VTT and TRANSCRIPT formats chunk cue text in
+   place and a_sentence_chunker_timed() attaches times and speakers.
+   Checks a sample file per format chunk by chunk (sentences across cues,
+   turns by dash, label and voice span, skipped headers, notes and
+   markup), that rechunking never merges across a turn and splits between
+   cues leave the timing lines out, and that chunks over random cues are
+   ordered, non-empty and inside the text.
+*/
+
+typedef struct {
+    const char *text;
+    int64_t start_ms, end_ms;
+    const char *speaker; // NULL: none
+} expected_t;
+
+static bool expect(a_sentence_chunker_format_t format, const char *text, size_t min_length,
+                   size_t max_length, const expected_t *expected)
+{
+    a_sentence_chunker_options_t opts = chunk_check_options(format);
+    aml_buffer_t *first = aml_buffer_init(256);
+    aml_buffer_t *second = aml_buffer_init(256);
+    aml_buffer_t *timed = aml_buffer_init(256);
+    size_t len = strlen(text), num = 0, num_timed = 0;
+    a_sentence_chunk_t *c = a_sentence_chunker_opts(&num, first, text, len, &opts);
+    if (max_length) {
+        c = a_rechunk_sentences_opts(&num, second, text, c, num, min_length, max_length, &opts);
+    }
+    a_sentence_chunk_timed_t *t =
+        a_sentence_chunker_timed(&num_timed, timed, text, len, c, num, &opts);
+    bool ok = num_timed == num;
+    size_t k = 0;
+    for (; expected[k].text && ok; k++) {
+        const expected_t *e = &expected[k];
+        size_t sn = e->speaker ? strlen(e->speaker) : 0;
+        ok = k < num && t[k].start_offset == c[k].start_offset && t[k].length == c[k].length &&
+             t[k].length == strlen(e->text) &&
+             memcmp(text + t[k].start_offset, e->text, t[k].length) == 0 &&
+             t[k].start_ms == e->start_ms && t[k].end_ms == e->end_ms &&
+             t[k].speaker_length == sn && (t[k].speaker < 0) == !e->speaker &&
+             memcmp(text + t[k].speaker_offset, e->speaker ? e->speaker : "", sn) == 0;
+    }
+    ok &= k == num;
+    if (!ok) {
+        printf("  format %d gave\n", (int)format);
+        for (size_t j = 0; j < num_timed; j++) {
+            printf("    [%.*s] %lld-%lld speaker %d [%.*s]\n", (int)t[j].length,
+                   text + t[j].start_offset, (long long)t[j].start_ms, (long long)t[j].end_ms,
+                   t[j].speaker, (int)t[j].speaker_length, text + t[j].speaker_offset);
+        }
+    }
+    aml_buffer_destroy(first);
+    aml_buffer_destroy(second);
+    aml_buffer_destroy(timed);
+    return ok;
+}
+
+static const char SRT_FILE[] =
+    "1\n"
+    "00:00:01,000 --> 00:00:03,500\n"
+    "Hello there. This is\n"
+    "\n"
+    "2\n"
+    "00:00:03,600 --> 00:00:05,000\n"
+    "{\\an8}<i>one sentence</i> across cues.\n"
+    "\n"
+    "3\r\n"
+    "00:00:06,000 --> 00:00:08,000\r\n"
+    "- Where?\r\n"
+    "- Here, Mr. Smith.\r\n"
+    "\r\n"
+    "4\n"
+    "00:00:09,000 --> 00:00:10,000\n"
+    "JOHN: Note: it is\n"
+    "5\n"
+    "00:00:10,500 --> 00:00:12,000\n"
+    "JOHN: still me.\n"
+    "MARY: Okay.\n";
+
+static const char VTT_FILE[] =
+    "WEBVTT - Sample. Header\n"
+    "\n"
+    "NOTE Not a cue. Skipped\n"
+    "\n"
+    "STYLE\n"
+    "::cue { color: red }\n"
+    "\n"
+    "intro\n"
+    "00:01.000 --> 00:04.000 align:start position:10%\n"
+    "<v Roger Bingham>We are in New York City\n"
+    "\n"
+    "00:04.500 --> 00:06.000\n"
+    "<v Roger Bingham>and it's cold. Right?\n"
+    "\n"
+    "1:00:06.000 --> 1:00:07.250\n"
+    "<v.loud Neil>Yes. <1:00:06.500>Very &amp; cold.\n";
+
+static const char TRANSCRIPT_FILE[] =
+    "[00:00:01] Alice: Good morning. Thanks for\n"
+    "coming in today.\n"
+    "[00:00:07] Bob: Glad to be here. So,\n"
+    "\n"
+    "the plan is simple.\n"
+    "(1:02) Alice: Note: this matters. At 10:30 we start.\n"
+    "Bob: Sure.\n";
+
+// Long cues of one sentence, for splits
+static size_t long_cues(char *out, size_t cues) {
+    size_t n = 0;
+    for (size_t k = 0; k < cues; k++) {
+        n += (size_t)sprintf(out + n, "%zu\n00:00:%02zu,000 --> 00:00:%02zu,500\n", k + 1, k, k);
+        n += (size_t)sprintf(out + n, "words that go on %s\n\n",
+                             k % 2 ? "and on across the cue" : "with <i>markup</i> in them");
+    }
+    out[n - 2] = '.';
+    return n - 1;
+}
+
+// True when the line holding text[i] is a cue's text, not an index or timing line
+static bool on_cue_text(const char *text, size_t i) {
+    size_t line = i;
+    while (line > 0 && text[line - 1] != '\n') line--;
+    const char *nl = strchr(text + line, '\n');
+    size_t eol = nl ? (size_t)(nl - text) : strlen(text);
+    if (memmem(text + line, eol - line, "-->", 3)) return false;
+    return strspn(text + line, "0123456789") < eol - line;
+}
+
+// True when text[i] falls inside a tag of its line
+static bool in_tag(const char *text, size_t i) {
+    for (size_t k = i; k > 0 && text[k - 1] != '\n'; k--) {
+        if (text[k - 1] == '>') return false;
+        if (text[k - 1] == '<') return true;
+    }
+    return false;
+}
+
+int main(void) {
+    bool ok = true;
+    ok &= expect(A_SENTENCE_CHUNKER_FORMAT_SRT, SRT_FILE, 0, 0, (const expected_t[]){
+        { "Hello there.", 1000, 3500, NULL },
+        { "This is\n\n2\n00:00:03,600 --> 00:00:05,000\n{\\an8}<i>one sentence</i> across cues.",
+          1000, 5000, NULL },
+        { "Where?", 6000, 8000, NULL },
+        { "Here, Mr. Smith.", 6000, 8000, NULL },
+        { "Note: it is\n5\n00:00:10,500 --> 00:00:12,000\nJOHN: still me.", 9000, 12000,
+          "JOHN" },
+        { "Okay.", 10500, 12000, "MARY" },
+        { NULL, 0, 0, NULL } });
+    ok &= expect(A_SENTENCE_CHUNKER_FORMAT_VTT, VTT_FILE, 0, 0, (const expected_t[]){
+        { "We are in New York City\n\n00:04.500 --> 00:06.000\n<v Roger Bingham>and it's cold.",
+          1000, 6000, "Roger Bingham" },
+        { "Right?", 4500, 6000, "Roger Bingham" },
+        { "Yes.", 3606000, 3607250, "Neil" },
+        { "Very &amp; cold.", 3606000, 3607250, "Neil" },
+        { NULL, 0, 0, NULL } });
+    ok &= expect(A_SENTENCE_CHUNKER_FORMAT_TRANSCRIPT, TRANSCRIPT_FILE, 0, 0, (const expected_t[]){
+        { "Good morning.", 1000, 7000, "Alice" },
+        { "Thanks for\ncoming in today.", 1000, 7000, "Alice" },
+        { "Glad to be here.", 7000, 62000, "Bob" },
+        { "So,", 7000, 62000, "Bob" },
+        { "the plan is simple.", 7000, 62000, "Bob" },
+        { "Note: this matters.", 62000, -1, "Alice" },
+        { "At 10:30 we start.", 62000, -1, "Alice" },
+        { "Sure.", 62000, -1, "Bob" },
+        { NULL, 0, 0, NULL } });
+    // Other formats have no times or speakers
+    ok &= expect(A_SENTENCE_CHUNKER_FORMAT_TEXT, "One. Two.", 0, 0, (const expected_t[]){
+        { "One.", -1, -1, NULL }, { "Two.", -1, -1, NULL }, { NULL, 0, 0, NULL } });
+    printf("%s: files\n", ok ? "PASS" : "FAIL");
+
+    // Short chunks merge inside a turn only
+    bool pass = expect(A_SENTENCE_CHUNKER_FORMAT_SRT, SRT_FILE, 20, 200, (const expected_t[]){
+        { "Hello there. This is\n\n2\n00:00:03,600 --> 00:00:05,000\n"
+          "{\\an8}<i>one sentence</i> across cues.", 1000, 5000, NULL },
+        { "Where?", 6000, 8000, NULL },
+        { "Here, Mr. Smith.", 6000, 8000, NULL },
+        { "Note: it is\n5\n00:00:10,500 --> 00:00:12,000\nJOHN: still me.", 9000, 12000,
+          "JOHN" },
+        { "Okay.", 10500, 12000, "MARY" },
+        { NULL, 0, 0, NULL } });
+    pass &= expect(A_SENTENCE_CHUNKER_FORMAT_TRANSCRIPT, TRANSCRIPT_FILE, 30, 200,
+                   (const expected_t[]){
+        { "Good morning. Thanks for\ncoming in today.", 1000, 7000, "Alice" },
+        { "Glad to be here. So,", 7000, 62000, "Bob" },
+        { "the plan is simple.", 7000, 62000, "Bob" },
+        { "Note: this matters. At 10:30 we start.", 62000, -1, "Alice" },
+        { "Sure.", 62000, -1, "Bob" },
+        { NULL, 0, 0, NULL } });
+    // A long sentence across cues splits on cue text, never in a tag
+    a_sentence_chunker_options_t opts = chunk_check_options(A_SENTENCE_CHUNKER_FORMAT_SRT);
+    aml_buffer_t *first = aml_buffer_init(1024);
+    aml_buffer_t *second = aml_buffer_init(1024);
+    aml_buffer_t *timed = aml_buffer_init(1024);
+    char *text = malloc(1u << 14);
+    size_t len = long_cues(text, 40), num = 0, num2 = 0, num_timed = 0;
+    for (size_t max = 20; max < 200 && pass; max += 3) {
+        a_sentence_chunk_t *c = a_sentence_chunker_opts(&num, first, text, len, &opts);
+        a_sentence_chunk_t *r = a_rechunk_sentences_opts(&num2, second, text, c, num, 10, max,
+                                                         &opts);
+        a_sentence_chunk_timed_t *t =
+            a_sentence_chunker_timed(&num_timed, timed, text, len, r, num2, &opts);
+        pass = num == 1 && num2 > 1 && num_timed == num2 && chunk_check_ordered(len, r, num2);
+        for (size_t k = 0; k < num2 && pass; k++) {
+            size_t s = r[k].start_offset, e = s + r[k].length;
+            // A split between words may leave the tail's space, as in plain text
+            pass = on_cue_text(text, s) && on_cue_text(text, e - 1) && text[s] != '\n' &&
+                   text[e - 1] != ' ' && text[e - 1] != '\n' &&
+                   !in_tag(text, s) && !in_tag(text, e) && t[k].start_ms <= t[k].end_ms &&
+                   (k == 0 || t[k].start_ms >= t[k - 1].start_ms);
+        }
+        if (!pass) printf("  long cues, max %zu\n", max);
+    }
+    free(text);
+    printf("%s: rechunk\n", pass ? "PASS" : "FAIL");
+    ok &= pass;
+
+    // Random cues over the bytes that matter
+    static const char *PIECES[] = {
+        "\n", "\n\n", "\r\n", "1\n", "00:00:01,000 --> 00:00:02,000\n", "01.500 --> 02.000 x\n",
+        "WEBVTT\n", "NOTE ", "- ", "JOHN: ", "Alice: ", "[00:01] ", "(1:02:03) ", "<v Bob>",
+        "<v.a>", "<i>", "</i>", "{\\an8}", "<", ">", "word", "end. ", "Next", "Mr. ", ":", " "
+    };
+    static const a_sentence_chunker_format_t FORMATS[] = {
+        A_SENTENCE_CHUNKER_FORMAT_SRT, A_SENTENCE_CHUNKER_FORMAT_VTT,
+        A_SENTENCE_CHUNKER_FORMAT_TRANSCRIPT
+    };
+    uint64_t x = 0x9E3779B97F4A7C15ull;
+    char buf[512];
+    pass = true;
+    for (int it = 0; it < 200000 && pass; it++) {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        size_t n = 0, pieces = x % 30;
+        opts.format = FORMATS[(x >> 32) % 3];
+        for (size_t p = 0; p < pieces; p++) {
+            x ^= x << 13;
+            x ^= x >> 7;
+            x ^= x << 17;
+            const char *piece = PIECES[(x >> 20) % (sizeof(PIECES) / sizeof(PIECES[0]))];
+            size_t pn = strlen(piece);
+            memcpy(buf + n, piece, pn);
+            n += pn;
+        }
+        a_sentence_chunk_t *c = a_sentence_chunker_opts(&num, first, buf, n, &opts);
+        pass = chunk_check_ordered(n, c, num);
+        a_sentence_chunk_t *r = a_rechunk_sentences_opts(&num2, second, buf, c, num, 5, 20, &opts);
+        pass = pass && chunk_check_ordered(n, r, num2);
+        a_sentence_chunk_timed_t *t = a_sentence_chunker_timed(&num_timed, timed, buf, n, r,
+                                                               num2, &opts);
+        pass = pass && num_timed == num2;
+        for (size_t k = 0; k < num_timed && pass; k++) {
+            pass = t[k].speaker_offset + t[k].speaker_length <= n &&
+                   (t[k].speaker < 0) == (t[k].speaker_length == 0);
+        }
+        if (!pass) printf("  random cues %d: %.*s\n", it, (int)n, buf);
+    }
+    printf("%s: well-formed chunks\n", pass ? "PASS" : "FAIL");
+    ok &= pass;
+
+    aml_buffer_destroy(first);
+    aml_buffer_destroy(second);
+    aml_buffer_destroy(timed);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,48 @@
+// SPDX-FileCopyrightText: 2025 Andy Curtis <contactandyc@gmail.com>
+// SPDX-FileCopyrightText: 2024–2025 Knode.ai — technical questions: contact Andy (above)
+// SPDX-License-Identifier: Apache-2.0
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "a-sentence-chunker-library/a_sentence_chunker_lang.h"
+#include "read_file.h"
+
+/*
+   Compiles a language pack source (lang/<name>.txt) into the binary table
+   a_sentence_chunker_lang_load() maps:
+
+     a_sentence_chunker_lang_compile <source.txt> <output.pack>
+*/
+
+int main(int argc, char *argv[]) {
+    if (argc != 3) {
+        fprintf(stderr, "Usage: %s <source.txt> <output.pack>\n", argv[0]);
+        return 1;
+    }
+    size_t len = 0;
+    char *source = read_file(argv[1], &len);
+    if (!source) {
+        return 1;
+    }
+    aml_buffer_t *bh = aml_buffer_init(4096);
+    size_t error_line = 0;
+    int rc = 1;
+    if (!a_sentence_chunker_lang_compile(bh, source, len, &error_line)) {
+        fprintf(stderr, "%s:%zu: invalid directive\n", argv[1], error_line);
+    } else {
+        FILE *out = fopen(argv[2], "wb");
+        if (!out) {
+            perror("fopen");
+        } else {
+            if (fwrite(aml_buffer_data(bh), 1, aml_buffer_length(bh), out) == aml_buffer_length(bh)) {
+                rc = 0;
+            }
+            if (fclose(out) != 0) {
+                rc = 1;
+            }
+        }
+    }
+    aml_buffer_destroy(bh);
+    free(source);
+    return rc;
+}
@@ -0,0 +1,917 @@
+// SPDX-FileCopyrightText: 2025 Andy Curtis <contactandyc@gmail.com>
+// SPDX-FileCopyrightText: 2024–2025 Knode.ai — technical questions: contact Andy (above)
+// SPDX-License-Identifier: Apache-2.0
+
+#include <dirent.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "a-sentence-chunker-library/a_sentence_chunker_lang.h"
+#include "read_file.h"
+
+/*
+   Unsupervised abbreviation learner in the style of Punkt (Kiss & Strunk,
+   2006). Streams a corpus twice on N worker threads and writes a language
+   pack (see a_sentence_chunker_lang.h):
+
+     pass 1  type statistics: how often each word type ends in a period,
+             and how it is cased mid-sentence vs. after a sure boundary
+     pass 2  collocations: what follows each abbreviation candidate (may it
+             end a sentence?) and each "<digits>." token (ordinal rules)
+
+     a_sentence_chunker_learn [--threads N] [--base lang/en.txt] [--name NAME]
+                              [--min-count N] [--threshold X] [--max-types N]
+                              [--source OUT.txt] -o OUT.pack <file|dir>...
+
+   Files are read in fixed-size blocks cut at whitespace, so memory does not
+   grow with the corpus; --max-types bounds each thread's type table (rare
+   types are pruned when it fills). --base copies a hand-written pack source
+   (terminators, closers, abbrev_exact, ...) ahead of the learned
+   directives, and its abbreviations are not repeated. --source also writes
+   the generated pack source, one scored abbreviation per line, for review.
+*/
+
+#define MAX_PATH_LEN 1024
+#define BLOCK_BYTES (8u << 20)
+#define MAX_WORD 31                 // longest abbreviation a pack holds
+#define DEFAULT_THRESHOLD 0.3       // Punkt's abbreviation score cutoff
+#define DEFAULT_MIN_COUNT 3
+#define DEFAULT_MAX_TYPES (1u << 20)
+#define MAY_END_RATIO 0.25          // share of followers that start sentences
+#define ORDINAL_BUCKETS 5           // 1, 2, 3 and 4+ digits (index 0 unused)
+
+// ----------------------------------------------------------------------------
+//                               TOKENS
+// ----------------------------------------------------------------------------
+
+enum {
+    TOK_PERIOD = 1,      // the word takes a period ("etc.", "etc..")
+    TOK_STRONG = 2,      // a sure sentence end: '?', '!', "..", "..."
+    TOK_CLAUSE = 4,      // ',' ';' or ':' after the word
+    TOK_UPPER = 8,       // first letter uppercase
+    TOK_LOWER = 16,      // first letter lowercase
+    TOK_DIGIT = 32,      // first character a digit
+    TOK_NUMBER = 64,     // only digits before the period
+    TOK_LINE = 128,      // first word on its line
+    TOK_PARAGRAPH = 256, // a blank line precedes it
+    TOK_LONG = 512,      // longer than MAX_WORD: counted, not stored
+    TOK_ELLIPSIS = 1024  // "word...": whether it takes a period is unknown
+};
+
+typedef struct {
+    char type[MAX_WORD + 1]; // ASCII-lowercased, final period stripped
+    unsigned len;
+    unsigned flags;
+    unsigned periods;        // internal periods ("e.g" -> 1)
+    bool alpha;
+} token_t;
+
+static inline bool is_space(uint8_t c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+}
+
+// ASCII quotes, brackets and emphasis that wrap a word
+static inline bool is_wrap(uint8_t c) {
+    return c && strchr("\"'()[]{}<>*_", c) != NULL;
+}
+
+// Length of a UTF-8 quote or inverted mark at s: « » ¿ ¡ ‘ ’ ‚ ‛ “ ” „ ‟ ‹ ›
+static inline size_t utf8_wrap(const uint8_t *s, size_t n) {
+    if (n >= 2 && s[0] == 0xC2 &&
+        (s[1] == 0xAB || s[1] == 0xBB || s[1] == 0xBF || s[1] == 0xA1))
+        return 2;
+    if (n >= 3 && s[0] == 0xE2 && s[1] == 0x80 &&
+        ((s[2] >= 0x98 && s[2] <= 0x9F) || s[2] == 0xB9 || s[2] == 0xBA))
+        return 3;
+    return 0;
+}
+
+// Case of the first letter, including Latin-1 letters (U+00C0..U+00FE)
+static unsigned first_case(const uint8_t *s, size_t n) {
+    if (s[0] >= 'A' && s[0] <= 'Z') return TOK_UPPER;
+    if (s[0] >= 'a' && s[0] <= 'z') return TOK_LOWER;
+    if (s[0] >= '0' && s[0] <= '9') return TOK_DIGIT;
+    if (n >= 2 && s[0] == 0xC3) {
+        if (s[1] >= 0x80 && s[1] <= 0x9E && s[1] != 0x97) return TOK_UPPER;
+        if (s[1] >= 0x9F && s[1] <= 0xBF && s[1] != 0xB7) return TOK_LOWER;
+    }
+    return 0;
+}
+
+/* Next whitespace-separated word of p[*pos..len) with its wrapping
+   punctuation removed. Returns false at the end of the block. */
+static bool next_token(const char *text, size_t len, size_t *pos, token_t *t) {
+    const uint8_t *p = (const uint8_t *)text;
+    size_t i = *pos;
+    unsigned newlines = 0;
+    while (i < len && is_space(p[i])) {
+        newlines += p[i] == '\n';
+        i++;
+    }
+    if (i >= len) {
+        *pos = i;
+        return false;
+    }
+    size_t s = i;
+    while (i < len && !is_space(p[i])) i++;
+    size_t e = i;
+    *pos = i;
+
+    t->flags = newlines >= 2 ? (TOK_PARAGRAPH | TOK_LINE) : newlines ? TOK_LINE : 0;
+    size_t q;
+    while (s < e) {
+        if (is_wrap(p[s])) s++;
+        else if ((q = utf8_wrap(p + s, e - s)) != 0) s += q;
+        else break;
+    }
+    while (s < e) {
+        uint8_t c = p[e - 1];
+        if (c == ',' || c == ';' || c == ':') {
+            t->flags |= TOK_CLAUSE;
+            e--;
+        } else if (is_wrap(c)) {
+            e--;
+        } else if (e - s >= 2 && utf8_wrap(p + e - 2, 2) == 2) {
+            e -= 2;
+        } else if (e - s >= 3 && utf8_wrap(p + e - 3, 3) == 3) {
+            e -= 3;
+        } else {
+            break;
+        }
+    }
+    /* "etc." is ambiguous; "etc.." and "etc.?" end a sentence with the
+       abbreviation's own period kept; three or more dots are an ellipsis. */
+    while (s < e && (p[e - 1] == '?' || p[e - 1] == '!')) {
+        t->flags |= TOK_STRONG;
+        e--;
+    }
+    size_t dots = 0;
+    while (s < e && p[e - 1] == '.') {
+        e--;
+        dots++;
+    }
+    if (dots >= 3) {
+        t->flags |= TOK_STRONG | TOK_ELLIPSIS;
+    } else if (dots) {
+        t->flags |= dots == 2 ? (TOK_PERIOD | TOK_STRONG) : TOK_PERIOD;
+    }
+
+    t->len = (unsigned)(e - s);
+    t->periods = 0;
+    t->alpha = false;
+    if (t->len == 0) {
+        return true;
+    }
+    t->flags |= first_case(p + s, e - s);
+    if (t->len > MAX_WORD) {
+        t->flags |= TOK_LONG;
+        return true;
+    }
+    bool digits = true;
+    for (size_t k = 0; k < t->len; k++) {
+        uint8_t c = p[s + k];
+        t->type[k] = (char)((c >= 'A' && c <= 'Z') ? c + 32 : c);
+        t->periods += c == '.';
+        digits = digits && c >= '0' && c <= '9';
+        t->alpha = t->alpha || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c >= 0x80;
+    }
+    t->type[t->len] = '\0';
+    if (digits) t->flags |= TOK_NUMBER;
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+//                             TYPE TABLE
+// ----------------------------------------------------------------------------
+
+typedef struct {
+    uint64_t with_period;    // "etc."
+    uint64_t without_period; // "etc"
+    uint64_t lower_mid;      // lowercase after a word that ends no sentence
+    uint64_t upper_mid;      // capitalized there (names, German nouns)
+    uint64_t upper_first;    // capitalized after '?', '!' or a blank line
+    uint32_t hash;
+    uint32_t key;            // offset into the table's arena
+    uint32_t cand;           // candidate index + 1, set after pass 1
+    uint8_t len;             // 0 = empty slot
+    uint8_t periods;
+} type_stats_t;
+
+typedef struct {
+    type_stats_t *slots;
+    size_t mask;
+    size_t used;
+    aml_buffer_t *arena;
+    uint64_t floor;          // types seen this often or less were pruned
+} type_table_t;
+
+// FNV-1a, like the pack's own hash
+static inline uint32_t type_hash(const char *w, size_t n) {
+    uint32_t h = 2166136261u;
+    for (size_t k = 0; k < n; k++) {
+        h ^= (uint8_t)w[k];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static void table_init(type_table_t *t, size_t slots) {
+    t->slots = calloc(slots, sizeof(type_stats_t));
+    t->mask = slots - 1;
+    t->used = 0;
+    t->arena = aml_buffer_init(slots * 8);
+    t->floor = 0;
+}
+
+static void table_destroy(type_table_t *t) {
+    free(t->slots);
+    aml_buffer_destroy(t->arena);
+}
+
+static inline const char *table_key(const type_table_t *t, const type_stats_t *e) {
+    return aml_buffer_data(t->arena) + e->key;
+}
+
+static type_stats_t *table_find(const type_table_t *t, const char *w, size_t n, uint32_t hash) {
+    for (size_t k = hash & t->mask;; k = (k + 1) & t->mask) {
+        type_stats_t *e = t->slots + k;
+        if (e->len == 0) return NULL;
+        if (e->hash == hash && e->len == n && memcmp(table_key(t, e), w, n) == 0) return e;
+    }
+}
+
+static void table_grow(type_table_t *t) {
+    size_t slots = (t->mask + 1) * 2;
+    type_stats_t *old = t->slots;
+    size_t old_slots = t->mask + 1;
+    t->slots = calloc(slots, sizeof(type_stats_t));
+    t->mask = slots - 1;
+    for (size_t k = 0; k < old_slots; k++) {
+        if (old[k].len == 0) continue;
+        size_t j = old[k].hash & t->mask;
+        while (t->slots[j].len) j = (j + 1) & t->mask;
+        t->slots[j] = old[k];
+    }
+    free(old);
+}
+
+static type_stats_t *table_insert(type_table_t *t, const char *w, size_t n, uint32_t hash) {
+    type_stats_t *e = table_find(t, w, n, hash);
+    if (e) return e;
+    if (2 * (t->used + 1) > t->mask + 1) {
+        table_grow(t);
+    }
+    size_t k = hash & t->mask;
+    while (t->slots[k].len) k = (k + 1) & t->mask;
+    e = t->slots + k;
+    e->hash = hash;
+    e->key = (uint32_t)aml_buffer_length(t->arena);
+    e->len = (uint8_t)n;
+    aml_buffer_append(t->arena, w, n);
+    t->used++;
+    return e;
+}
+
+static inline uint64_t type_count(const type_stats_t *e) {
+    return e->with_period + e->without_period;
+}
+
+/* Lossy counting: drop the rarest types until the table is back under
+   three quarters of max_types. Rare types can never score as
+   abbreviations anyway (--min-count). */
+static void table_prune(type_table_t *t, size_t max_types) {
+    while (t->used > max_types - max_types / 4) {
+        t->floor++;
+        type_table_t fresh;
+        table_init(&fresh, t->mask + 1);
+        for (size_t k = 0; k <= t->mask; k++) {
+            type_stats_t *e = t->slots + k;
+            if (e->len == 0 || type_count(e) <= t->floor) continue;
+            type_stats_t *f = table_insert(&fresh, table_key(t, e), e->len, e->hash);
+            uint32_t key = f->key;
+            *f = *e;
+            f->key = key;
+        }
+        fresh.floor = t->floor;
+        table_destroy(t);
+        *t = fresh;
+    }
+}
+
+static void table_merge(type_table_t *into, const type_table_t *from) {
+    if (from->floor > into->floor) into->floor = from->floor;
+    for (size_t k = 0; k <= from->mask; k++) {
+        const type_stats_t *e = from->slots + k;
+        if (e->len == 0) continue;
+        type_stats_t *f = table_insert(into, table_key(from, e), e->len, e->hash);
+        f->with_period += e->with_period;
+        f->without_period += e->without_period;
+        f->lower_mid += e->lower_mid;
+        f->upper_mid += e->upper_mid;
+        f->upper_first += e->upper_first;
+        f->periods = e->periods;
+    }
+}
+
+// ----------------------------------------------------------------------------
+//                            BLOCK QUEUE
+// ----------------------------------------------------------------------------
+
+typedef struct block_s {
+    struct block_s *next;
+    size_t len;
+    char data[];
+} block_t;
+
+typedef struct {
+    pthread_mutex_t lock;
+    pthread_cond_t ready;
+    pthread_cond_t room;
+    block_t *head;
+    block_t *tail;
+    size_t depth;
+    size_t max_depth;
+    bool done;
+} queue_t;
+
+static void queue_push(queue_t *q, block_t *b) {
+    b->next = NULL;
+    pthread_mutex_lock(&q->lock);
+    while (q->depth >= q->max_depth) pthread_cond_wait(&q->room, &q->lock);
+    if (q->tail) q->tail->next = b;
+    else q->head = b;
+    q->tail = b;
+    q->depth++;
+    pthread_cond_signal(&q->ready);
+    pthread_mutex_unlock(&q->lock);
+}
+
+// NULL once the reader is done and the queue is drained
+static block_t *queue_pop(queue_t *q) {
+    pthread_mutex_lock(&q->lock);
+    while (!q->head && !q->done) pthread_cond_wait(&q->ready, &q->lock);
+    block_t *b = q->head;
+    if (b) {
+        q->head = b->next;
+        if (!q->head) q->tail = NULL;
+        q->depth--;
+        pthread_cond_signal(&q->room);
+    }
+    pthread_mutex_unlock(&q->lock);
+    return b;
+}
+
+static void queue_finish(queue_t *q) {
+    pthread_mutex_lock(&q->lock);
+    q->done = true;
+    pthread_cond_broadcast(&q->ready);
+    pthread_mutex_unlock(&q->lock);
+}
+
+static block_t *block_new(void) {
+    block_t *b = malloc(sizeof(block_t) + BLOCK_BYTES);
+    if (!b) {
+        perror("malloc");
+        exit(1);
+    }
+    return b;
+}
+
+/* Feed one file to the queue in blocks cut after the last whitespace, so
+   no word spans two blocks. */
+static bool stream_file(queue_t *q, const char *path) {
+    FILE *fp = fopen(path, "rb");
+    if (!fp) {
+        perror(path);
+        return false;
+    }
+    block_t *b = block_new();
+    size_t have = 0;
+    for (;;) {
+        have += fread(b->data + have, 1, BLOCK_BYTES - have, fp);
+        if (have < BLOCK_BYTES) {
+            break;
+        }
+        size_t cut = have;
+        while (cut > 0 && !is_space((uint8_t)b->data[cut - 1])) cut--;
+        if (cut == 0) cut = have;
+        block_t *rest = block_new();
+        memcpy(rest->data, b->data + cut, have - cut);
+        b->len = cut;
+        queue_push(q, b);
+        b = rest;
+        have -= cut;
+    }
+    bool ok = !ferror(fp);
+    if (!ok) perror(path);
+    fclose(fp);
+    if (have) {
+        b->len = have;
+        queue_push(q, b);
+    } else {
+        free(b);
+    }
+    return ok;
+}
+
+// ----------------------------------------------------------------------------
+//                              LEARNER
+// ----------------------------------------------------------------------------
+
+typedef enum { CTX_UNKNOWN = 0, CTX_MID, CTX_FIRST } context_t;
+
+// What followed a "word." token
+typedef struct {
+    uint64_t lower;  // lowercase or digit: the period was no boundary
+    uint64_t upper;  // capitalized word that is capitalized elsewhere too
+    uint64_t start;  // normally-lowercase word capitalized, or a blank line
+} follow_t;
+
+typedef struct {
+    type_table_t types;      // merged after pass 1, read-only in pass 2
+    uint64_t tokens;
+    uint64_t period_tokens;
+    type_stats_t **cands;    // abbreviation candidates, by score
+    double *scores;
+    size_t num_cands;
+    follow_t *cand_follow;
+    follow_t ordinal[ORDINAL_BUCKETS];
+    size_t max_types;
+} learner_t;
+
+typedef struct {
+    learner_t *l;
+    queue_t *q;
+    int pass;
+    type_table_t types;      // pass 1
+    uint64_t tokens;
+    uint64_t period_tokens;
+    follow_t *cand_follow;   // pass 2
+    follow_t ordinal[ORDINAL_BUCKETS];
+} worker_t;
+
+static inline context_t context_after(const token_t *t) {
+    if (t->flags & TOK_STRONG) return CTX_FIRST;
+    if ((t->flags & TOK_PERIOD) && !(t->flags & TOK_CLAUSE)) return CTX_UNKNOWN;
+    return CTX_MID;
+}
+
+static void count_token(worker_t *w, const token_t *t, context_t ctx) {
+    w->tokens++;
+    if (t->flags & TOK_PERIOD) w->period_tokens++;
+    if (t->len == 0 || (t->flags & (TOK_LONG | TOK_NUMBER | TOK_ELLIPSIS))) return;
+    type_stats_t *e = table_insert(&w->types, t->type, t->len, type_hash(t->type, t->len));
+    e->periods = (uint8_t)t->periods;
+    if (t->flags & TOK_PERIOD) e->with_period++;
+    else e->without_period++;
+    if (t->flags & TOK_PARAGRAPH) ctx = CTX_FIRST;
+    if (ctx == CTX_MID) {
+        if (t->flags & TOK_LOWER) e->lower_mid++;
+        else if (t->flags & TOK_UPPER) e->upper_mid++;
+    } else if (ctx == CTX_FIRST && (t->flags & TOK_UPPER)) {
+        e->upper_first++;
+    }
+}
+
+// Classify the word after a "word." token; returns false if it says nothing
+static bool classify_next(const learner_t *l, const token_t *next, follow_t *f) {
+    if (next->flags & TOK_PARAGRAPH) {
+        f->start++;
+    } else if (next->flags & (TOK_LOWER | TOK_DIGIT)) {
+        f->lower++;
+    } else if ((next->flags & TOK_UPPER) && !(next->flags & TOK_LONG)) {
+        const type_stats_t *e =
+            table_find(&l->types, next->type, next->len, type_hash(next->type, next->len));
+        if (e && e->lower_mid > e->upper_mid) f->start++;
+        else f->upper++;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+static void count_follow(worker_t *w, const token_t *prev, const token_t *next) {
+    // only a lone, ambiguous period tells anything
+    if ((prev->flags & (TOK_PERIOD | TOK_STRONG | TOK_CLAUSE | TOK_LONG)) != TOK_PERIOD ||
+        prev->len == 0)
+        return;
+    const learner_t *l = w->l;
+    if (prev->flags & TOK_NUMBER) {
+        if (prev->flags & TOK_LINE) return; // "1. item" list markers
+        classify_next(l, next, &w->ordinal[prev->len < 4 ? prev->len : 4]);
+        return;
+    }
+    const type_stats_t *e =
+        table_find(&l->types, prev->type, prev->len, type_hash(prev->type, prev->len));
+    if (e && e->cand) {
+        classify_next(l, next, &w->cand_follow[e->cand - 1]);
+    }
+}
+
+static void *worker_main(void *arg) {
+    worker_t *w = (worker_t *)arg;
+    block_t *b;
+    while ((b = queue_pop(w->q)) != NULL) {
+        token_t tok[2];
+        int cur = 0;
+        bool have_prev = false;
+        context_t ctx = CTX_UNKNOWN; // the previous block's last word is unknown
+        size_t pos = 0;
+        while (next_token(b->data, b->len, &pos, &tok[cur])) {
+            const token_t *t = &tok[cur];
+            if (w->pass == 1) {
+                count_token(w, t, ctx);
+                ctx = context_after(t);
+            } else if (have_prev) {
+                count_follow(w, &tok[cur ^ 1], t);
+            }
+            have_prev = true;
+            cur ^= 1;
+        }
+        free(b);
+        if (w->pass == 1 && w->types.used > w->l->max_types) {
+            table_prune(&w->types, w->l->max_types);
+        }
+    }
+    return NULL;
+}
+
+/* One streaming pass over every file on `threads` workers; the calling
+   thread reads. */
+static bool run_pass(learner_t *l, int pass, char **files, size_t num_files, size_t threads) {
+    queue_t q;
+    memset(&q, 0, sizeof(q));
+    pthread_mutex_init(&q.lock, NULL);
+    pthread_cond_init(&q.ready, NULL);
+    pthread_cond_init(&q.room, NULL);
+    q.max_depth = 2 * threads;
+
+    worker_t *workers = calloc(threads, sizeof(worker_t));
+    pthread_t *tids = calloc(threads, sizeof(pthread_t));
+    for (size_t k = 0; k < threads; k++) {
+        workers[k].l = l;
+        workers[k].q = &q;
+        workers[k].pass = pass;
+        if (pass == 1) table_init(&workers[k].types, 1u << 16);
+        else workers[k].cand_follow = calloc(l->num_cands + 1, sizeof(follow_t));
+        pthread_create(&tids[k], NULL, worker_main, &workers[k]);
+    }
+    bool ok = true;
+    for (size_t f = 0; f < num_files; f++) {
+        ok = stream_file(&q, files[f]) && ok;
+    }
+    queue_finish(&q);
+
+    for (size_t k = 0; k < threads; k++) {
+        pthread_join(tids[k], NULL);
+        worker_t *w = &workers[k];
+        if (pass == 1) {
+            l->tokens += w->tokens;
+            l->period_tokens += w->period_tokens;
+            table_merge(&l->types, &w->types);
+            table_destroy(&w->types);
+        } else {
+            for (size_t c = 0; c < l->num_cands; c++) {
+                l->cand_follow[c].lower += w->cand_follow[c].lower;
+                l->cand_follow[c].upper += w->cand_follow[c].upper;
+                l->cand_follow[c].start += w->cand_follow[c].start;
+            }
+            for (size_t d = 0; d < ORDINAL_BUCKETS; d++) {
+                l->ordinal[d].lower += w->ordinal[d].lower;
+                l->ordinal[d].upper += w->ordinal[d].upper;
+                l->ordinal[d].start += w->ordinal[d].start;
+            }
+            free(w->cand_follow);
+        }
+    }
+    free(workers);
+    free(tids);
+    pthread_cond_destroy(&q.ready);
+    pthread_cond_destroy(&q.room);
+    pthread_mutex_destroy(&q.lock);
+    return ok;
+}
+
+/* Punkt's scaled log-likelihood that "type." is an abbreviation: Dunning's
+   ratio of "this type nearly always takes a period" (p = 0.99) against the
+   corpus-wide period rate, damped exponentially by length, boosted by
+   internal periods and penalized for each occurrence without a period. */
+static double abbrev_score(const type_stats_t *e, uint64_t tokens, uint64_t period_tokens) {
+    if (period_tokens == 0 || period_tokens >= tokens) return 0.0;
+    double k = (double)e->with_period;
+    double n = (double)type_count(e);
+    double p1 = (double)period_tokens / (double)tokens;
+    double p2 = 0.99;
+    double null_hypo = k * log(p1) + (n - k) * log(1.0 - p1);
+    double alt_hypo = k * log(p2) + (n - k) * log(1.0 - p2);
+    double ll = -2.0 * (null_hypo - alt_hypo);
+    double nonperiods = (double)(e->len - e->periods);
+    if (nonperiods < 1.0) return 0.0;
+    double f_length = exp(-nonperiods);
+    double f_periods = (double)e->periods + 1.0;
+    double f_penalty = pow(nonperiods, -(double)e->without_period);
+    return ll * f_length * f_periods * f_penalty;
+}
+
+typedef struct {
+    type_stats_t *e;
+    double score;
+} scored_t;
+
+static const type_table_t *sort_types;
+
+// Highest score first; ties by word, so the output is the same for any --threads
+static int by_score(const void *a, const void *b) {
+    const scored_t *x = (const scored_t *)a, *y = (const scored_t *)b;
+    if (x->score != y->score) return x->score < y->score ? 1 : -1;
+    size_t n = x->e->len < y->e->len ? x->e->len : y->e->len;
+    int c = memcmp(table_key(sort_types, x->e), table_key(sort_types, y->e), n);
+    return c ? c : (int)x->e->len - (int)y->e->len;
+}
+
+// Types the pack can hold and the chunker can look up
+static bool storable(const type_table_t *t, const type_stats_t *e) {
+    const char *w = table_key(t, e);
+    for (size_t k = 0; k < e->len; k++) {
+        if (w[k] == '#') return false;
+    }
+    return w[e->len - 1] != '*';
+}
+
+static void select_candidates(learner_t *l, size_t min_count, double threshold,
+                              const type_table_t *base)
+{
+    scored_t *cands = malloc(sizeof(scored_t) * (l->types.used + 1));
+    size_t n = 0;
+    for (size_t k = 0; k <= l->types.mask; k++) {
+        type_stats_t *e = l->types.slots + k;
+        if (e->len == 0 || e->with_period < min_count || !storable(&l->types, e)) continue;
+        const char *w = table_key(&l->types, e);
+        bool alpha = false;
+        for (size_t j = 0; j < e->len && !alpha; j++) {
+            uint8_t c = (uint8_t)w[j];
+            alpha = (c >= 'a' && c <= 'z') || c >= 0x80;
+        }
+        if (!alpha || table_find(base, w, e->len, e->hash)) continue;
+        double score = abbrev_score(e, l->tokens, l->period_tokens);
+        if (score < threshold) continue;
+        cands[n].e = e;
+        cands[n].score = score;
+        n++;
+    }
+    sort_types = &l->types;
+    qsort(cands, n, sizeof(scored_t), by_score);
+
+    l->cands = malloc(sizeof(type_stats_t *) * (n + 1));
+    l->scores = malloc(sizeof(double) * (n + 1));
+    for (size_t k = 0; k < n; k++) {
+        l->cands[k] = cands[k].e;
+        l->scores[k] = cands[k].score;
+        l->cands[k]->cand = (uint32_t)(k + 1);
+    }
+    l->num_cands = n;
+    l->cand_follow = calloc(n + 1, sizeof(follow_t));
+    free(cands);
+}
+
+// ----------------------------------------------------------------------------
+//                               OUTPUT
+// ----------------------------------------------------------------------------
+
+/* Abbreviations already listed by the base source (either directive). */
+static void base_words(type_table_t *base, const char *src, size_t len) {
+    size_t pos = 0;
+    while (pos < len) {
+        const char *nl = memchr(src + pos, '\n', len - pos);
+        size_t end = nl ? (size_t)(nl - src) : len;
+        size_t i = pos;
+        bool first = true, abbrev = false;
+        while (i < end) {
+            while (i < end && (src[i] == ' ' || src[i] == '\t' || src[i] == '\r')) i++;
+            if (i >= end || src[i] == '#') break;
+            size_t s = i;
+            while (i < end && src[i] != ' ' && src[i] != '\t' && src[i] != '\r') i++;
+            size_t n = i - s;
+            if (first) {
+                abbrev = (n == 6 && !memcmp(src + s, "abbrev", 6)) ||
+                         (n == 12 && !memcmp(src + s, "abbrev_exact", 12));
+                first = false;
+                if (!abbrev) break;
+                continue;
+            }
+            if (n > 1 && src[s + n - 1] == '*') n--;
+            if (n == 0 || n > MAX_WORD) continue;
+            char w[MAX_WORD + 1];
+            for (size_t k = 0; k < n; k++) {
+                uint8_t c = (uint8_t)src[s + k];
+                w[k] = (char)((c >= 'A' && c <= 'Z') ? c + 32 : c);
+            }
+            table_insert(base, w, n, type_hash(w, n));
+        }
+        pos = end + 1;
+    }
+}
+
+static void write_source(aml_buffer_t *out, const learner_t *l, const char *base,
+                         size_t base_len, const char *name, size_t min_count)
+{
+    aml_buffer_appendf(out, "# Learned by a_sentence_chunker_learn from %llu words (%zu types)\n",
+                       (unsigned long long)l->tokens, l->types.used);
+    if (base_len) {
+        aml_buffer_append(out, base, base_len);
+        if (base[base_len - 1] != '\n') aml_buffer_appendc(out, '\n');
+    }
+    if (name || !base_len) {
+        aml_buffer_appendf(out, "name %s\n", name ? name : "learned");
+    }
+
+    /* Ordinals: "<digits>." followed by a capitalized word that is
+       capitalized mid-sentence too ("am 3. Oktober") rather than a sentence
+       starter marks a language that writes ordinals with a period. Years
+       (4+ digits) never count. */
+    follow_t all = { 0, 0, 0 };
+    for (size_t d = 1; d < 4; d++) {
+        all.lower += l->ordinal[d].lower;
+        all.upper += l->ordinal[d].upper;
+        all.start += l->ordinal[d].start;
+    }
+    if (all.lower + all.upper + all.start >= min_count) {
+        bool upper = all.upper >= min_count && all.upper >= all.start;
+        size_t max_digits = 0;
+        for (size_t d = 1; upper && d < 4; d++) {
+            if (l->ordinal[d].upper > l->ordinal[d].start) max_digits = d;
+        }
+        if (upper && max_digits == 0) max_digits = 3;
+        aml_buffer_appendf(out,
+                           "\n# after \"<1-3 digits>.\": %llu lowercase, %llu capitalized, "
+                           "%llu sentence starts\n",
+                           (unsigned long long)all.lower, (unsigned long long)all.upper,
+                           (unsigned long long)all.start);
+        aml_buffer_appendf(out, "ordinal_next digit lower%s\n", upper ? " upper" : "");
+        aml_buffer_appendf(out, "ordinal_max_digits %zu\n", max_digits);
+    }
+
+    aml_buffer_appendf(out, "\n# score, with/without period, next word lower/upper/start\n");
+    for (size_t k = 0; k < l->num_cands; k++) {
+        const type_stats_t *e = l->cands[k];
+        const follow_t *f = &l->cand_follow[k];
+        uint64_t seen = f->lower + f->upper + f->start;
+        bool may_end = f->start >= 2 && (double)f->start >= MAY_END_RATIO * (double)seen;
+        int pad = (int)(MAX_WORD + 1 - e->len);
+        aml_buffer_appendf(out, "abbrev %.*s%s%*s # %.2f %llu/%llu %llu/%llu/%llu\n",
+                           (int)e->len, table_key(&l->types, e), may_end ? "*" : " ",
+                           pad, "", l->scores[k],
+                           (unsigned long long)e->with_period,
+                           (unsigned long long)e->without_period,
+                           (unsigned long long)f->lower, (unsigned long long)f->upper,
+                           (unsigned long long)f->start);
+    }
+}
+
+static bool write_file(const char *path, const void *data, size_t len) {
+    FILE *out = fopen(path, "wb");
+    if (!out) {
+        perror(path);
+        return false;
+    }
+    bool ok = fwrite(data, 1, len, out) == len;
+    if (fclose(out) != 0) ok = false;
+    if (!ok) perror(path);
+    return ok;
+}
+
+static void collect_path(const char *path, char ***files, size_t *num, size_t *cap) {
+    struct stat st;
+    if (stat(path, &st) != 0) {
+        perror(path);
+        return;
+    }
+    if (!S_ISDIR(st.st_mode)) {
+        if (*num == *cap) {
+            *cap = *cap ? 2 * *cap : 64;
+            *files = realloc(*files, *cap * sizeof(char *));
+        }
+        (*files)[(*num)++] = strdup(path);
+        return;
+    }
+    DIR *dir = opendir(path);
+    if (!dir) {
+        perror(path);
+        return;
+    }
+    struct dirent *entry;
+    char child[MAX_PATH_LEN];
+    while ((entry = readdir(dir)) != NULL) {
+        if (entry->d_name[0] == '.') continue;
+        snprintf(child, sizeof(child), "%s/%s", path, entry->d_name);
+        collect_path(child, files, num, cap);
+    }
+    closedir(dir);
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr,
+            "Usage: %s [--threads N] [--base SOURCE.txt] [--name NAME] [--min-count N]\n"
+            "          [--threshold X] [--max-types N] [--source OUT.txt] -o OUT.pack\n"
+            "          <file|dir>...\n",
+            prog);
+}
+
+int main(int argc, char *argv[]) {
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    size_t threads = cpus > 0 ? (size_t)cpus : 1;
+    size_t min_count = DEFAULT_MIN_COUNT;
+    double threshold = DEFAULT_THRESHOLD;
+    const char *base_path = NULL, *name = NULL, *source_path = NULL, *pack_path = NULL;
+    char **files = NULL;
+    size_t num_files = 0, cap = 0;
+    learner_t l;
+    memset(&l, 0, sizeof(l));
+    l.max_types = DEFAULT_MAX_TYPES;
+
+    for (int a = 1; a < argc; a++) {
+        const char *arg = argv[a];
+        bool has_value = a + 1 < argc;
+        if (!strcmp(arg, "--threads") && has_value) {
+            threads = strtoull(argv[++a], NULL, 10);
+        } else if (!strcmp(arg, "--base") && has_value) {
+            base_path = argv[++a];
+        } else if (!strcmp(arg, "--name") && has_value) {
+            name = argv[++a];
+        } else if (!strcmp(arg, "--min-count") && has_value) {
+            min_count = strtoull(argv[++a], NULL, 10);
+        } else if (!strcmp(arg, "--threshold") && has_value) {
+            threshold = strtod(argv[++a], NULL);
+        } else if (!strcmp(arg, "--max-types") && has_value) {
+            l.max_types = strtoull(argv[++a], NULL, 10);
+        } else if (!strcmp(arg, "--source") && has_value) {
+            source_path = argv[++a];
+        } else if (!strcmp(arg, "-o") && has_value) {
+            pack_path = argv[++a];
+        } else if (arg[0] == '-' && arg[1]) {
+            usage(argv[0]);
+            return 1;
+        } else {
+            collect_path(arg, &files, &num_files, &cap);
+        }
+    }
+    if (!pack_path || num_files == 0) {
+        usage(argv[0]);
+        return 1;
+    }
+    if (threads == 0) threads = 1;
+    if (min_count == 0) min_count = 1;
+    if (l.max_types < 1024) l.max_types = 1024;
+
+    size_t base_len = 0;
+    char *base = NULL;
+    if (base_path && !(base = read_file(base_path, &base_len))) {
+        return 1;
+    }
+    type_table_t base_types;
+    table_init(&base_types, 256);
+    base_words(&base_types, base, base_len);
+
+    int rc = 1;
+    table_init(&l.types, 1u << 16);
+    if (!run_pass(&l, 1, files, num_files, threads)) goto done;
+    select_candidates(&l, min_count, threshold, &base_types);
+    if (!run_pass(&l, 2, files, num_files, threads)) goto done;
+    fprintf(stderr, "%llu words, %zu types%s, %zu abbreviations learned\n",
+            (unsigned long long)l.tokens, l.types.used,
+            l.types.floor ? " (rare types pruned)" : "", l.num_cands);
+
+    aml_buffer_t *source = aml_buffer_init(4096);
+    aml_buffer_t *pack = aml_buffer_init(4096);
+    write_source(source, &l, base, base_len, name, min_count);
+    size_t error_line = 0;
+    if (!a_sentence_chunker_lang_compile(pack, aml_buffer_data(source), aml_buffer_length(source),
+                                         &error_line)) {
+        // Only the --base part can be malformed; line 1 is the header comment
+        fprintf(stderr, "%s:%zu: invalid directive\n", base_path ? base_path : "<learned>",
+                error_line > 1 ? error_line - 1 : error_line);
+    } else if ((!source_path ||
+                write_file(source_path, aml_buffer_data(source), aml_buffer_length(source))) &&
+               write_file(pack_path, aml_buffer_data(pack), aml_buffer_length(pack))) {
+        rc = 0;
+    }
+    aml_buffer_destroy(source);
+    aml_buffer_destroy(pack);
+
+done:
+    table_destroy(&l.types);
+    table_destroy(&base_types);
+    free(l.cands);
+    free(l.scores);
+    free(l.cand_follow);
+    for (size_t f = 0; f < num_files; f++) free(files[f]);
+    free(files);
+    free(base);
+    return rc;
+}
@@ -0,0 +1,114 @@
+// SPDX-FileCopyrightText: 2025 Andy Curtis <contactandyc@gmail.com>
+// SPDX-FileCopyrightText: 2024–2025 Knode.ai — technical questions: contact Andy (above)
+// SPDX-License-Identifier: Apache-2.0
+
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include "a-sentence-chunker-library/a_sentence_chunker.h"
+#include "corpus_gen.h"
+
+/*
+   PGO training workload: runs both passes over the bundled corpora and a
+   set of generated ones, so the profile sees the same branch mix as real
+   traffic (abbreviations, decimals, ordinal lists, long runs without
+   sentence ends, CRLF, ...).
+
+     a_sentence_chunker_pgo_train [--generated BYTES] <file|dir>...
+*/
+
+#define MAX_PATH_LEN 1024
+#define CORPUS_TARGET_BYTES (4u * 1024u * 1024u)
+
+static const char *PROFILES[] = {
+    "prose", "abbrev", "numeric", "lists", "nospace", "crlf", "dotted", "longtail", "mixed"
+};
+#define NUM_PROFILES (sizeof(PROFILES) / sizeof(PROFILES[0]))
+
+static const size_t LIMITS[][2] = { { 5, 250 }, { 40, 120 }, { 200, 1000 } };
+#define NUM_LIMITS (sizeof(LIMITS) / sizeof(LIMITS[0]))
+
+static aml_buffer_t *bh1;
+static aml_buffer_t *bh2;
+
+static void train(const char *text, size_t len, size_t repeat) {
+    for (size_t r = 0; r < repeat; r++) {
+        size_t n1 = 0, n2 = 0;
+        a_sentence_chunk_t *first = a_sentence_chunker_len(&n1, bh1, text, len);
+        a_rechunk_sentences(&n2, bh2, text, first, n1,
+                            LIMITS[r % NUM_LIMITS][0], LIMITS[r % NUM_LIMITS][1]);
+    }
+}
+
+static void train_file(const char *name) {
+    FILE *fp = fopen(name, "rb");
+    if (!fp) {
+        perror("fopen");
+        return;
+    }
+    fseek(fp, 0, SEEK_END);
+    long fsize = ftell(fp);
+    rewind(fp);
+    char *text = malloc(fsize + 1);
+    if (fsize > 0 && fread(text, 1, fsize, fp) == (size_t)fsize) {
+        size_t repeat = CORPUS_TARGET_BYTES / (size_t)fsize;
+        train(text, (size_t)fsize, repeat ? repeat : 1);
+        printf("trained on %s (%ld bytes)\n", name, fsize);
+    }
+    fclose(fp);
+    free(text);
+}
+
+static void train_path(const char *path) {
+    struct stat st;
+    if (stat(path, &st) != 0) {
+        perror("stat");
+        return;
+    }
+    if (!S_ISDIR(st.st_mode)) {
+        train_file(path);
+        return;
+    }
+    DIR *dir = opendir(path);
+    if (!dir) {
+        perror("opendir");
+        return;
+    }
+    struct dirent *entry;
+    char child[MAX_PATH_LEN];
+    while ((entry = readdir(dir)) != NULL) {
+        if (entry->d_name[0] == '.') continue;
+        snprintf(child, sizeof(child), "%s/%s", path, entry->d_name);
+        train_path(child);
+    }
+    closedir(dir);
+}
+
+int main(int argc, char *argv[]) {
+    size_t generated = CORPUS_TARGET_BYTES;
+    bh1 = aml_buffer_init(1024);
+    bh2 = aml_buffer_init(1024);
+
+    for (int a = 1; a < argc; a++) {
+        if (!strcmp(argv[a], "--generated") && a + 1 < argc) {
+            generated = strtoull(argv[++a], NULL, 10);
+        } else {
+            train_path(argv[a]);
+        }
+    }
+
+    for (size_t p = 0; generated && p < NUM_PROFILES; p++) {
+        corpus_profile_t profile;
+        corpus_profile_preset(&profile, PROFILES[p], 62 + p);
+        char *text = corpus_generate(&profile, generated);
+        train(text, generated, NUM_LIMITS);
+        printf("trained on generated %s (%zu bytes)\n", PROFILES[p], generated);
+        free(text);
+    }
+
+    aml_buffer_destroy(bh1);
+    aml_buffer_destroy(bh2);
+    return 0;
+}
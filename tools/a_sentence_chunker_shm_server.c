@@ -0,0 +1,55 @@
+// SPDX-FileCopyrightText: 2025 Andy Curtis <contactandyc@gmail.com>
+// SPDX-FileCopyrightText: 2024–2025 Knode.ai — technical questions: contact Andy (above)
+// SPDX-License-Identifier: Apache-2.0
+
+#include <errno.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/socket.h>
+
+#include "a-sentence-chunker-library/a_sentence_chunker_shm.h"
+
+// One thread per client connection; each keeps its own mapping and buffers.
+static void *connection_thread(void *arg) {
+    int conn = (int)(intptr_t)arg;
+    a_sentence_chunker_shm_serve(conn);
+    close(conn);
+    return NULL;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s <socket path>\n", argv[0]);
+        return 1;
+    }
+    signal(SIGPIPE, SIG_IGN);
+
+    int listener = a_sentence_chunker_shm_listen(argv[1]);
+    if (listener < 0) {
+        perror("a_sentence_chunker_shm_listen");
+        return 1;
+    }
+    printf("Listening on %s\n", argv[1]);
+
+    while (1) {
+        int conn = accept(listener, NULL, NULL);
+        if (conn < 0) {
+            if (errno == EINTR) continue;
+            perror("accept");
+            break;
+        }
+        pthread_t tid;
+        if (pthread_create(&tid, NULL, connection_thread, (void *)(intptr_t)conn) != 0) {
+            close(conn);
+            continue;
+        }
+        pthread_detach(tid);
+    }
+    close(listener);
+    unlink(argv[1]);
+    return 0;
+}